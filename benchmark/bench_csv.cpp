@@ -0,0 +1,114 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#include "benchmark.h"
+
+#include <scn/csv.h>
+
+SCN_CLANG_PUSH
+SCN_CLANG_IGNORE("-Wglobal-constructors")
+SCN_CLANG_IGNORE("-Wexit-time-destructors")
+
+// Records of a name, a quoted comment, an integer and a float
+static std::string generate_csv_data(size_t n)
+{
+    std::default_random_engine rng(std::random_device{}());
+    std::uniform_int_distribution<int> len(4, 24);
+    std::uniform_int_distribution<int> ch('a', 'z' + 4);
+    std::uniform_int_distribution<int> num(0, 1000000);
+
+    auto word = [&]() {
+        std::string w{"x"};
+        for (int j = len(rng); j > 0; --j) {
+            const auto c = ch(rng);
+            w.push_back(c > 'z' ? ' ' : static_cast<char>(c));
+        }
+        return w;
+    };
+
+    std::string data;
+    for (size_t i = 0; i < n; ++i) {
+        data += word();
+        data += ",\"";
+        data += word();
+        data += ", ";
+        data += word();
+        data += "\",";
+        data += std::to_string(num(rng));
+        data += ',';
+        data += std::to_string(num(rng));
+        data += ".25\n";
+    }
+    return data;
+}
+
+static void csv_scn(benchmark::State& state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    auto data = generate_csv_data(n);
+    scn::string_view name{}, comment{};
+    int i{};
+    double d{};
+
+    for (auto _ : state) {
+        auto records = scn::csv(scn::string_view{data.data(), data.size()});
+        for (const auto& rec : records) {
+            if (!rec.scan(name, comment, i, d)) {
+                state.SkipWithError("Benchmark errored");
+                break;
+            }
+        }
+        if (!records.error()) {
+            state.SkipWithError("Benchmark errored");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(data.size()));
+}
+BENCHMARK(csv_scn)->Arg(2 << 10);
+
+static void csv_getline_scan(benchmark::State& state)
+{
+    const auto n = static_cast<size_t>(state.range(0));
+    auto data = generate_csv_data(n);
+    const auto delims = scn::with_delimiters(",");
+    scn::string_view line{}, name{}, comment{};
+    int i{};
+    double d{};
+
+    for (auto _ : state) {
+        auto range = scn::make_view(data);
+        while (true) {
+            auto ret = scn::getline(range, line);
+            if (!ret) {
+                break;
+            }
+            range = std::move(ret.range());
+            if (!scn::scan(line, delims, "{:q},{:q},{},{}", name, comment, i,
+                           d)) {
+                state.SkipWithError("Benchmark errored");
+                break;
+            }
+        }
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(data.size()));
+}
+BENCHMARK(csv_getline_scan)->Arg(2 << 10);
+
+SCN_CLANG_POP
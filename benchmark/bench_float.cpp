@@ -30,6 +30,7 @@ static void scanfloat_scn(benchmark::State& state)
     auto data = generate_float_data<Float>(FLOAT_DATA_N);
     auto range = scn::make_view(data);
     Float f{};
+    allocation_scope allocs{state};
     for (auto _ : state) {
         auto e = scn::scan(range, "{}", f);
 
@@ -56,6 +57,7 @@ static void scanfloat_scn_default(benchmark::State& state)
     auto data = generate_float_data<Float>(FLOAT_DATA_N);
     auto range = scn::make_view(data);
     Float f{};
+    allocation_scope allocs{state};
     for (auto _ : state) {
         auto e = scn::scan(range, scn::default_tag, f);
 
@@ -31,6 +31,7 @@ static void scanint_scn(benchmark::State& state)
     auto data = generate_int_data<Int>(INT_DATA_N);
     Int i{};
     auto range = scn::make_view(data);
+    allocation_scope allocs{state};
     for (auto _ : state) {
         auto ret = scn::scan(range, "{}", i);
 
@@ -57,6 +58,7 @@ static void scanint_scn_default(benchmark::State& state)
     auto data = generate_int_data<Int>(INT_DATA_N);
     Int i{};
     auto range = scn::make_view(data);
+    allocation_scope allocs{state};
     for (auto _ : state) {
         auto ret = scn::scan(range, scn::default_tag, i);
 
@@ -77,6 +79,58 @@ BENCHMARK_TEMPLATE(scanint_scn_default, int);
 BENCHMARK_TEMPLATE(scanint_scn_default, long long);
 BENCHMARK_TEMPLATE(scanint_scn_default, unsigned);
 
+template <typename Int>
+static void scanint_scn_static(benchmark::State& state)
+{
+    auto data = generate_int_data<Int>(INT_DATA_N);
+    Int i{};
+    auto range = scn::make_view(data);
+    for (auto _ : state) {
+        auto ret = scn::scan_static(range, "{}", i);
+
+        if (!ret) {
+            if (ret.error() == scn::error::end_of_range) {
+                range = scn::make_view(data);
+            }
+            else {
+                state.SkipWithError("Benchmark errored");
+                break;
+            }
+        }
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * sizeof(Int)));
+}
+BENCHMARK_TEMPLATE(scanint_scn_static, int);
+BENCHMARK_TEMPLATE(scanint_scn_static, long long);
+BENCHMARK_TEMPLATE(scanint_scn_static, unsigned);
+
+template <typename Int>
+static void scanint_scn_static_default(benchmark::State& state)
+{
+    auto data = generate_int_data<Int>(INT_DATA_N);
+    Int i{};
+    auto range = scn::make_view(data);
+    for (auto _ : state) {
+        auto ret = scn::scan_static(range, scn::default_tag, i);
+
+        if (!ret) {
+            if (ret.error() == scn::error::end_of_range) {
+                range = scn::make_view(data);
+            }
+            else {
+                state.SkipWithError("Benchmark errored");
+                break;
+            }
+        }
+    }
+    state.SetBytesProcessed(
+        static_cast<int64_t>(state.iterations() * sizeof(Int)));
+}
+BENCHMARK_TEMPLATE(scanint_scn_static_default, int);
+BENCHMARK_TEMPLATE(scanint_scn_static_default, long long);
+BENCHMARK_TEMPLATE(scanint_scn_static_default, unsigned);
+
 template <typename Int>
 static void scanint_scn_value(benchmark::State& state)
 {
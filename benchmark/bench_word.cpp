@@ -17,6 +17,8 @@
 
 #include "benchmark.h"
 
+#include <scn/intern.h>
+
 SCN_CLANG_PUSH
 SCN_CLANG_IGNORE("-Wglobal-constructors")
 SCN_CLANG_IGNORE("-Wunused-template")
@@ -47,6 +49,7 @@ static void scanword_scn(benchmark::State& state)
     auto range = scn::make_view(data);
     string_type str{};
 
+    allocation_scope allocs{state};
     for (auto _ : state) {
         auto e = scn::scan(range, default_format_str<Char>(), str);
 
@@ -72,6 +75,7 @@ static void scanword_scn_default(benchmark::State& state)
     auto range = scn::make_view(data);
     string_type str{};
 
+    allocation_scope allocs{state};
     for (auto _ : state) {
         auto e = scn::scan(range, scn::default_tag, str);
 
@@ -114,6 +118,114 @@ static void scanword_scn_string_view(benchmark::State& state)
 BENCHMARK_TEMPLATE(scanword_scn_string_view, char)->Arg(2 << 15);
 BENCHMARK_TEMPLATE(scanword_scn_string_view, wchar_t)->Arg(2 << 15);
 
+// Comma-separated fields, which may contain spaces
+static std::string generate_field_data(size_t n)
+{
+    std::default_random_engine rng(std::random_device{}());
+    std::uniform_int_distribution<int> len(4, 40);
+    std::uniform_int_distribution<int> ch('a', 'z' + 4);
+
+    std::string data;
+    for (size_t i = 0; i < n; ++i) {
+        // starts with a letter, so that it's not all whitespace
+        data.push_back('x');
+        for (int j = len(rng); j > 0; --j) {
+            const auto c = ch(rng);
+            data.push_back(c > 'z' ? ' ' : static_cast<char>(c));
+        }
+        data.push_back(',');
+    }
+    return data;
+}
+
+static void scanfield_scn_scanset(benchmark::State& state)
+{
+    auto data = generate_field_data(static_cast<size_t>(state.range(0)));
+    auto range = scn::make_view(data);
+    scn::string_view field{};
+
+    for (auto _ : state) {
+        auto e = scn::scan(range, "{:[^,]},", field);
+
+        if (!e) {
+            if (e.error() == scn::error::end_of_range) {
+                range = scn::make_view(data);
+            }
+            else {
+                state.SkipWithError("Benchmark errored");
+                break;
+            }
+        }
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(data.size()) /
+                            static_cast<int64_t>(state.range(0)));
+}
+BENCHMARK(scanfield_scn_scanset)->Arg(2 << 12);
+
+// Words from a small set, like the values of a categorical field
+static std::string generate_categorical_data(size_t n)
+{
+    static const char* words[] = {"GET",  "POST",    "PUT",   "DELETE",
+                                  "HEAD", "OPTIONS", "PATCH", "TRACE"};
+    std::default_random_engine rng(std::random_device{}());
+    std::uniform_int_distribution<size_t> dist(0, 7);
+
+    std::string data;
+    for (size_t i = 0; i < n; ++i) {
+        data.append(words[dist(rng)]);
+        data.push_back(' ');
+    }
+    return data;
+}
+
+static void scanword_scn_categorical(benchmark::State& state)
+{
+    auto data = generate_categorical_data(static_cast<size_t>(state.range(0)));
+    auto range = scn::make_view(data);
+    std::string str{};
+
+    allocation_scope allocs{state};
+    for (auto _ : state) {
+        auto e = scn::scan(range, "{}", str);
+
+        if (!e) {
+            if (e.error() == scn::error::end_of_range) {
+                range = scn::make_view(data);
+            }
+            else {
+                state.SkipWithError("Benchmark errored");
+                break;
+            }
+        }
+    }
+}
+BENCHMARK(scanword_scn_categorical)->Arg(2 << 12);
+
+static void scanword_scn_interned(benchmark::State& state)
+{
+    auto data = generate_categorical_data(static_cast<size_t>(state.range(0)));
+    auto range = scn::make_view(data);
+    scn::intern_pool pool{};
+    scn::interned<scn::intern_pool> str{pool};
+
+    allocation_scope allocs{state};
+    for (auto _ : state) {
+        auto e = scn::scan(range, "{}", str);
+
+        if (!e) {
+            if (e.error() == scn::error::end_of_range) {
+                range = scn::make_view(data);
+            }
+            else {
+                state.SkipWithError("Benchmark errored");
+                break;
+            }
+        }
+    }
+}
+BENCHMARK(scanword_scn_interned)->Arg(2 << 12);
+
 template <typename Char>
 static void scanword_sstream(benchmark::State& state)
 {
@@ -59,6 +59,41 @@ inline std::string generate_buffer(size_t len)
     return data;
 }
 
+#if defined(SCN_BENCHMARK_ALLOCATIONS) && SCN_BENCHMARK_ALLOCATIONS
+// Number of calls to operator new so far, see alloc_counter.cpp
+std::size_t allocation_count() noexcept;
+#else
+inline std::size_t allocation_count() noexcept
+{
+    return 0;
+}
+#endif
+
+// Reports the allocations made during the benchmark loop
+// as the counter "allocs" (per iteration), when they are counted
+class allocation_scope {
+public:
+    explicit allocation_scope(benchmark::State& state)
+        : m_state(state), m_begin(allocation_count())
+    {
+    }
+    allocation_scope(const allocation_scope&) = delete;
+    allocation_scope& operator=(const allocation_scope&) = delete;
+
+    ~allocation_scope()
+    {
+#if defined(SCN_BENCHMARK_ALLOCATIONS) && SCN_BENCHMARK_ALLOCATIONS
+        m_state.counters["allocs"] = benchmark::Counter(
+            static_cast<double>(allocation_count() - m_begin),
+            benchmark::Counter::kAvgIterations);
+#endif
+    }
+
+private:
+    benchmark::State& m_state;
+    std::size_t m_begin;
+};
+
 template <typename Char>
 inline std::basic_string<Char> generate_data(size_t)
 {
@@ -18,7 +18,22 @@
 #ifndef SCN_ALL_H
 #define SCN_ALL_H
 
+#include "arena.h"
+#include "bigint.h"
+#include "binary.h"
+#include "chrono.h"
+#include "columns.h"
+#include "csv.h"
+#include "decimal.h"
+#include "enum.h"
+#include "fixed.h"
+#include "follow.h"
+#include "intern.h"
 #include "istream.h"
+#include "kv.h"
+#include "line_index.h"
+#include "lines.h"
+#include "net.h"
 #include "scn.h"
 #include "tuple_return.h"
 
@@ -0,0 +1,271 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_ARENA_H
+#define SCN_DETAIL_ARENA_H
+
+#include "scan.h"
+
+#include <cstdint>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup arena Arena-allocated strings
+     *
+     * Scanning a lot of short strings from a non-contiguous source, where a
+     * \ref string_view can't be used, allocates every one of them separately
+     * with `std::string`. A \ref basic_arena_string_view "arena_string_view"
+     * copies the scanned string into a \ref monotonic_arena instead, which
+     * hands out memory from large chunks, and frees all of it at once.
+     *
+     * Strings with other allocators, like `std::pmr::string`, can be scanned
+     * into directly, too: the scanned string is allocated with the allocator
+     * of the destination.
+     */
+
+    /// @{
+
+    /**
+     * Allocates memory by bumping a pointer inside a chunk of memory.
+     * Individual allocations are never freed: all memory is released
+     * with \ref release(), or when the arena is destroyed.
+     *
+     * The first chunk can be supplied by the caller, e.g. a buffer on the
+     * stack. Further chunks are allocated with `operator new`, each one
+     * twice as large as the previous one.
+     */
+    class monotonic_arena {
+    public:
+        static constexpr std::size_t default_chunk_size = 4096;
+
+        monotonic_arena() = default;
+        /// Allocates chunks of at least `chunk_size` bytes
+        explicit monotonic_arena(std::size_t chunk_size)
+            : m_chunk_size(chunk_size != 0 ? chunk_size : default_chunk_size)
+        {
+        }
+        /**
+         * Hands out `buffer` first, and allocates chunks of at least
+         * `buffer_size` bytes after that. `buffer` isn't freed by the arena.
+         */
+        monotonic_arena(void* buffer, std::size_t buffer_size)
+            : m_cur(static_cast<unsigned char*>(buffer)),
+              m_end(static_cast<unsigned char*>(buffer) + buffer_size),
+              m_initial(static_cast<unsigned char*>(buffer)),
+              m_initial_size(buffer_size),
+              m_chunk_size(buffer_size != 0 ? buffer_size
+                                            : default_chunk_size)
+        {
+        }
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+        monotonic_arena(monotonic_arena&&) = delete;
+        monotonic_arena& operator=(monotonic_arena&&) = delete;
+
+        ~monotonic_arena()
+        {
+            release();
+        }
+
+        /// `n` bytes, aligned to `align` (a power of two)
+        void* allocate(std::size_t n, std::size_t align = alignof(void*))
+        {
+            if (m_cur) {
+                // compared as sizes: the padding may not fit either
+                const auto pad = _padding(m_cur, align);
+                const auto avail = static_cast<std::size_t>(m_end - m_cur);
+                if (pad <= avail && n <= avail - pad) {
+                    const auto p = m_cur + pad;
+                    m_cur = p + n;
+                    return p;
+                }
+            }
+            return _allocate_slow(n, align);
+        }
+        /// An array of `n` `T`s, uninitialized
+        template <typename T>
+        T* allocate_array(std::size_t n)
+        {
+            return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+        }
+
+        /**
+         * Frees every chunk allocated by the arena, invalidating every
+         * allocation, and starts over from the caller-supplied buffer.
+         */
+        void release() noexcept;
+
+        /// Bytes in the chunks allocated by the arena
+        std::size_t chunk_bytes() const noexcept
+        {
+            return m_chunk_bytes;
+        }
+
+    private:
+        struct chunk_header {
+            chunk_header* next;
+            std::size_t size;
+        };
+
+        // Bytes to skip after `p` to align it to `align`
+        static std::size_t _padding(const unsigned char* p,
+                                    std::size_t align) noexcept
+        {
+            const auto addr = reinterpret_cast<std::uintptr_t>(p);
+            return static_cast<std::size_t>(
+                (0 - addr) & static_cast<std::uintptr_t>(align - 1));
+        }
+
+        void* _allocate_slow(std::size_t n, std::size_t align);
+
+        unsigned char* m_cur{nullptr};
+        unsigned char* m_end{nullptr};
+        chunk_header* m_chunks{nullptr};
+        unsigned char* m_initial{nullptr};
+        std::size_t m_initial_size{0};
+        std::size_t m_chunk_size{default_chunk_size};
+        std::size_t m_chunk_bytes{0};
+    };
+
+    /**
+     * A string view into a \ref monotonic_arena.
+     *
+     * When scanned into, the string is copied into the arena, and the view
+     * is set to point to it. The copy lives until the arena is released.
+     */
+    template <typename CharT>
+    class basic_arena_string_view {
+    public:
+        using char_type = CharT;
+        using view_type = basic_string_view<CharT>;
+        using iterator = typename view_type::const_iterator;
+
+        explicit basic_arena_string_view(monotonic_arena& a) noexcept
+            : m_arena(std::addressof(a))
+        {
+        }
+
+        /// Copies `s` into the arena, and points to the copy
+        void assign(const CharT* s, std::size_t n)
+        {
+            auto p = m_arena->allocate_array<CharT>(n);
+            if (n != 0) {
+                std::copy(s, s + n, p);
+            }
+            m_view = view_type{p, n};
+        }
+
+        view_type view() const noexcept
+        {
+            return m_view;
+        }
+        const CharT* data() const noexcept
+        {
+            return m_view.data();
+        }
+        std::size_t size() const noexcept
+        {
+            return m_view.size();
+        }
+        bool empty() const noexcept
+        {
+            return m_view.empty();
+        }
+        iterator begin() const noexcept
+        {
+            return m_view.begin();
+        }
+        iterator end() const noexcept
+        {
+            return m_view.end();
+        }
+
+        monotonic_arena& arena() const noexcept
+        {
+            return *m_arena;
+        }
+
+    private:
+        monotonic_arena* m_arena;
+        view_type m_view{};
+    };
+
+    using arena_string_view = basic_arena_string_view<char>;
+    using warena_string_view = basic_arena_string_view<wchar_t>;
+
+    /// @}
+
+    namespace detail {
+        struct arena_string_view_scanner : string_scanner {
+            template <typename Context>
+            error scan(
+                basic_arena_string_view<typename Context::char_type>& val,
+                Context& ctx)
+            {
+                using char_type = typename Context::char_type;
+
+                if (Context::range_type::is_contiguous) {
+                    auto s = _read_zero_copy(ctx);
+                    if (!s) {
+                        return s.error();
+                    }
+                    const auto chars = s.value().chars;
+                    if (s.value().escaped) {
+                        small_vector<char_type, 64> tmp;
+                        auto outputit = std::back_inserter(tmp);
+                        string_escapes::unescape(chars, m_quote, outputit);
+                        val.assign(tmp.data(), tmp.size());
+                        return {};
+                    }
+                    val.assign(chars.data(), chars.size());
+                    return {};
+                }
+
+                // Short strings are gathered on the stack,
+                // and copied into the arena once
+                small_vector<char_type, 64> tmp;
+                auto outputit = std::back_inserter(tmp);
+                auto ret = _read(ctx, outputit);
+                if (SCN_UNLIKELY(!ret)) {
+                    return ret;
+                }
+                if (SCN_UNLIKELY(tmp.empty() && !_allow_empty(ctx))) {
+                    return error(error::invalid_scanned_value,
+                                 "Empty string parsed");
+                }
+                val.assign(tmp.data(), tmp.size());
+                return {};
+            }
+        };
+    }  // namespace detail
+
+    template <typename CharT>
+    struct scanner<CharT, basic_arena_string_view<CharT>>
+        : public detail::arena_string_view_scanner {
+    };
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY && !defined(SCN_ARENA_CPP)
+#include "arena.cpp"
+#endif
+
+#endif  // SCN_DETAIL_ARENA_H
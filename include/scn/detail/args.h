@@ -71,11 +71,17 @@ namespace scn {
             int_type,
             long_type,
             long_long_type,
+#if SCN_HAS_INT128
+            int128_type,
+#endif
             // unsigned integer
             ushort_type,
             uint_type,
             ulong_type,
             ulong_long_type,
+#if SCN_HAS_INT128
+            uint128_type,
+#endif
             // other integral types
             bool_type,
             char_type,
@@ -228,6 +234,11 @@ namespace scn {
         SCN_MAKE_VALUE(ulong_type, unsigned long)
         SCN_MAKE_VALUE(ulong_long_type, unsigned long long)
 
+#if SCN_HAS_INT128
+        SCN_MAKE_VALUE(int128_type, int128)
+        SCN_MAKE_VALUE(uint128_type, uint128)
+#endif
+
         SCN_MAKE_VALUE(bool_type, bool)
 
         SCN_MAKE_VALUE(float_type, float)
@@ -366,6 +377,10 @@ namespace scn {
                 return vis(arg.m_value.template get_as<long>());
             case detail::long_long_type:
                 return vis(arg.m_value.template get_as<long long>());
+#if SCN_HAS_INT128
+            case detail::int128_type:
+                return vis(arg.m_value.template get_as<detail::int128>());
+#endif
 
             case detail::ushort_type:
                 return vis(arg.m_value.template get_as<unsigned short>());
@@ -375,6 +390,10 @@ namespace scn {
                 return vis(arg.m_value.template get_as<unsigned long>());
             case detail::ulong_long_type:
                 return vis(arg.m_value.template get_as<unsigned long long>());
+#if SCN_HAS_INT128
+            case detail::uint128_type:
+                return vis(arg.m_value.template get_as<detail::uint128>());
+#endif
 
             case detail::bool_type:
                 return vis(arg.m_value.template get_as<bool>());
@@ -0,0 +1,431 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_BIGINT_H
+#define SCN_DETAIL_BIGINT_H
+
+#include "scan.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup bigint Big integers
+     *
+     * \ref big_uint is an unsigned integer of any size, scanned with the
+     * same format specifiers as the built-in unsigned integers: `{}`
+     * detects the base from a `0x` or `0` prefix, `{:d}`, `{:x}`, `{:o}`
+     * and `{:b<N>}` give it. Localized digits and thousands separators
+     * aren't supported.
+     *
+     * In a base that is a power of two (like hexadecimal), the digits are
+     * mapped directly onto the bits of the limbs. In other bases (like
+     * decimal), the digits are converted in chunks that fit into a limb (19
+     * decimal digits), which are combined with a divide-and-conquer
+     * algorithm, multiplying by a tree of powers of the base with
+     * Karatsuba multiplication, in subquadratic time.
+     *
+     * The limbs can be passed on to other big integer libraries, e.g. with
+     * `mpz_import`.
+     */
+
+    /// @{
+
+    /// An unsigned integer of any size
+    class big_uint {
+    public:
+        using limb_type = uint64_t;
+
+        big_uint() = default;
+        explicit big_uint(uint64_t v)
+        {
+            if (v != 0) {
+                m_limbs.push_back(v);
+            }
+        }
+
+        /// The integer with `limbs`, the least significant one first
+        static big_uint from_limbs(std::vector<limb_type> limbs)
+        {
+            big_uint r;
+            r.m_limbs = std::move(limbs);
+            r._trim();
+            return r;
+        }
+
+        /**
+         * The limbs of the integer, the least significant one first,
+         * without leading zero limbs: zero has none.
+         */
+        const std::vector<limb_type>& limbs() const noexcept
+        {
+            return m_limbs;
+        }
+
+        bool is_zero() const noexcept
+        {
+            return m_limbs.empty();
+        }
+        /// Number of bits needed to represent the integer
+        std::size_t bit_width() const noexcept
+        {
+            if (m_limbs.empty()) {
+                return 0;
+            }
+            std::size_t n = (m_limbs.size() - 1) * 64;
+            for (auto top = m_limbs.back(); top != 0; top >>= 1) {
+                ++n;
+            }
+            return n;
+        }
+
+        friend bool operator==(const big_uint& a, const big_uint& b)
+        {
+            return a.m_limbs == b.m_limbs;
+        }
+        friend bool operator!=(const big_uint& a, const big_uint& b)
+        {
+            return !(a == b);
+        }
+        friend bool operator<(const big_uint& a, const big_uint& b)
+        {
+            if (a.m_limbs.size() != b.m_limbs.size()) {
+                return a.m_limbs.size() < b.m_limbs.size();
+            }
+            return std::lexicographical_compare(
+                a.m_limbs.rbegin(), a.m_limbs.rend(), b.m_limbs.rbegin(),
+                b.m_limbs.rend());
+        }
+        friend bool operator>(const big_uint& a, const big_uint& b)
+        {
+            return b < a;
+        }
+        friend bool operator<=(const big_uint& a, const big_uint& b)
+        {
+            return !(b < a);
+        }
+        friend bool operator>=(const big_uint& a, const big_uint& b)
+        {
+            return !(a < b);
+        }
+
+        friend big_uint operator+(const big_uint& a, const big_uint& b);
+        friend big_uint operator*(const big_uint& a, const big_uint& b);
+
+    private:
+        friend big_uint big_uint_from_chunks(const uint64_t* chunks,
+                                             std::size_t n,
+                                             uint64_t chunk_base);
+
+        void _trim()
+        {
+            while (!m_limbs.empty() && m_limbs.back() == 0) {
+                m_limbs.pop_back();
+            }
+        }
+
+        std::vector<limb_type> m_limbs{};
+    };
+
+    /**
+     * The integer with the digits `chunks[0]`, ..., `chunks[n - 1]`,
+     * the most significant one first, in base `chunk_base`.
+     */
+    big_uint big_uint_from_chunks(const uint64_t* chunks,
+                                  std::size_t n,
+                                  uint64_t chunk_base);
+
+    namespace detail {
+        template <typename CharT>
+        struct big_uint_parser {
+            using iterator = const CharT*;
+
+            static unsigned digit_value(CharT ch)
+            {
+                if (ch >= ascii_widen<CharT>('0') &&
+                    ch <= ascii_widen<CharT>('9')) {
+                    return static_cast<unsigned>(ch - ascii_widen<CharT>('0'));
+                }
+                if (ch >= ascii_widen<CharT>('a') &&
+                    ch <= ascii_widen<CharT>('z')) {
+                    return static_cast<unsigned>(ch - ascii_widen<CharT>('a')) +
+                           10;
+                }
+                if (ch >= ascii_widen<CharT>('A') &&
+                    ch <= ascii_widen<CharT>('Z')) {
+                    return static_cast<unsigned>(ch - ascii_widen<CharT>('A')) +
+                           10;
+                }
+                return 255;
+            }
+
+            /**
+             * Parses the integer at `begin` in `base`, 0 to detect it from
+             * a prefix, into `val`. Returns a pointer past the integer.
+             */
+            static expected<iterator> parse(iterator begin,
+                                            iterator end,
+                                            int base,
+                                            big_uint& val)
+            {
+                auto it = begin;
+                if (it != end && *it == ascii_widen<CharT>('-')) {
+                    return error(error::value_out_of_range,
+                                 "Unexpected sign '-' when scanning an "
+                                 "unsigned integer");
+                }
+                if (it != end && *it == ascii_widen<CharT>('+')) {
+                    ++it;
+                }
+                if (it == end) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected an integer");
+                }
+
+                if (*it == ascii_widen<CharT>('0') && end - it >= 3 &&
+                    (it[1] == ascii_widen<CharT>('x') ||
+                     it[1] == ascii_widen<CharT>('X')) &&
+                    (base == 0 || base == 16) && digit_value(it[2]) < 16) {
+                    it += 2;
+                    base = 16;
+                }
+                else if (base == 0) {
+                    base = *it == ascii_widen<CharT>('0') ? 8 : 10;
+                }
+                const auto ubase = static_cast<unsigned>(base);
+
+                const auto digits_begin = it;
+                while (it != end && *it == ascii_widen<CharT>('0')) {
+                    ++it;
+                }
+                const auto nonzero_begin = it;
+                while (it != end && digit_value(*it) < ubase) {
+                    ++it;
+                }
+                if (it == digits_begin) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected an integer");
+                }
+
+                if ((ubase & (ubase - 1)) == 0) {
+                    val = _from_bits(nonzero_begin, it, ubase);
+                }
+                else {
+                    val = _from_chunks(nonzero_begin, it, ubase);
+                }
+                return it;
+            }
+
+        private:
+            // Every digit is `log2(base)` bits, from the end
+            static big_uint _from_bits(iterator begin,
+                                       iterator end,
+                                       unsigned base)
+            {
+                const auto bits = countr_zero(static_cast<uint32_t>(base));
+                std::vector<uint64_t> limbs;
+                limbs.reserve(static_cast<std::size_t>(end - begin) *
+                                  static_cast<std::size_t>(bits) / 64 +
+                              1);
+                auto it = end;
+                if (bits == 4) {
+                    _hex_limbs(begin, it, limbs);
+                }
+                uint64_t acc = 0;
+                int n = 0;
+                while (it != begin) {
+                    const auto d = uint64_t{digit_value(*--it)};
+                    acc |= d << n;
+                    n += bits;
+                    if (n >= 64) {
+                        limbs.push_back(acc);
+                        n -= 64;
+                        acc = n != 0 ? d >> (bits - n) : 0;
+                    }
+                }
+                limbs.push_back(acc);
+                return big_uint::from_limbs(std::move(limbs));
+            }
+
+            // 16 hexadecimal digits into a limb at a time, from the end
+            static void _hex_limbs(const char* begin,
+                                   const char*& it,
+                                   std::vector<uint64_t>& limbs)
+            {
+                for (; it - begin >= 16; it -= 16) {
+                    const auto hi = swar::parse_8_hex_digits(
+                        swar::load8(it - 16));
+                    const auto lo =
+                        swar::parse_8_hex_digits(swar::load8(it - 8));
+                    limbs.push_back(uint64_t{hi} << 32 | lo);
+                }
+            }
+            template <typename C>
+            static void _hex_limbs(const C*,
+                                   const C*&,
+                                   std::vector<uint64_t>&)
+            {
+            }
+
+            // Chunks of as many digits as fit into a limb, combined with
+            // big_uint_from_chunks
+            static big_uint _from_chunks(iterator begin,
+                                         iterator end,
+                                         unsigned base)
+            {
+                if (begin == end) {
+                    return {};
+                }
+                int chunk_digits = 1;
+                uint64_t chunk_base = base;
+                while (chunk_base <= UINT64_MAX / base) {
+                    chunk_base *= base;
+                    ++chunk_digits;
+                }
+
+                const auto n = end - begin;
+                std::vector<uint64_t> chunks;
+                chunks.reserve(static_cast<std::size_t>(n / chunk_digits) +
+                               1);
+                auto len = n % chunk_digits;
+                if (len == 0) {
+                    len = chunk_digits;
+                }
+                for (auto it = begin; it != end;
+                     it += len, len = chunk_digits) {
+                    chunks.push_back(_chunk(it, it + len, base));
+                }
+                return big_uint_from_chunks(chunks.data(), chunks.size(),
+                                            chunk_base);
+            }
+
+            static uint64_t _chunk(const char* it,
+                                   const char* end,
+                                   unsigned base)
+            {
+                uint64_t v = 0;
+                if (base == 10) {
+                    for (; end - it >= 8; it += 8) {
+                        v = v * 100000000 +
+                            swar::parse_8_digits(swar::load8(it));
+                    }
+                }
+                for (; it != end; ++it) {
+                    v = v * base + digit_value(*it);
+                }
+                return v;
+            }
+            template <typename C>
+            static uint64_t _chunk(const C* it, const C* end, unsigned base)
+            {
+                uint64_t v = 0;
+                for (; it != end; ++it) {
+                    v = v * base + digit_value(*it);
+                }
+                return v;
+            }
+        };
+    }  // namespace detail
+
+    template <typename CharT>
+    struct scanner<CharT, big_uint>
+        : public detail::integer_scanner<unsigned long long> {
+        using base_scanner = detail::integer_scanner<unsigned long long>;
+
+        template <typename ParseCtx>
+        error parse(ParseCtx& pctx)
+        {
+            auto e = base_scanner::parse(pctx);
+            if (!e) {
+                return e;
+            }
+            if (localized != 0 || have_thsep) {
+                return error(error::invalid_format_string,
+                             "Localized big integers are not supported");
+            }
+            if (base == 1) {
+                return error(error::invalid_format_string,
+                             "Invalid base, must be between 2 and 36");
+            }
+            return {};
+        }
+
+        template <typename Context>
+        error scan(big_uint& val, Context& ctx)
+        {
+            auto do_parse = [&](span<const CharT> s) -> error {
+                big_uint tmp;
+                const auto end = s.data() + s.size();
+                auto ret = detail::big_uint_parser<CharT>::parse(
+                    s.data(), end, base, tmp);
+                if (!ret) {
+                    return ret.error();
+                }
+                if (ret.value() != end) {
+                    auto pb = putback_n(ctx.range(), end - ret.value());
+                    if (!pb) {
+                        return pb;
+                    }
+                }
+                val = std::move(tmp);
+                return {};
+            };
+
+            if (Context::range_type::is_contiguous) {
+                auto s = read_all_zero_copy(ctx.range());
+                if (!s) {
+                    return s.error();
+                }
+                return do_parse(s.value());
+            }
+
+            // Stop reading at characters that can't be a part of an
+            // integer, like with the built-in integers
+            auto is_end_pred = [&](CharT ch) {
+                return ctx.locale().is_space(ch) || ctx.is_delimiter(ch) ||
+                       (!detail::is_ascii_alnum(ch) &&
+                        ch != detail::ascii_widen<CharT>('+') &&
+                        ch != detail::ascii_widen<CharT>('-'));
+            };
+            detail::small_vector<CharT, 64> buf;
+            auto outputit = std::back_inserter(buf);
+            auto e =
+                read_until_space(ctx.range(), outputit, is_end_pred, false);
+            if (buf.empty()) {
+                if (!e) {
+                    return e;
+                }
+                return error(error::invalid_scanned_value,
+                             "Expected an integer");
+            }
+            return do_parse(make_span(buf).as_const());
+        }
+    };
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY && !defined(SCN_BIGINT_CPP)
+#include "bigint.cpp"
+#endif
+
+#endif  // SCN_DETAIL_BIGINT_H
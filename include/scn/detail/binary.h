@@ -0,0 +1,530 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_BINARY_H
+#define SCN_DETAIL_BINARY_H
+
+#include "scan.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup binary Binary data
+     *
+     * Scanners decoding text into bytes, stored into a
+     * `span<unsigned char>` or a `std::array<unsigned char, N>`.
+     * The encoding is given with the format specifier:
+     *  - `{}` or `{:x}`: hexadecimal, two digits per byte, in either case
+     *  - `{:b64}`: base64, with the `+/` alphabet, and the `=` padding
+     *  - `{:b64url}`: base64url, with the `-_` alphabet, and an optional
+     *    `=` padding
+     *  - `{:uuid}`: an UUID, in the canonical 8-4-4-4-12 format
+     *    (`123e4567-e89b-12d3-a456-426614174000`), into 16 bytes
+     *
+     * The encoded value ends at the first character not in the alphabet of
+     * the encoding. A `std::array` has to be filled exactly.
+     * A `span` is filled from the beginning, and shrunk to the number of
+     * bytes decoded, which can be less than its size: a value that doesn't
+     * fit is an error with the code `error::value_out_of_range`.
+     * On error, the bytes in a `span` are unspecified, but its size isn't
+     * changed.
+     *
+     * The decoding is strict: an odd number of hexadecimal digits, a
+     * missing or partial base64 padding (outside of base64url), or base64
+     * with set bits after the last byte are errors.
+     *
+     * On `char` ranges, 8 characters are validated and decoded at a time
+     * (see \ref detail::swar).
+     */
+
+    /// @{
+
+    namespace detail {
+        enum class binary_encoding : unsigned char {
+            hex,
+            base64,
+            base64url,
+            uuid
+        };
+
+        template <typename CharT>
+        struct binary_decoder {
+            using iterator = const CharT*;
+
+            /**
+             * Decodes the value at `begin` into `out`, of `cap` bytes, and
+             * sets `n` to the number of bytes decoded.
+             * Returns a pointer past the value.
+             */
+            static expected<iterator> decode(binary_encoding enc,
+                                             iterator begin,
+                                             iterator end,
+                                             unsigned char* out,
+                                             std::size_t cap,
+                                             std::size_t& n)
+            {
+                if (enc == binary_encoding::hex) {
+                    return hex(begin, end, out, cap, n);
+                }
+                if (enc == binary_encoding::uuid) {
+                    return uuid(begin, end, out, cap, n);
+                }
+                return base64(begin, end, enc == binary_encoding::base64url,
+                              out, cap, n);
+            }
+
+            /// Number of characters needed to encode `n` bytes
+            static std::size_t encoded_size(binary_encoding enc,
+                                            std::size_t n)
+            {
+                if (enc == binary_encoding::hex) {
+                    return 2 * n;
+                }
+                if (enc == binary_encoding::uuid) {
+                    return 36;
+                }
+                return (n + 2) / 3 * 4;
+            }
+
+            static expected<iterator> hex(iterator begin,
+                                          iterator end,
+                                          unsigned char* out,
+                                          std::size_t cap,
+                                          std::size_t& n)
+            {
+                auto it = begin;
+                std::size_t size = _hex_blocks(it, end, out, cap);
+                for (; it != end; it += 2) {
+                    const auto hi = hex_value(*it);
+                    if (hi < 0) {
+                        break;
+                    }
+                    const auto lo = end - it >= 2 ? hex_value(it[1]) : -1;
+                    if (lo < 0) {
+                        return error(error::invalid_scanned_value,
+                                     "Odd number of hexadecimal digits");
+                    }
+                    if (size == cap) {
+                        return _too_long();
+                    }
+                    out[size++] = static_cast<unsigned char>(hi << 4 | lo);
+                }
+                if (it == begin) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected hexadecimal digits");
+                }
+                n = size;
+                return it;
+            }
+
+            static expected<iterator> base64(iterator begin,
+                                             iterator end,
+                                             bool url,
+                                             unsigned char* out,
+                                             std::size_t cap,
+                                             std::size_t& n)
+            {
+                auto it = begin;
+                std::size_t size = _base64_blocks(it, end, url, out, cap);
+                while (true) {
+                    // a group of 4 characters
+                    unsigned v[4] = {};
+                    int k = 0;
+                    for (; k < 4 && it + k != end; ++k) {
+                        const auto d = base64_value(it[k], url);
+                        if (d < 0) {
+                            break;
+                        }
+                        v[k] = static_cast<unsigned>(d);
+                    }
+                    if (k == 0) {
+                        break;
+                    }
+                    if (k == 1) {
+                        return _invalid_base64();
+                    }
+                    const auto bytes = static_cast<std::size_t>(k - 1);
+                    if (cap - size < bytes) {
+                        return _too_long();
+                    }
+                    const auto group = v[0] << 18 | v[1] << 12 | v[2] << 6 |
+                                       v[3];
+                    for (std::size_t i = 0; i < bytes; ++i) {
+                        out[size++] = static_cast<unsigned char>(
+                            group >> (16 - 8 * i));
+                    }
+                    it += k;
+                    if (k == 4) {
+                        continue;
+                    }
+
+                    // the last, partial group: the padding is required,
+                    // apart from in base64url, and the bits after the last
+                    // byte have to be zero
+                    if ((group >> (16 - 8 * bytes) & 0xffu) != 0) {
+                        return _invalid_base64();
+                    }
+                    int padding = 0;
+                    for (; padding < 4 - k && it + padding != end &&
+                           it[padding] == ascii_widen<CharT>('=');
+                         ++padding) {
+                    }
+                    if (padding != 4 - k && (padding != 0 || !url)) {
+                        return _invalid_base64();
+                    }
+                    it += padding;
+                    break;
+                }
+                if (it == begin) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected base64 data");
+                }
+                n = size;
+                return it;
+            }
+
+            static expected<iterator> uuid(iterator begin,
+                                           iterator end,
+                                           unsigned char* out,
+                                           std::size_t cap,
+                                           std::size_t& n)
+            {
+                n = 0;
+                const auto dash = ascii_widen<CharT>('-');
+                if (end - begin < 36 || begin[8] != dash ||
+                    begin[13] != dash || begin[18] != dash ||
+                    begin[23] != dash) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected an UUID");
+                }
+                if (cap < 16) {
+                    return _too_long();
+                }
+                // the digits without the dashes
+                CharT digits[32];
+                std::copy(begin, begin + 8, digits);
+                std::copy(begin + 9, begin + 13, digits + 8);
+                std::copy(begin + 14, begin + 18, digits + 12);
+                std::copy(begin + 19, begin + 23, digits + 16);
+                std::copy(begin + 24, begin + 36, digits + 20);
+                auto ret = hex(digits, digits + 32, out, 16, n);
+                if (!ret || ret.value() != digits + 32) {
+                    n = 0;
+                    return error(error::invalid_scanned_value,
+                                 "Expected an UUID");
+                }
+                return begin + 36;
+            }
+
+            static int hex_value(CharT ch)
+            {
+                if (ch >= ascii_widen<CharT>('0') &&
+                    ch <= ascii_widen<CharT>('9')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('0'));
+                }
+                if (ch >= ascii_widen<CharT>('a') &&
+                    ch <= ascii_widen<CharT>('f')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('a')) +
+                           10;
+                }
+                if (ch >= ascii_widen<CharT>('A') &&
+                    ch <= ascii_widen<CharT>('F')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('A')) +
+                           10;
+                }
+                return -1;
+            }
+            static int base64_value(CharT ch, bool url)
+            {
+                if (ch >= ascii_widen<CharT>('A') &&
+                    ch <= ascii_widen<CharT>('Z')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('A'));
+                }
+                if (ch >= ascii_widen<CharT>('a') &&
+                    ch <= ascii_widen<CharT>('z')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('a')) +
+                           26;
+                }
+                if (ch >= ascii_widen<CharT>('0') &&
+                    ch <= ascii_widen<CharT>('9')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('0')) +
+                           52;
+                }
+                if (ch == ascii_widen<CharT>(url ? '-' : '+')) {
+                    return 62;
+                }
+                if (ch == ascii_widen<CharT>(url ? '_' : '/')) {
+                    return 63;
+                }
+                return -1;
+            }
+
+        private:
+            static error _too_long()
+            {
+                return error(error::value_out_of_range,
+                             "Decoded value too long for the destination");
+            }
+            static error _invalid_base64()
+            {
+                return error(error::invalid_scanned_value,
+                             "Invalid base64 data");
+            }
+
+            // Decodes blocks of 8 hexadecimal digits into 4 bytes each,
+            // while there's room for them in `out`, and advances `it` past
+            // them. Returns the number of bytes written.
+            static std::size_t _hex_blocks(const char*& it,
+                                           const char* end,
+                                           unsigned char* out,
+                                           std::size_t cap)
+            {
+                // a local copy: the stores into `out` could alias `it`
+                auto p = it;
+                std::size_t size = 0;
+                for (; end - p >= 8 && cap - size >= 4; p += 8, size += 4) {
+                    if (!_hex8(p, out + size)) {
+                        break;
+                    }
+                }
+                it = p;
+                return size;
+            }
+            template <typename C>
+            static std::size_t _hex_blocks(const C*&,
+                                           const C*,
+                                           unsigned char*,
+                                           std::size_t)
+            {
+                return 0;
+            }
+            // false and nothing written, if they aren't all digits
+            static bool _hex8(const char* p, unsigned char* out)
+            {
+                const auto w = swar::load8(p);
+                if (swar::movemask(swar::hex_digit_mask(w)) != 0xffu) {
+                    return false;
+                }
+                const auto nibbles = swar::hex_nibbles(w);
+                // byte i: nibble i in the high half, nibble i + 1 in the
+                // low half; the even bytes are the decoded ones
+                const auto bytes = (nibbles << 4) | (nibbles >> 8);
+                out[0] = static_cast<unsigned char>(bytes);
+                out[1] = static_cast<unsigned char>(bytes >> 16);
+                out[2] = static_cast<unsigned char>(bytes >> 32);
+                out[3] = static_cast<unsigned char>(bytes >> 48);
+                return true;
+            }
+
+            // Like _hex_blocks, 8 base64 characters into 6 bytes each,
+            // until a character outside of the alphabet (like a padding `=`)
+            static std::size_t _base64_blocks(const char*& it,
+                                              const char* end,
+                                              bool url,
+                                              unsigned char* out,
+                                              std::size_t cap)
+            {
+                constexpr uint64_t ones = UINT64_C(0x0101010101010101);
+                constexpr uint64_t high = UINT64_C(0x8080808080808080);
+                // The high bit of every byte of `v` equal to `c`
+                auto equal = [](uint64_t v, uint64_t c) {
+                    const auto x = v ^ c;
+                    return ~(((x & ~high) + ~high) | x) & high;
+                };
+                // The high bits of `mask` as whole bytes
+                auto bytes = [](uint64_t mask) { return (mask >> 7) * 0xff; };
+                const auto c62 = ones * static_cast<unsigned char>(
+                                            url ? '-' : '+');
+                const auto c63 = ones * static_cast<unsigned char>(
+                                            url ? '_' : '/');
+
+                // a local copy: the stores into `out` could alias `it`
+                auto p = it;
+                std::size_t size = 0;
+                for (; end - p >= 8 && cap - size >= 6; p += 8, size += 6) {
+                    const auto w = swar::load8(p);
+                    // 'A' to 'Z' and 'a' to 'z' differ only in the bit 5
+                    const auto letter = swar::in_range(
+                        w | UINT64_C(0x2020202020202020), 'a', 'z');
+                    const auto digit = swar::digit_mask(w);
+                    const auto is62 = equal(w, c62);
+                    const auto is63 = equal(w, c63);
+                    if ((letter | digit | is62 | is63) != high) {
+                        break;
+                    }
+                    // the value of every character in its class:
+                    // no byte borrows or carries
+                    const auto lowercase = (w >> 5) & ones;
+                    const auto v =
+                        ((w & UINT64_C(0x1f1f1f1f1f1f1f1f) & bytes(letter)) -
+                         (ones & bytes(letter))) +
+                        (lowercase * 26 & bytes(letter)) +
+                        ((w & bytes(digit)) + (ones * 4 & bytes(digit))) +
+                        (ones * 62 & bytes(is62)) + (ones * 63 & bytes(is63));
+                    // 16-bit lanes of 12 bits, then 32-bit lanes of 24 bits
+                    const auto x =
+                        ((v & UINT64_C(0x00ff00ff00ff00ff)) << 6) |
+                        ((v >> 8) & UINT64_C(0x00ff00ff00ff00ff));
+                    const auto y =
+                        ((x & UINT64_C(0x0000ffff0000ffff)) << 12) |
+                        ((x >> 16) & UINT64_C(0x0000ffff0000ffff));
+                    auto o = out + size;
+                    o[0] = static_cast<unsigned char>(y >> 16);
+                    o[1] = static_cast<unsigned char>(y >> 8);
+                    o[2] = static_cast<unsigned char>(y);
+                    o[3] = static_cast<unsigned char>(y >> 48);
+                    o[4] = static_cast<unsigned char>(y >> 40);
+                    o[5] = static_cast<unsigned char>(y >> 32);
+                }
+                it = p;
+                return size;
+            }
+            template <typename C>
+            static std::size_t _base64_blocks(const C*&,
+                                              const C*,
+                                              bool,
+                                              unsigned char*,
+                                              std::size_t)
+            {
+                return 0;
+            }
+        };
+
+        struct binary_scanner {
+            template <typename ParseCtx>
+            error parse(ParseCtx& pctx)
+            {
+                using char_type = typename ParseCtx::char_type;
+
+                pctx.arg_begin();
+                if (SCN_UNLIKELY(!pctx)) {
+                    return error(error::invalid_format_string,
+                                 "Unexpected format string end");
+                }
+                char spec[8] = {};
+                std::size_t len = 0;
+                while (pctx && !pctx.check_arg_end()) {
+                    const auto ch = pctx.next();
+                    if (len == sizeof(spec) - 1 ||
+                        ch < ascii_widen<char_type>('0') ||
+                        ch > ascii_widen<char_type>('z')) {
+                        return error(error::invalid_format_string,
+                                     "Invalid binary encoding");
+                    }
+                    spec[len++] = static_cast<char>(ch);
+                    pctx.advance();
+                }
+                if (len == 0 || std::strcmp(spec, "x") == 0) {
+                    m_encoding = binary_encoding::hex;
+                }
+                else if (std::strcmp(spec, "b64") == 0) {
+                    m_encoding = binary_encoding::base64;
+                }
+                else if (std::strcmp(spec, "b64url") == 0) {
+                    m_encoding = binary_encoding::base64url;
+                }
+                else if (std::strcmp(spec, "uuid") == 0) {
+                    m_encoding = binary_encoding::uuid;
+                }
+                else {
+                    return error(error::invalid_format_string,
+                                 "Invalid binary encoding");
+                }
+                if (!pctx || !pctx.check_arg_end()) {
+                    return error(error::invalid_format_string,
+                                 "Expected argument end");
+                }
+                pctx.arg_end();
+                return {};
+            }
+
+            template <typename Context>
+            error scan(span<unsigned char>& val, Context& ctx)
+            {
+                std::size_t n{};
+                auto e = _decode(ctx, val.data(), val.size(), n);
+                if (!e) {
+                    return e;
+                }
+                val = val.first(n);
+                return {};
+            }
+
+            template <typename Context, std::size_t N>
+            error scan(std::array<unsigned char, N>& val, Context& ctx)
+            {
+                std::array<unsigned char, N> tmp;
+                std::size_t n{};
+                auto e = _decode(ctx, tmp.data(), N, n);
+                if (!e) {
+                    return e;
+                }
+                if (n != N) {
+                    return error(error::invalid_scanned_value,
+                                 "Decoded value too short for the "
+                                 "destination");
+                }
+                val = tmp;
+                return {};
+            }
+
+            binary_encoding m_encoding{binary_encoding::hex};
+
+        private:
+            template <typename Context>
+            error _decode(Context& ctx,
+                          unsigned char* out,
+                          std::size_t cap,
+                          std::size_t& n)
+            {
+                using char_type = typename Context::char_type;
+                using decoder = binary_decoder<char_type>;
+
+                // the longest value, and a character after it
+                const auto max_chars =
+                    decoder::encoded_size(m_encoding, cap) + 1;
+                return read_with_parser(
+                    ctx.range(),
+                    [&](const char_type* b, const char_type* end) {
+                        return decoder::decode(m_encoding, b, end, out, cap,
+                                               n);
+                    },
+                    max_chars);
+            }
+        };
+    }  // namespace detail
+
+    template <typename CharT>
+    struct scanner<CharT, span<unsigned char>>
+        : public detail::binary_scanner {
+    };
+    template <typename CharT, std::size_t N>
+    struct scanner<CharT, std::array<unsigned char, N>>
+        : public detail::binary_scanner {
+    };
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_BINARY_H
@@ -0,0 +1,1058 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_CHRONO_H
+#define SCN_DETAIL_CHRONO_H
+
+#include "scan.h"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup chrono Dates, times and durations
+     *
+     * Scanners for \ref date_time, `std::chrono::system_clock` time points
+     * (`std::chrono::time_point<std::chrono::system_clock, Duration>`),
+     * and `std::chrono::duration`s.
+     *
+     * With `"{}"`, a date and time is read in the ISO 8601 / RFC 3339
+     * format: `2024-03-01`, `2024-03-01T12:30`, `2024-03-01T12:30:15Z`,
+     * `2024-03-01 12:30:15.123456+02:00`. The separator between the date and
+     * the time is `T`, `t` or a space. The seconds can have a fraction,
+     * with a `.` or a `,`, which is stored with nanosecond precision.
+     * The time can be followed by `Z` (`z`) or an UTC offset (`+hh:mm`,
+     * `+hhmm` or `+hh`).
+     *
+     * Otherwise, the format specifier is a pattern, like in `strptime`:
+     * `"{:%d/%b/%Y:%H:%M:%S %z}"`. It contains these conversions:
+     *  - `%Y`: year, up to 4 digits
+     *  - `%y`: year in the century, 2 digits, 69-99 is 19xx, 00-68 is 20xx
+     *  - `%m`: month, `%d` and `%e`: day, `%H`: hour, `%M`: minute,
+     *    `%S`: second, up to 2 digits
+     *  - `%f`: digits of a fraction of a second (without the `.`)
+     *  - `%b`, `%h` and `%B`: English name of a month, abbreviated or full,
+     *    case-insensitive
+     *  - `%a` and `%A`: English name of a day of the week, which is ignored
+     *  - `%z`: `Z` or an UTC offset, as above
+     *  - `%s`: seconds since the epoch (1970-01-01T00:00:00Z)
+     *  - `%F`: `%Y-%m-%d`, `%T`: `%H:%M:%S`, `%R`: `%H:%M`
+     *  - `%n` and `%t`: any whitespace, `%%`: a `%`
+     *
+     * Whitespace in the pattern matches any amount of whitespace (or none),
+     * numbers can be preceded by spaces, and other characters have to match
+     * exactly.
+     *
+     * The digits of the fixed-width fields of an ISO 8601 timestamp are
+     * validated and converted 8 at a time (see \ref detail::swar), and the
+     * conversion to a time point is done arithmetically, without `mktime`,
+     * `timegm` or the C locale.
+     *
+     * A `std::chrono::duration` is read either as a number of its periods
+     * (`"150"`), as a number with an unit (`"150ms"`, `"1.5s"`), as a
+     * sequence of them (`"1h30m15s"`), or as a clock time
+     * (`"-01:30:15.5"`). The units are `ns`, `us`, `ms`, `s`, `m` or `min`,
+     * `h` and `d`.
+     */
+
+    /// @{
+
+    /// A date and time, as in the source
+    struct date_time {
+        int year{1970};
+        /// 1-12
+        int month{1};
+        /// 1-31
+        int day{1};
+        int hour{0};
+        int minute{0};
+        /// 0-60, 60 is a leap second
+        int second{0};
+        int nanosecond{0};
+        /// Offset from UTC in seconds, `+02:00` is 7200
+        int utc_offset{0};
+        /// `true`, if the source had `Z` or an UTC offset
+        bool has_utc_offset{false};
+    };
+
+    /**
+     * Number of days between 1970-01-01 and the date `y-m-d` in the
+     * proleptic Gregorian calendar, negative before 1970.
+     * `m` must be 1-12, and `d` 1-31.
+     */
+    SCN_CONSTEXPR14 int64_t days_from_civil(int64_t y,
+                                            unsigned m,
+                                            unsigned d) noexcept
+    {
+        y -= m <= 2 ? 1 : 0;
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const auto yoe = static_cast<unsigned>(y - era * 400);
+        const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    namespace detail {
+        struct civil {
+            static bool is_leap(int64_t y) noexcept
+            {
+                return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+            }
+            static int days_in_month(int64_t y, int m) noexcept
+            {
+                SCN_EXPECT(m >= 1 && m <= 12);
+                static constexpr int days[] = {31, 28, 31, 30, 31, 30,
+                                               31, 31, 30, 31, 30, 31};
+                return m == 2 && is_leap(y) ? 29 : days[m - 1];
+            }
+
+            // Inverse of days_from_civil
+            static void from_days(int64_t z, date_time& dt) noexcept
+            {
+                z += 719468;
+                const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+                const auto doe = static_cast<unsigned>(z - era * 146097);
+                const unsigned yoe =
+                    (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+                const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+                const unsigned mp = (5 * doy + 2) / 153;
+                const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+                const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+                dt.year = static_cast<int>(static_cast<int64_t>(yoe) +
+                                           era * 400 + (m <= 2 ? 1 : 0));
+                dt.month = static_cast<int>(m);
+                dt.day = static_cast<int>(d);
+            }
+
+            static error validate(const date_time& dt) noexcept
+            {
+                if (dt.month < 1 || dt.month > 12 || dt.day < 1 ||
+                    dt.day > days_in_month(dt.year, dt.month)) {
+                    return error(error::value_out_of_range, "Invalid date");
+                }
+                if (dt.hour > 23 || dt.minute > 59 || dt.second > 60) {
+                    return error(error::value_out_of_range, "Invalid time");
+                }
+                return {};
+            }
+        };
+    }  // namespace detail
+
+    /**
+     * The point in time `dt`, interpreting it as UTC, if it doesn't have an
+     * UTC offset. Rounded down to a multiple of `Duration`.
+     * Returns an error with the code `error::value_out_of_range`, if it
+     * can't be represented as a `time_point` with `Duration`.
+     */
+    template <typename Duration = std::chrono::system_clock::duration>
+    expected<std::chrono::time_point<std::chrono::system_clock, Duration>>
+    to_sys_time(const date_time& dt)
+    {
+        using std::chrono::duration_cast;
+        using seconds = std::chrono::duration<int64_t>;
+        using time_point =
+            std::chrono::time_point<std::chrono::system_clock, Duration>;
+
+        const auto days =
+            days_from_civil(dt.year, static_cast<unsigned>(dt.month),
+                            static_cast<unsigned>(dt.day));
+        const auto secs = days * 86400 + dt.hour * 3600 + dt.minute * 60 +
+                          dt.second - dt.utc_offset;
+
+        using limits_type = std::chrono::duration<long double>;
+        const auto max = duration_cast<limits_type>(Duration::max()).count();
+        const auto min = duration_cast<limits_type>(Duration::min()).count();
+        if (static_cast<long double>(secs) >= max ||
+            static_cast<long double>(secs) < min) {
+            return error(error::value_out_of_range,
+                         "Date and time out of range for the time point");
+        }
+
+        // duration_cast rounds towards zero
+        auto whole = duration_cast<Duration>(seconds(secs));
+        if (duration_cast<seconds>(whole).count() > secs) {
+            whole -= Duration(1);
+        }
+        const auto frac =
+            duration_cast<Duration>(std::chrono::nanoseconds(dt.nanosecond));
+        return time_point(whole + frac);
+    }
+
+    namespace detail {
+        // Number of periods, or a number of nanoseconds
+        struct duration_value {
+            bool negative{false};
+            // A number of periods: count + fraction / 10^fraction_digits
+            bool bare{false};
+            uint64_t count{0};
+            uint64_t fraction{0};
+            int fraction_digits{0};
+            // Otherwise
+            int64_t nanoseconds{0};
+        };
+
+        template <typename CharT>
+        struct chrono_parser {
+            using iterator = const CharT*;
+
+            static CharT widen(char ch)
+            {
+                return ascii_widen<CharT>(ch);
+            }
+            static bool is_digit(CharT ch)
+            {
+                return detail::is_digit(ch);
+            }
+            static int digit(CharT ch)
+            {
+                return static_cast<int>(ch - widen('0'));
+            }
+            static bool is_space(CharT ch)
+            {
+                return ch == widen(' ') ||
+                       (ch >= widen('\t') && ch <= widen('\r'));
+            }
+            static CharT to_lower(CharT ch)
+            {
+                return ch >= widen('A') && ch <= widen('Z')
+                           ? static_cast<CharT>(ch - widen('A') + widen('a'))
+                           : ch;
+            }
+
+            static bool literal(iterator& it, iterator end, char ch)
+            {
+                if (it == end || *it != widen(ch)) {
+                    return false;
+                }
+                ++it;
+                return true;
+            }
+            // Exactly `n` digits
+            static bool fixed_digits(iterator& it,
+                                     iterator end,
+                                     int n,
+                                     int& val)
+            {
+                if (end - it < n) {
+                    return false;
+                }
+                int v = 0;
+                for (int i = 0; i < n; ++i, ++it) {
+                    if (!is_digit(*it)) {
+                        return false;
+                    }
+                    v = v * 10 + digit(*it);
+                }
+                val = v;
+                return true;
+            }
+            // 1 to `n` digits, after optional spaces
+            static bool digits(iterator& it, iterator end, int n, int& val)
+            {
+                while (it != end && *it == widen(' ')) {
+                    ++it;
+                }
+                if (it == end || !is_digit(*it)) {
+                    return false;
+                }
+                int v = 0;
+                for (int i = 0; i < n && it != end && is_digit(*it);
+                     ++i, ++it) {
+                    v = v * 10 + digit(*it);
+                }
+                val = v;
+                return true;
+            }
+
+            // The digits of a fraction of a second, at least one,
+            // truncated to nanoseconds
+            static bool fraction(iterator& it, iterator end, int& ns)
+            {
+                if (it == end || !is_digit(*it)) {
+                    return false;
+                }
+                uint32_t v = 0;
+                int n = 0;
+                _fraction8(it, end, v, n);
+                for (; it != end && is_digit(*it); ++it) {
+                    if (n < 9) {
+                        v = v * 10 + static_cast<uint32_t>(digit(*it));
+                        ++n;
+                    }
+                }
+                static constexpr uint32_t pow10[] = {
+                    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000,
+                    100000000, 1000000000};
+                ns = static_cast<int>(v * pow10[9 - n]);
+                return true;
+            }
+
+            // `Z`, or `+hh:mm`, `+hhmm` or `+hh`
+            static bool utc_offset(iterator& it, iterator end, date_time& dt)
+            {
+                if (it == end) {
+                    return false;
+                }
+                if (*it == widen('Z') || *it == widen('z')) {
+                    ++it;
+                    dt.utc_offset = 0;
+                    dt.has_utc_offset = true;
+                    return true;
+                }
+                if (*it != widen('+') && *it != widen('-')) {
+                    return false;
+                }
+                const bool minus = *it == widen('-');
+                auto p = it + 1;
+                int hours{}, minutes{0};
+                if (!fixed_digits(p, end, 2, hours) || hours > 23) {
+                    return false;
+                }
+                auto q = p;
+                literal(q, end, ':');
+                if (fixed_digits(q, end, 2, minutes)) {
+                    if (minutes > 59) {
+                        return false;
+                    }
+                    p = q;
+                }
+                const int offset = hours * 3600 + minutes * 60;
+                dt.utc_offset = minus ? -offset : offset;
+                dt.has_utc_offset = true;
+                it = p;
+                return true;
+            }
+
+            static expected<iterator> iso(iterator begin,
+                                          iterator end,
+                                          date_time& dt)
+            {
+                dt = date_time{};
+                auto it = begin;
+                if (_iso_prefix(it, end, dt)) {
+                    it += 19;
+                }
+                else {
+                    if (!fixed_digits(it, end, 4, dt.year) ||
+                        !literal(it, end, '-') ||
+                        !fixed_digits(it, end, 2, dt.month) ||
+                        !literal(it, end, '-') ||
+                        !fixed_digits(it, end, 2, dt.day)) {
+                        return error(error::invalid_scanned_value,
+                                     "Expected an ISO 8601 date");
+                    }
+                    // A space separates the time only if one follows
+                    const bool has_time =
+                        it != end &&
+                        (*it == widen('T') || *it == widen('t') ||
+                         (*it == widen(' ') && end - it >= 4 &&
+                          is_digit(it[1]) && is_digit(it[2]) &&
+                          it[3] == widen(':')));
+                    if (!has_time) {
+                        auto e = civil::validate(dt);
+                        if (!e) {
+                            return e;
+                        }
+                        return it;
+                    }
+                    ++it;
+                    if (!fixed_digits(it, end, 2, dt.hour) ||
+                        !literal(it, end, ':') ||
+                        !fixed_digits(it, end, 2, dt.minute)) {
+                        return error(error::invalid_scanned_value,
+                                     "Expected an ISO 8601 time");
+                    }
+                    auto p = it;
+                    if (literal(p, end, ':')) {
+                        if (!fixed_digits(p, end, 2, dt.second)) {
+                            return error(error::invalid_scanned_value,
+                                         "Expected an ISO 8601 time");
+                        }
+                        it = p;
+                    }
+                }
+                if (it != end && (*it == widen('.') || *it == widen(','))) {
+                    auto p = it + 1;
+                    if (fraction(p, end, dt.nanosecond)) {
+                        it = p;
+                    }
+                }
+                utc_offset(it, end, dt);
+
+                auto e = civil::validate(dt);
+                if (!e) {
+                    return e;
+                }
+                return it;
+            }
+
+            static expected<iterator> pattern(iterator begin,
+                                              iterator end,
+                                              basic_string_view<CharT> pat,
+                                              date_time& dt)
+            {
+                dt = date_time{};
+                auto it = begin;
+                const auto mismatch = [] {
+                    return error(error::invalid_scanned_value,
+                                 "Input doesn't match the date/time pattern");
+                };
+                for (auto p = pat.begin(); p != pat.end(); ++p) {
+                    if (is_space(*p)) {
+                        _skip_spaces(it, end);
+                        continue;
+                    }
+                    if (*p != widen('%')) {
+                        if (it == end || *it != *p) {
+                            return mismatch();
+                        }
+                        ++it;
+                        continue;
+                    }
+                    ++p;
+                    SCN_EXPECT(p != pat.end());
+                    bool ok = true;
+                    int year{};
+                    switch (static_cast<char>(*p)) {
+                        case 'Y':
+                            ok = digits(it, end, 4, dt.year);
+                            break;
+                        case 'y':
+                            ok = fixed_digits(it, end, 2, year);
+                            dt.year = year < 69 ? 2000 + year : 1900 + year;
+                            break;
+                        case 'm':
+                            ok = digits(it, end, 2, dt.month);
+                            break;
+                        case 'd':
+                        case 'e':
+                            ok = digits(it, end, 2, dt.day);
+                            break;
+                        case 'H':
+                            ok = digits(it, end, 2, dt.hour);
+                            break;
+                        case 'M':
+                            ok = digits(it, end, 2, dt.minute);
+                            break;
+                        case 'S':
+                            ok = digits(it, end, 2, dt.second);
+                            break;
+                        case 'f':
+                            ok = fraction(it, end, dt.nanosecond);
+                            break;
+                        case 'b':
+                        case 'h':
+                        case 'B':
+                            ok = _month_name(it, end, dt.month);
+                            break;
+                        case 'a':
+                        case 'A':
+                            ok = _weekday_name(it, end);
+                            break;
+                        case 'z':
+                            ok = utc_offset(it, end, dt);
+                            break;
+                        case 's':
+                            ok = _epoch(it, end, dt);
+                            break;
+                        case 'F':
+                            ok = digits(it, end, 4, dt.year) &&
+                                 literal(it, end, '-') &&
+                                 digits(it, end, 2, dt.month) &&
+                                 literal(it, end, '-') &&
+                                 digits(it, end, 2, dt.day);
+                            break;
+                        case 'T':
+                            ok = digits(it, end, 2, dt.hour) &&
+                                 literal(it, end, ':') &&
+                                 digits(it, end, 2, dt.minute) &&
+                                 literal(it, end, ':') &&
+                                 digits(it, end, 2, dt.second);
+                            break;
+                        case 'R':
+                            ok = digits(it, end, 2, dt.hour) &&
+                                 literal(it, end, ':') &&
+                                 digits(it, end, 2, dt.minute);
+                            break;
+                        case 'n':
+                        case 't':
+                            _skip_spaces(it, end);
+                            break;
+                        default:
+                            SCN_EXPECT(*p == widen('%'));
+                            ok = literal(it, end, '%');
+                            break;
+                    }
+                    if (!ok) {
+                        return mismatch();
+                    }
+                }
+
+                auto e = civil::validate(dt);
+                if (!e) {
+                    return e;
+                }
+                return it;
+            }
+
+            // `pat` contains only known conversions
+            static bool is_valid_pattern(basic_string_view<CharT> pat)
+            {
+                for (auto p = pat.begin(); p != pat.end(); ++p) {
+                    if (*p != widen('%')) {
+                        continue;
+                    }
+                    if (++p == pat.end()) {
+                        return false;
+                    }
+                    bool known = false;
+                    for (auto c : {'Y', 'y', 'm', 'd', 'e', 'H', 'M', 'S',
+                                   'f', 'b', 'h', 'B', 'a', 'A', 'z', 's',
+                                   'F', 'T', 'R', 'n', 't', '%'}) {
+                        known = known || *p == widen(c);
+                    }
+                    if (!known) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            static expected<iterator> duration(iterator begin,
+                                               iterator end,
+                                               duration_value& val)
+            {
+                val = duration_value{};
+                auto it = begin;
+                if (it != end && (*it == widen('-') || *it == widen('+'))) {
+                    val.negative = *it == widen('-');
+                    ++it;
+                }
+                auto e = _duration_number(it, end, val);
+                if (!e) {
+                    return e;
+                }
+
+                // h:mm:ss
+                auto p = it;
+                int minutes{}, seconds{};
+                if (literal(p, end, ':') &&
+                    fixed_digits(p, end, 2, minutes) &&
+                    literal(p, end, ':') &&
+                    fixed_digits(p, end, 2, seconds)) {
+                    if (minutes > 59 || seconds > 59 ||
+                        val.fraction_digits != 0) {
+                        return error(error::invalid_scanned_value,
+                                     "Invalid duration");
+                    }
+                    int ns{0};
+                    if (p != end && *p == widen('.')) {
+                        auto q = p + 1;
+                        if (fraction(q, end, ns)) {
+                            p = q;
+                        }
+                    }
+                    constexpr uint64_t max_hours =
+                        static_cast<uint64_t>(INT64_MAX) / 3600000000000;
+                    if (val.count >= max_hours) {
+                        return error(error::value_out_of_range,
+                                     "Duration out of range");
+                    }
+                    const auto secs = static_cast<int64_t>(val.count) * 3600 +
+                                      minutes * 60 + seconds;
+                    val.nanoseconds = secs * 1000000000 + ns;
+                    return p;
+                }
+
+                int64_t unit = _unit(it, end);
+                if (unit == 0) {
+                    val.bare = true;
+                    return it;
+                }
+                // 1h30m15s
+                while (true) {
+                    e = _add_to_nanoseconds(val, unit);
+                    if (!e) {
+                        return e;
+                    }
+                    if (it == end || !is_digit(*it)) {
+                        return it;
+                    }
+                    p = it;
+                    e = _duration_number(p, end, val);
+                    if (!e) {
+                        return e;
+                    }
+                    unit = _unit(p, end);
+                    if (unit == 0) {
+                        return it;
+                    }
+                    it = p;
+                }
+            }
+
+        private:
+            static void _skip_spaces(iterator& it, iterator end)
+            {
+                while (it != end && is_space(*it)) {
+                    ++it;
+                }
+            }
+
+            // "YYYY-MM-DDTHH:MM:SS", 8 characters at a time
+            static bool _iso_prefix(const char* it,
+                                    const char* end,
+                                    date_time& dt)
+            {
+                if (end - it < 19) {
+                    return false;
+                }
+                // bytes 4 and 7 of the date are '-',
+                // bytes 2 and 5 of the time are ':'
+                constexpr uint64_t zeros = UINT64_C(0x3030303030303030);
+                constexpr uint64_t date_seps = UINT64_C(0xff0000ff00000000);
+                constexpr uint64_t time_seps = UINT64_C(0x0000ff0000ff0000);
+                const auto date = swar::load8(it);
+                const auto time = swar::load8(it + 11);
+                if ((date & date_seps) != UINT64_C(0x2d00002d00000000) ||
+                    (time & time_seps) != UINT64_C(0x00003a00003a0000)) {
+                    return false;
+                }
+                const auto date_digits =
+                    (date & ~date_seps) | (zeros & date_seps);
+                const auto time_digits =
+                    (time & ~time_seps) | (zeros & time_seps);
+                if (!swar::is_8_digits(date_digits) ||
+                    !swar::is_8_digits(time_digits) || !is_digit(it[8]) ||
+                    !is_digit(it[9]) ||
+                    (it[10] != 'T' && it[10] != 't' && it[10] != ' ')) {
+                    return false;
+                }
+                const auto d = swar::digit_pairs(date_digits);
+                const auto t = swar::digit_pairs(time_digits);
+                dt.year =
+                    static_cast<int>(swar::byte(d, 0) * 100 + swar::byte(d, 2));
+                dt.month = static_cast<int>(swar::byte(d, 5));
+                dt.day = digit(it[8]) * 10 + digit(it[9]);
+                dt.hour = static_cast<int>(swar::byte(t, 0));
+                dt.minute = static_cast<int>(swar::byte(t, 3));
+                dt.second = static_cast<int>(swar::byte(t, 6));
+                return true;
+            }
+            static bool _iso_prefix(const wchar_t*,
+                                    const wchar_t*,
+                                    date_time&)
+            {
+                return false;
+            }
+
+            static void _fraction8(const char*& it,
+                                   const char* end,
+                                   uint32_t& v,
+                                   int& n)
+            {
+                if (end - it >= 8) {
+                    const auto w = swar::load8(it);
+                    if (swar::is_8_digits(w)) {
+                        v = swar::parse_8_digits(w);
+                        n = 8;
+                        it += 8;
+                    }
+                }
+            }
+            static void _fraction8(const wchar_t*&,
+                                   const wchar_t*,
+                                   uint32_t&,
+                                   int&)
+            {
+            }
+
+            // Index of the English name (or its first three letters) at
+            // `it` in `names`, or -1
+            static int _name(iterator& it,
+                             iterator end,
+                             const char* const* names,
+                             int n)
+            {
+                for (int i = 0; i < n; ++i) {
+                    auto p = it;
+                    const char* name = names[i];
+                    int len = 0;
+                    for (; name[len] != '\0' && p != end &&
+                           to_lower(*p) == widen(name[len]);
+                         ++len, ++p) {
+                    }
+                    if (name[len] == '\0' || len == 3) {
+                        it = p;
+                        return i;
+                    }
+                }
+                return -1;
+            }
+            static bool _month_name(iterator& it, iterator end, int& month)
+            {
+                static const char* const names[] = {
+                    "january", "february", "march",     "april",
+                    "may",     "june",     "july",      "august",
+                    "september", "october", "november", "december"};
+                const auto i = _name(it, end, names, 12);
+                if (i < 0) {
+                    return false;
+                }
+                month = i + 1;
+                return true;
+            }
+            static bool _weekday_name(iterator& it, iterator end)
+            {
+                static const char* const names[] = {
+                    "sunday",   "monday", "tuesday", "wednesday",
+                    "thursday", "friday", "saturday"};
+                return _name(it, end, names, 7) >= 0;
+            }
+
+            // Seconds since the epoch
+            static bool _epoch(iterator& it, iterator end, date_time& dt)
+            {
+                auto p = it;
+                const bool minus = literal(p, end, '-');
+                if (p == end || !is_digit(*p)) {
+                    return false;
+                }
+                int64_t secs = 0;
+                for (int n = 0; p != end && is_digit(*p); ++p, ++n) {
+                    if (n == 12) {
+                        // past year 30000
+                        return false;
+                    }
+                    secs = secs * 10 + digit(*p);
+                }
+                if (minus) {
+                    secs = -secs;
+                }
+                const int64_t days =
+                    (secs >= 0 ? secs : secs - 86399) / 86400;
+                const auto rem = static_cast<int>(secs - days * 86400);
+                civil::from_days(days, dt);
+                dt.hour = rem / 3600;
+                dt.minute = rem / 60 % 60;
+                dt.second = rem % 60;
+                dt.utc_offset = 0;
+                dt.has_utc_offset = true;
+                it = p;
+                return true;
+            }
+
+            // Integer part and an optional fraction
+            static error _duration_number(iterator& it,
+                                          iterator end,
+                                          duration_value& val)
+            {
+                if (it == end || !is_digit(*it)) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected a duration");
+                }
+                uint64_t count = 0;
+                for (int n = 0; it != end && is_digit(*it); ++it, ++n) {
+                    if (n == 19) {
+                        return error(error::value_out_of_range,
+                                     "Duration out of range");
+                    }
+                    count =
+                        count * 10 + static_cast<uint64_t>(digit(*it));
+                }
+                val.count = count;
+                val.fraction = 0;
+                val.fraction_digits = 0;
+                auto p = it;
+                if (literal(p, end, '.') && p != end && is_digit(*p)) {
+                    for (; p != end && is_digit(*p); ++p) {
+                        if (val.fraction_digits < 18) {
+                            val.fraction =
+                                val.fraction * 10 +
+                                static_cast<uint64_t>(digit(*p));
+                            ++val.fraction_digits;
+                        }
+                    }
+                    it = p;
+                }
+                return {};
+            }
+
+            // Nanoseconds in the unit at `it`, or 0
+            static int64_t _unit(iterator& it, iterator end)
+            {
+                struct unit {
+                    const char* name;
+                    int64_t ns;
+                };
+                // a prefix of another unit after it
+                static constexpr unit units[] = {
+                    {"ns", 1},
+                    {"us", 1000},
+                    {"ms", 1000000},
+                    {"min", 60000000000},
+                    {"s", 1000000000},
+                    {"m", 60000000000},
+                    {"h", 3600000000000},
+                    {"d", 86400000000000}};
+                for (const auto& u : units) {
+                    auto p = it;
+                    const char* c = u.name;
+                    for (; *c != '\0' && p != end && *p == widen(*c);
+                         ++c, ++p) {
+                    }
+                    if (*c == '\0') {
+                        it = p;
+                        return u.ns;
+                    }
+                }
+                return 0;
+            }
+
+            static error _add_to_nanoseconds(duration_value& val,
+                                             int64_t unit)
+            {
+                static constexpr uint64_t pow10[] = {
+                    1,
+                    10,
+                    100,
+                    1000,
+                    10000,
+                    100000,
+                    1000000,
+                    10000000,
+                    100000000,
+                    1000000000,
+                    10000000000,
+                    100000000000,
+                    1000000000000,
+                    10000000000000,
+                    100000000000000,
+                    1000000000000000,
+                    10000000000000000,
+                    100000000000000000,
+                    1000000000000000000};
+                const auto max = static_cast<uint64_t>(INT64_MAX);
+                const auto uunit = static_cast<uint64_t>(unit);
+                if (val.count > max / uunit) {
+                    return error(error::value_out_of_range,
+                                 "Duration out of range");
+                }
+                // fraction < 10^digits, so this is less than `unit`
+                const auto frac = static_cast<uint64_t>(
+                    static_cast<long double>(val.fraction) *
+                    static_cast<long double>(uunit) /
+                    static_cast<long double>(pow10[val.fraction_digits]));
+                const auto n = val.count * uunit + frac;
+                const auto total = static_cast<uint64_t>(
+                    val.nanoseconds < 0 ? -val.nanoseconds : val.nanoseconds);
+                if (n < val.count * uunit || n > max - total) {
+                    return error(error::value_out_of_range,
+                                 "Duration out of range");
+                }
+                val.nanoseconds += static_cast<int64_t>(n);
+                return {};
+            }
+        };
+
+        template <typename CharT>
+        struct chrono_scanner_base {
+            static constexpr std::size_t max_pattern_size = 64;
+
+            template <typename ParseCtx>
+            error parse(ParseCtx& pctx)
+            {
+                using char_type = typename ParseCtx::char_type;
+                static_assert(std::is_same<char_type, CharT>::value, "");
+
+                pctx.arg_begin();
+                if (SCN_UNLIKELY(!pctx)) {
+                    return error(error::invalid_format_string,
+                                 "Unexpected format string end");
+                }
+                m_pattern_size = 0;
+                if (m_allow_pattern && pctx.next() == ascii_widen<CharT>('%')) {
+                    while (pctx && !pctx.check_arg_end()) {
+                        if (m_pattern_size == max_pattern_size) {
+                            return error(error::invalid_format_string,
+                                         "Date/time pattern too long");
+                        }
+                        m_pattern[m_pattern_size++] = pctx.next();
+                        pctx.advance();
+                    }
+                    if (!chrono_parser<CharT>::is_valid_pattern(pattern())) {
+                        return error(error::invalid_format_string,
+                                     "Invalid date/time pattern");
+                    }
+                }
+                if (!pctx || !pctx.check_arg_end()) {
+                    return error(error::invalid_format_string,
+                                 "Expected argument end");
+                }
+                pctx.arg_end();
+                return {};
+            }
+
+            basic_string_view<CharT> pattern() const
+            {
+                return {m_pattern, m_pattern_size};
+            }
+
+            CharT m_pattern[max_pattern_size]{};
+            std::size_t m_pattern_size{0};
+            bool m_allow_pattern{true};
+        };
+    }  // namespace detail
+
+    template <typename CharT>
+    struct scanner<CharT, date_time>
+        : public detail::chrono_scanner_base<CharT> {
+        template <typename Context>
+        error scan(date_time& val, Context& ctx)
+        {
+            using parser = detail::chrono_parser<CharT>;
+            auto parse = [&](const CharT* b, const CharT* end) {
+                if (this->m_pattern_size != 0) {
+                    return parser::pattern(b, end, this->pattern(), val);
+                }
+                return parser::iso(b, end, val);
+            };
+            return read_with_parser(ctx.range(), parse);
+        }
+    };
+
+    template <typename CharT, typename Duration>
+    struct scanner<
+        CharT,
+        std::chrono::time_point<std::chrono::system_clock, Duration>>
+        : public scanner<CharT, date_time> {
+        template <typename Context>
+        error scan(
+            std::chrono::time_point<std::chrono::system_clock, Duration>& val,
+            Context& ctx)
+        {
+            date_time dt{};
+            auto e = scanner<CharT, date_time>::scan(dt, ctx);
+            if (!e) {
+                return e;
+            }
+            auto tp = to_sys_time<Duration>(dt);
+            if (!tp) {
+                return tp.error();
+            }
+            val = tp.value();
+            return {};
+        }
+    };
+
+    template <typename CharT, typename Rep, typename Period>
+    struct scanner<CharT, std::chrono::duration<Rep, Period>>
+        : public detail::chrono_scanner_base<CharT> {
+        scanner()
+        {
+            this->m_allow_pattern = false;
+        }
+
+        template <typename Context>
+        error scan(std::chrono::duration<Rep, Period>& val, Context& ctx)
+        {
+            using parser = detail::chrono_parser<CharT>;
+            detail::duration_value v{};
+            auto parse = [&](const CharT* b, const CharT* end) {
+                return parser::duration(b, end, v);
+            };
+            auto e = read_with_parser(ctx.range(), parse);
+            if (!e) {
+                return e;
+            }
+            return _convert(v, val);
+        }
+
+    private:
+        using duration_type = std::chrono::duration<Rep, Period>;
+
+        static error _out_of_range()
+        {
+            return error(error::value_out_of_range, "Duration out of range");
+        }
+
+        static error _convert(const detail::duration_value& v,
+                              duration_type& val)
+        {
+            using std::chrono::duration_cast;
+            using ld_periods = std::chrono::duration<long double, Period>;
+            using ld_nanoseconds =
+                std::chrono::duration<long double, std::nano>;
+
+            if (v.bare && v.fraction_digits == 0 &&
+                std::is_integral<Rep>::value) {
+                SCN_GCC_PUSH
+                SCN_GCC_IGNORE("-Wsign-conversion")
+                SCN_GCC_IGNORE("-Wconversion")
+                const auto max = static_cast<uint64_t>(
+                    (std::numeric_limits<Rep>::max)());
+                const auto limit =
+                    !v.negative ? max
+                                : (std::is_signed<Rep>::value ? max + 1 : 0);
+                if (v.count > limit) {
+                    return _out_of_range();
+                }
+                const auto count =
+                    v.negative ? static_cast<Rep>(0 - v.count)
+                               : static_cast<Rep>(v.count);
+                SCN_GCC_POP
+                val = duration_type(count);
+                return {};
+            }
+
+            ld_periods periods{};
+            if (v.bare) {
+                auto n = static_cast<long double>(v.count);
+                if (v.fraction_digits != 0) {
+                    long double scale = 1;
+                    for (int i = 0; i < v.fraction_digits; ++i) {
+                        scale *= 10;
+                    }
+                    n += static_cast<long double>(v.fraction) / scale;
+                }
+                periods = ld_periods(v.negative ? -n : n);
+            }
+            else {
+                const auto ns = static_cast<long double>(v.nanoseconds);
+                periods = duration_cast<ld_periods>(
+                    ld_nanoseconds(v.negative ? -ns : ns));
+            }
+            const auto max = duration_cast<ld_periods>(duration_type::max());
+            const auto min = duration_cast<ld_periods>(duration_type::min());
+            if (periods > max || periods < min) {
+                return _out_of_range();
+            }
+            val = duration_cast<duration_type>(periods);
+            return {};
+        }
+    };
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_CHRONO_H
@@ -0,0 +1,353 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_COLUMNS_H
+#define SCN_DETAIL_COLUMNS_H
+
+#include "line_index.h"
+#include "lines.h"
+#include "tuple_return.h"
+
+#include <tuple>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup columns Columnar cache
+     *
+     * \ref scan_columns scans every line of a text file with the same format
+     * string, and returns the values as columns: one contiguous array per
+     * argument.
+     *
+     * The columns are saved into a binary cache file, laid out so that it can
+     * be used directly after mapping it into memory. Later calls with the
+     * same source file (same size and modification time), format string and
+     * column types map the cache, and don't parse anything.
+     */
+
+    /// @{
+
+    namespace detail {
+        struct columns_access;
+
+        template <typename T>
+        struct column_type_code {
+            static_assert(std::is_arithmetic<T>::value,
+                          "scan_columns only supports arithmetic types");
+
+            static constexpr char value =
+                std::is_same<T, bool>::value
+                    ? 'b'
+                    : std::is_floating_point<T>::value
+                          ? 'f'
+                          : std::is_unsigned<T>::value ? 'u' : 'i';
+        };
+
+        // The element type of a column while scanning: std::vector<bool>
+        // has no data(), so bools are gathered as bytes, which have the
+        // same representation
+        template <typename T>
+        struct column_storage {
+            using type = T;
+        };
+        template <>
+        struct column_storage<bool> {
+            static_assert(sizeof(bool) == 1,
+                          "scan_columns needs a single-byte bool");
+            using type = unsigned char;
+        };
+        template <typename T>
+        using column_storage_t = typename column_storage<T>::type;
+
+        template <typename... Ts>
+        std::string column_signature()
+        {
+            std::string sig;
+            const char codes[] = {column_type_code<Ts>::value...};
+            const std::size_t sizes[] = {sizeof(Ts)...};
+            for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+                sig += codes[i];
+                sig += std::to_string(sizes[i]);
+            }
+            return sig;
+        }
+    }  // namespace detail
+
+    /// Options for \ref scan_columns
+    struct column_cache_options {
+        /// Path of the cache file, defaults to the source path + `".scncol"`
+        std::string cache_path{};
+        /// Save the columns to the cache file, if they had to be scanned
+        bool save{true};
+        /// Line terminator of the source file
+        line_ending ending{line_ending::lf};
+    };
+
+    /**
+     * Columns of values of the types `Ts...`, returned by \ref scan_columns.
+     * Refers to either an owned buffer or a mapped cache file.
+     */
+    template <typename... Ts>
+    class columns {
+    public:
+        static_assert(sizeof...(Ts) > 0, "Have to have at least one column");
+
+        template <std::size_t I>
+        using column_type =
+            typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+        columns() = default;
+
+        columns(const columns&) = delete;
+        columns& operator=(const columns&) = delete;
+
+        columns(columns&&) noexcept = default;
+        columns& operator=(columns&&) noexcept = default;
+
+        ~columns() = default;
+
+        bool valid() const noexcept
+        {
+            return m_error && m_valid;
+        }
+
+        /// Why the columns are not `valid()`
+        ::scn::error error() const noexcept
+        {
+            return m_error;
+        }
+
+        /// Number of rows
+        std::size_t size() const noexcept
+        {
+            return m_rows;
+        }
+
+        /// `true`, if the columns were loaded from the cache file
+        bool from_cache() const noexcept
+        {
+            return m_map.valid();
+        }
+
+        /// The values of column `I`
+        template <std::size_t I>
+        span<const column_type<I>> column() const noexcept
+        {
+            static_assert(I < sizeof...(Ts), "Column index out of range");
+            return {static_cast<const column_type<I>*>(
+                        static_cast<const void*>(m_columns[I])),
+                    m_rows};
+        }
+
+    private:
+        friend struct detail::columns_access;
+
+        std::vector<unsigned char> m_buffer{};
+        detail::byte_mapped_file m_map{};
+        const unsigned char* m_columns[sizeof...(Ts)]{};
+        std::size_t m_rows{0};
+        ::scn::error m_error{};
+        bool m_valid{false};
+    };
+
+    namespace detail {
+        struct columns_access {
+            static uint64_t format_hash(string_view format,
+                                        const std::string& signature,
+                                        line_ending ending);
+
+            static std::string default_cache_path(const char* filename);
+
+            // Lays out the columns into out
+            static void encode(std::vector<unsigned char>& out,
+                               source_stamp stamp,
+                               uint64_t hash,
+                               uint64_t rows,
+                               std::size_t ncols,
+                               const void* const* cols,
+                               const std::size_t* elem_sizes);
+
+            // Checks that [data, data + size) contains columns matching
+            // stamp, hash and elem_sizes, and sets cols and rows if it does
+            static bool decode(const unsigned char* data,
+                               std::size_t size,
+                               source_stamp stamp,
+                               uint64_t hash,
+                               std::size_t ncols,
+                               const std::size_t* elem_sizes,
+                               const unsigned char** cols,
+                               uint64_t& rows);
+
+            // Replaces the cache file filename with data
+            static error save(const std::vector<unsigned char>& data,
+                              const char* filename);
+
+            // An empty file can't be mapped, but it's still a valid source
+            static bool is_empty_file(const char* filename);
+
+            template <typename Row, std::size_t... I>
+            static error scan_row(string_view line,
+                                  string_view format,
+                                  Row& row,
+                                  index_sequence<I...>)
+            {
+                return scan(line, format, std::get<I>(row)...).error();
+            }
+
+            template <typename Cols, typename Row, std::size_t... I>
+            static void push_row(Cols& cols,
+                                 const Row& row,
+                                 index_sequence<I...>)
+            {
+                using cols_type = typename std::decay<Cols>::type;
+                const int expand[] = {(
+                    std::get<I>(cols).push_back(
+                        static_cast<typename std::tuple_element<
+                            I, cols_type>::type::value_type>(
+                            std::get<I>(row))),
+                    0)...};
+                SCN_UNUSED(expand);
+            }
+
+            template <typename Cols, std::size_t... I>
+            static void column_pointers(const Cols& cols,
+                                        const void** ptrs,
+                                        index_sequence<I...>)
+            {
+                const int expand[] = {
+                    (ptrs[I] = std::get<I>(cols).data(), 0)...};
+                SCN_UNUSED(expand);
+            }
+
+            template <typename... Ts>
+            static columns<Ts...> build(const char* filename,
+                                        string_view format,
+                                        const column_cache_options& options)
+            {
+                using seq = index_sequence_for<Ts...>;
+                constexpr std::size_t ncols = sizeof...(Ts);
+                const std::size_t elem_sizes[] = {sizeof(Ts)...};
+
+                columns<Ts...> result;
+                mapped_file source{filename};
+                if (!source.valid() && !is_empty_file(filename)) {
+                    result.m_error =
+                        error(error::source_error, "Failed to map file");
+                    return result;
+                }
+
+                const auto stamp = get_source_stamp(filename);
+                const auto hash =
+                    format_hash(format, column_signature<Ts...>(),
+                                options.ending);
+                const auto path = options.cache_path.empty()
+                                      ? default_cache_path(filename)
+                                      : options.cache_path;
+                uint64_t rows{};
+
+                byte_mapped_file map{path.c_str()};
+                if (map.valid() &&
+                    decode(static_cast<const unsigned char*>(
+                               static_cast<const void*>(map.begin())),
+                           static_cast<std::size_t>(map.end() - map.begin()),
+                           stamp, hash, ncols, elem_sizes, result.m_columns,
+                           rows)) {
+                    result.m_map = std::move(map);
+                    result.m_rows = static_cast<std::size_t>(rows);
+                    result.m_valid = true;
+                    return result;
+                }
+
+                const auto text =
+                    source.valid() ? source.make_view() : string_view{""};
+                std::tuple<std::vector<column_storage_t<Ts>>...> cols;
+                std::tuple<Ts...> row;
+                for (auto line : lines(text, options.ending)) {
+                    if (line.size() == 0) {
+                        continue;
+                    }
+                    auto e = scan_row(line, format, row, seq{});
+                    if (!e) {
+                        result.m_error = e;
+                        return result;
+                    }
+                    push_row(cols, row, seq{});
+                }
+
+                const void* ptrs[ncols];
+                column_pointers(cols, ptrs, seq{});
+                rows = std::get<0>(cols).size();
+                encode(result.m_buffer, stamp, hash, rows, ncols, ptrs,
+                       elem_sizes);
+                const auto ok =
+                    decode(result.m_buffer.data(), result.m_buffer.size(),
+                           stamp, hash, ncols, elem_sizes, result.m_columns,
+                           rows);
+                SCN_ENSURE(ok);
+                SCN_UNUSED(ok);
+                result.m_rows = static_cast<std::size_t>(rows);
+                result.m_valid = true;
+
+                if (options.save) {
+                    save(result.m_buffer, path.c_str());
+                }
+                return result;
+            }
+        };
+    }  // namespace detail
+
+    /**
+     * Scans every non-empty line of the file `filename` with the format
+     * string `format` into a value of each of `Ts...`, and returns the
+     * values as \ref columns.
+     *
+     * If the cache file exists, and was created from the same version of the
+     * file, with the same format string and types, the columns are mapped
+     * from it instead, without parsing the source file.
+     * Otherwise, the columns are saved there, if `options.save` is `true`
+     * (a failure to save is ignored).
+     *
+     * Only arithmetic types are supported.
+     *
+     * \code{.cpp}
+     * auto cols = scn::scan_columns<int, double>("data.txt", "{} {}");
+     * for (auto v : cols.column<1>()) {
+     *     // ...
+     * }
+     * \endcode
+     */
+    template <typename... Ts>
+    columns<Ts...> scan_columns(
+        const char* filename,
+        string_view format,
+        const column_cache_options& options = column_cache_options{})
+    {
+        return detail::columns_access::build<Ts...>(filename, format,
+                                                    options);
+    }
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY && !defined(SCN_COLUMNS_CPP)
+#include "columns.cpp"
+#endif
+
+#endif  // SCN_DETAIL_COLUMNS_H
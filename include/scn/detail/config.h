@@ -107,6 +107,49 @@
 #define SCN_WINDOWS 0
 #endif
 
+// Detect architecture
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define SCN_X86 1
+#else
+#define SCN_X86 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define SCN_ARM64 1
+#else
+#define SCN_ARM64 0
+#endif
+
+#if defined(__arm__) || defined(_M_ARM)
+#define SCN_ARM32 1
+#else
+#define SCN_ARM32 0
+#endif
+
+// Detect whether vectorized kernels can be compiled for runtime dispatch.
+// On x86, functions are compiled for their target ISA with SCN_SIMD_TARGET,
+// without requiring -m flags for the whole translation unit.
+#if SCN_X86 && (SCN_GCC >= SCN_COMPILER(5, 0, 0) ||   \
+                SCN_CLANG >= SCN_COMPILER(3, 9, 0) || \
+                SCN_MSVC >= SCN_COMPILER(19, 10, 0))
+#define SCN_HAS_X86_SIMD 1
+#else
+#define SCN_HAS_X86_SIMD 0
+#endif
+
+#if SCN_ARM64 || (SCN_ARM32 && defined(__ARM_NEON))
+#define SCN_HAS_NEON 1
+#else
+#define SCN_HAS_NEON 0
+#endif
+
+#if SCN_HAS_X86_SIMD && !SCN_MSVC
+#define SCN_SIMD_TARGET(x) __attribute__((target(x)))
+#else
+#define SCN_SIMD_TARGET(x)
+#endif
+
 #ifdef _MSVC_LANG
 #define SCN_MSVC_LANG _MSVC_LANG
 #else
@@ -315,6 +358,15 @@
 #define SCN_HAS_LAUNDER 0
 #endif
 
+// Detect __int128
+#ifndef SCN_HAS_INT128
+#if defined(__SIZEOF_INT128__) && !SCN_MSVC
+#define SCN_HAS_INT128 1
+#else
+#define SCN_HAS_INT128 0
+#endif
+#endif
+
 // Detect __assume
 #if SCN_INTEL || SCN_MSVC
 #define SCN_HAS_ASSUME 1
@@ -21,6 +21,7 @@
 #include "args.h"
 #include "locale.h"
 #include "range.h"
+#include "scanset.h"
 
 namespace scn {
     SCN_BEGIN_NAMESPACE
@@ -80,8 +81,26 @@ namespace scn {
             return static_cast<const LocaleRef&>(*this);
         }
 
+        /**
+         * The delimiters ending the scanned values (see \ref
+         * with_delimiters), or `nullptr`, if values end at whitespace.
+         */
+        const basic_delimiters<char_type>* delimiters() const noexcept
+        {
+            return m_delimiters;
+        }
+        void set_delimiters(const basic_delimiters<char_type>* d) noexcept
+        {
+            m_delimiters = d;
+        }
+        bool is_delimiter(char_type ch) const noexcept
+        {
+            return m_delimiters && m_delimiters->is_delimiter(ch);
+        }
+
     private:
         range_type m_range;
+        const basic_delimiters<char_type>* m_delimiters{nullptr};
     };
 
     template <typename Context>
@@ -0,0 +1,517 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_CSV_H
+#define SCN_DETAIL_CSV_H
+
+#include "scan.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup csv CSV
+     *
+     * \ref csv reads the records of a CSV source (RFC 4180): fields are
+     * separated by a separator character (`,` by default), and records by
+     * newlines. A field can be quoted with `"`, and then contain separators,
+     * newlines, and quotes escaped by doubling them (`""`).
+     *
+     * On contiguous ranges, the separators, newlines and quotes are found a
+     * block of 64 characters at a time (see \ref simd), and the characters
+     * inside quotes are masked out with a prefix XOR of the positions of the
+     * quotes, so that there's no branch per character.
+     * The fields are `string_view`s into the source, except for quoted fields
+     * containing escaped quotes, which are unescaped into a buffer owned by
+     * the record.
+     * Other ranges, like \ref file, are read a record at a time into a
+     * buffer, which the fields point into.
+     */
+
+    /// @{
+
+    /// Dialect of a CSV source
+    struct csv_options {
+        /// Separates the fields of a record
+        char separator{','};
+        /// Begins and ends a quoted field
+        char quote{'"'};
+    };
+
+    namespace detail {
+        template <typename CharT>
+        struct csv_parser;
+    }  // namespace detail
+
+    /**
+     * The fields of a CSV record, as `string_view`s.
+     * The fields are valid until the next record is read, or the source is
+     * destroyed.
+     */
+    template <typename CharT>
+    class basic_csv_record {
+    public:
+        using char_type = CharT;
+        using string_view_type = basic_string_view<CharT>;
+        using iterator = const string_view_type*;
+        using error_type = ::scn::error;
+
+        /// Number of fields
+        std::size_t size() const noexcept
+        {
+            return m_fields.size();
+        }
+        bool empty() const noexcept
+        {
+            return m_fields.empty();
+        }
+
+        /// Field `i`, `i < size()`
+        const string_view_type& operator[](std::size_t i) const
+        {
+            SCN_EXPECT(i < size());
+            return m_fields[i];
+        }
+
+        iterator begin() const noexcept
+        {
+            return m_fields.data();
+        }
+        iterator end() const noexcept
+        {
+            return m_fields.data() + m_fields.size();
+        }
+
+        /**
+         * Scans field `i` into `val`.
+         * Strings and `string_view`s are assigned the whole field.
+         * Other types are scanned with their \ref scanner, with the default
+         * options (as with `"{}"`), and the whole field, apart from the
+         * whitespace around the value, has to be consumed.
+         * If `i >= size()`, returns an error with the code
+         * `error::end_of_range`.
+         */
+        template <typename T>
+        error_type scan_field(std::size_t i, T& val) const
+        {
+            if (i >= size()) {
+                return error_type(error_type::end_of_range,
+                                  "Not enough fields in a CSV record");
+            }
+            return detail::field_scanner::scan(m_fields[i], val);
+        }
+
+        /**
+         * Scans the first `sizeof...(Args)` fields into `a...`, one field
+         * per argument, as if by \ref scan_field.
+         * The fields after them are ignored.
+         */
+        template <typename... Args>
+        error_type scan(Args&... a) const
+        {
+            error_type e{};
+            std::size_t i = 0;
+            // Stops at the first error
+            int expand[] = {0, (e ? (e = scan_field(i++, a), 0) : 0)...};
+            SCN_UNUSED(expand);
+            return e;
+        }
+
+    private:
+        friend struct detail::csv_parser<CharT>;
+
+        std::vector<string_view_type> m_fields{};
+        // Unescaped quoted fields
+        std::basic_string<CharT> m_unescaped{};
+        // The fields in m_unescaped: their indices and offsets
+        std::vector<std::pair<std::size_t, std::size_t>> m_escaped{};
+    };
+
+    using csv_record = basic_csv_record<char>;
+    using wcsv_record = basic_csv_record<wchar_t>;
+
+    namespace detail {
+        template <typename CharT>
+        struct csv_parser {
+            using record_type = basic_csv_record<CharT>;
+            using string_view_type = basic_string_view<CharT>;
+
+            /**
+             * Parses the record at the beginning of `[begin, end)`, which
+             * must not be empty, into `rec`.
+             * A blank line is a record without fields.
+             * \return The end of the record, past its terminating newline
+             */
+            static expected<const CharT*> parse(const CharT* begin,
+                                                const CharT* end,
+                                                csv_options opt,
+                                                record_type& rec)
+            {
+                SCN_EXPECT(begin != end);
+                rec.m_fields.clear();
+                rec.m_unescaped.clear();
+                rec.m_escaped.clear();
+
+                const CharT quote = ascii_widen<CharT>(opt.quote);
+                const CharT chars[3] = {quote,
+                                        ascii_widen<CharT>(opt.separator),
+                                        ascii_widen<CharT>('\n')};
+                auto field_begin = begin;
+                // All ones, if the previous block ended inside quotes
+                uint64_t carry = 0;
+                // The field began in a previous block, and has quotes there
+                bool field_quoted = false;
+
+                for (auto block = begin; block != end;) {
+                    const auto n = end - block >= 64 ? 64 : end - block;
+                    uint64_t masks[3]{};
+                    match_masks(block, end, chars, masks);
+                    const auto in_quotes = prefix_xor(masks[0]) ^ carry;
+                    auto structural = (masks[1] | masks[2]) & ~in_quotes;
+                    // The quotes of the current field in this block
+                    auto quotes = masks[0];
+
+                    while (structural != 0) {
+                        const auto i = countr_zero(structural);
+                        const auto bit = uint64_t{1} << i;
+                        const auto at = block + i;
+                        const bool newline = (masks[2] & bit) != 0;
+                        const bool has_quotes =
+                            field_quoted || (quotes & (bit - 1)) != 0;
+
+                        auto e = _field(field_begin, at, has_quotes, newline,
+                                        quote, rec);
+                        if (!e) {
+                            return e;
+                        }
+                        if (newline) {
+                            _finish(rec);
+                            return at + 1;
+                        }
+                        field_begin = at + 1;
+                        field_quoted = false;
+                        // bit << 1 is 0 for the last bit: clears them all
+                        quotes &= ~((bit << 1) - 1);
+                        structural &= structural - 1;
+                    }
+
+                    field_quoted = field_quoted || quotes != 0;
+                    const auto last_bit = static_cast<unsigned>(n - 1);
+                    carry = ((in_quotes >> last_bit) & 1) != 0 ? ~uint64_t{0}
+                                                               : 0;
+                    block += n;
+                }
+
+                if (carry != 0) {
+                    return error(error::invalid_scanned_value,
+                                 "Unterminated quoted field in a CSV record");
+                }
+                auto e = _field(field_begin, end, field_quoted, true, quote,
+                                rec);
+                if (!e) {
+                    return e;
+                }
+                _finish(rec);
+                return end;
+            }
+
+        private:
+            static error _field(const CharT* b,
+                                const CharT* e,
+                                bool has_quotes,
+                                bool last,
+                                CharT quote,
+                                record_type& rec)
+            {
+                if (last && e != b && *(e - 1) == ascii_widen<CharT>('\r')) {
+                    // CRLF
+                    --e;
+                }
+                if (last && b == e && rec.m_fields.empty()) {
+                    // Blank line
+                    return {};
+                }
+                if (!has_quotes) {
+                    rec.m_fields.push_back(
+                        string_view_type{b, static_cast<size_t>(e - b)});
+                    return {};
+                }
+
+                if (e - b < 2 || *b != quote || *(e - 1) != quote) {
+                    return error(error::invalid_scanned_value,
+                                 "Quote in an unquoted CSV field, or "
+                                 "characters after a quoted one");
+                }
+                ++b;
+                --e;
+                auto q = find_until(b, e, quote);
+                if (q == e) {
+                    rec.m_fields.push_back(
+                        string_view_type{b, static_cast<size_t>(e - b)});
+                    return {};
+                }
+
+                // Escaped quotes: the contents are copied into m_unescaped,
+                // and the view is set in _finish
+                const auto offset = rec.m_unescaped.size();
+                while (true) {
+                    if (q + 1 == e || *(q + 1) != quote) {
+                        return error(error::invalid_scanned_value,
+                                     "Unescaped quote in a quoted CSV field");
+                    }
+                    rec.m_unescaped.append(b, q + 1);
+                    b = q + 2;
+                    q = find_until(b, e, quote);
+                    if (q == e) {
+                        rec.m_unescaped.append(b, e);
+                        break;
+                    }
+                }
+                rec.m_escaped.emplace_back(rec.m_fields.size(), offset);
+                rec.m_fields.push_back(string_view_type{
+                    nullptr, rec.m_unescaped.size() - offset});
+                return {};
+            }
+
+            static void _finish(record_type& rec)
+            {
+                for (const auto& f : rec.m_escaped) {
+                    auto& field = rec.m_fields[f.first];
+                    field = string_view_type{rec.m_unescaped.data() + f.second,
+                                             field.size()};
+                }
+            }
+        };
+    }  // namespace detail
+
+    /**
+     * An input range of the records of a CSV source, returned by \ref csv.
+     *
+     * Records are read lazily, one at a time, and the underlying range is
+     * advanced past every record read.
+     * Blank lines are skipped.
+     * If a record is malformed (like a quoted field without a closing quote),
+     * the iteration ends, and \ref error returns the error.
+     */
+    template <typename WrappedRange>
+    class csv_view {
+    public:
+        using range_type = WrappedRange;
+        using char_type = typename WrappedRange::char_type;
+        using record_type = basic_csv_record<char_type>;
+        using error_type = ::scn::error;
+
+        class iterator {
+        public:
+            using value_type = record_type;
+            using reference = const value_type&;
+            using pointer = const value_type*;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::input_iterator_tag;
+
+            iterator() = default;
+            explicit iterator(csv_view* v) : m_view(v) {}
+
+            reference operator*() const
+            {
+                SCN_EXPECT(m_view && m_view->m_has_record);
+                return m_view->m_record;
+            }
+            pointer operator->() const
+            {
+                return std::addressof(operator*());
+            }
+
+            iterator& operator++()
+            {
+                SCN_EXPECT(m_view);
+                m_view->_next();
+                return *this;
+            }
+            iterator operator++(int)
+            {
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+            bool operator==(const iterator& o) const
+            {
+                return _done() == o._done();
+            }
+            bool operator!=(const iterator& o) const
+            {
+                return !operator==(o);
+            }
+
+        private:
+            bool _done() const
+            {
+                return m_view == nullptr || !m_view->m_has_record;
+            }
+
+            csv_view* m_view{nullptr};
+        };
+
+        csv_view(WrappedRange r, csv_options opt)
+            : m_range(std::move(r)), m_options(opt)
+        {
+        }
+
+        /// Reads the first unread record, if there's no current record
+        iterator begin()
+        {
+            if (!m_has_record) {
+                _next();
+            }
+            return iterator{this};
+        }
+        iterator end() const
+        {
+            return {};
+        }
+
+        /// The error that ended the iteration, if any
+        error_type error() const noexcept
+        {
+            return m_error;
+        }
+
+        /// The unread rest of the underlying range
+        typename WrappedRange::return_type range() const
+        {
+            return m_range.range();
+        }
+
+    private:
+        using parser_type = detail::csv_parser<char_type>;
+
+        void _next()
+        {
+            m_has_record = false;
+            if (!m_error) {
+                return;
+            }
+            do {
+                auto e = _read(
+                    std::integral_constant<bool,
+                                           WrappedRange::is_contiguous>{});
+                if (!e) {
+                    if (e != error_type::end_of_range) {
+                        m_error = e;
+                    }
+                    return;
+                }
+            } while (m_record.empty());
+            m_has_record = true;
+        }
+
+        // The record is parsed in place
+        error_type _read(std::true_type)
+        {
+            if (m_range.begin() == m_range.end()) {
+                return error_type(error_type::end_of_range, "EOF");
+            }
+            const auto b = m_range.data();
+            auto ret = parser_type::parse(b, b + m_range.size(), m_options,
+                                          m_record);
+            if (!ret) {
+                return ret.error();
+            }
+            m_range.advance(ret.value() - b);
+            return {};
+        }
+        // The record is read into m_buffer, and parsed there
+        error_type _read(std::false_type)
+        {
+            const auto quote = detail::ascii_widen<char_type>(m_options.quote);
+            const auto newline = detail::ascii_widen<char_type>('\n');
+
+            m_buffer.clear();
+            bool in_quotes = false;
+            while (true) {
+                auto ch = read_char(m_range);
+                if (!ch) {
+                    if (ch.error() == error_type::end_of_range &&
+                        !m_buffer.empty()) {
+                        break;
+                    }
+                    return ch.error();
+                }
+                m_buffer.push_back(ch.value());
+                if (ch.value() == quote) {
+                    in_quotes = !in_quotes;
+                }
+                else if (ch.value() == newline && !in_quotes) {
+                    break;
+                }
+            }
+            const auto b = m_buffer.data();
+            auto ret = parser_type::parse(b, b + m_buffer.size(), m_options,
+                                          m_record);
+            if (!ret) {
+                return ret.error();
+            }
+            return {};
+        }
+
+        WrappedRange m_range;
+        csv_options m_options;
+        record_type m_record{};
+        std::basic_string<char_type> m_buffer{};
+        error_type m_error{};
+        bool m_has_record{false};
+    };
+
+    /**
+     * Returns a \ref csv_view over the records of `r`:
+     *
+     * \code{.cpp}
+     * auto records = scn::csv(source);
+     * for (const auto& rec : records) {
+     *     std::string name;
+     *     int age;
+     *     if (!rec.scan(name, age)) {
+     *         // invalid record
+     *     }
+     * }
+     * if (!records.error()) {
+     *     // malformed CSV
+     * }
+     * \endcode
+     *
+     * Unlike reading lines with `scn::getline`, and scanning them field by
+     * field, every record is read with a single pass over it, and nothing
+     * is allocated once the buffers of the record have grown large enough.
+     */
+    template <typename Range>
+    auto csv(Range&& r, csv_options opt = csv_options{})
+        -> csv_view<decltype(detail::wrap(std::forward<Range>(r)))>
+    {
+        return {detail::wrap(std::forward<Range>(r)), opt};
+    }
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_CSV_H
@@ -0,0 +1,380 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_DECIMAL_H
+#define SCN_DETAIL_DECIMAL_H
+
+#include "scan.h"
+
+#include <cstdint>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup decimal Fixed-point decimals
+     *
+     * \ref decimal is a decimal number with a fixed number of fractional
+     * digits, stored as a scaled 64-bit integer: `decimal<12, 4>` holds
+     * `-12345.6789` as `-123456789`. It's scanned from a decimal string
+     * (`[+-]digits[.digits]`) without going through floating point, so
+     * prices and other monetary values are exact.
+     *
+     * What's done with fractional digits after the `Scale` first ones is
+     * given with the format specifier:
+     *  - `{}`: an error (`error::value_out_of_range`), unless they're all
+     *    zeros
+     *  - `{:t}`: truncate, towards zero
+     *  - `{:r}`: round to the nearest, halves away from zero
+     *  - `{:e}`: round to the nearest, halves to even (banker's rounding)
+     *
+     * On `char` ranges, the digits are converted 8 at a time within a
+     * register (see \ref detail::swar).
+     */
+
+    /// @{
+
+    /**
+     * A decimal number with `Digits` significant digits, `Scale` of them
+     * after the decimal point.
+     */
+    template <int Digits, int Scale>
+    class decimal {
+    public:
+        static_assert(Digits > 0 && Digits <= 18,
+                      "decimal: Digits must be between 1 and 18");
+        static_assert(Scale >= 0 && Scale <= Digits,
+                      "decimal: Scale must be between 0 and Digits");
+
+        static constexpr int digits = Digits;
+        static constexpr int scale = Scale;
+
+        constexpr decimal() noexcept = default;
+
+        /// The decimal `v / 10^Scale`
+        static constexpr decimal from_scaled(int64_t v) noexcept
+        {
+            return decimal{v};
+        }
+        /// `10^Scale`
+        static constexpr int64_t scale_factor() noexcept
+        {
+            return _pow10(Scale);
+        }
+
+        /// The value multiplied by `10^Scale`
+        constexpr int64_t scaled() const noexcept
+        {
+            return m_value;
+        }
+        /// The digits before the decimal point, with the sign
+        constexpr int64_t integer_part() const noexcept
+        {
+            return m_value / scale_factor();
+        }
+        /// The digits after the decimal point, with the sign
+        constexpr int64_t fractional_part() const noexcept
+        {
+            return m_value % scale_factor();
+        }
+
+        friend constexpr bool operator==(decimal a, decimal b) noexcept
+        {
+            return a.m_value == b.m_value;
+        }
+        friend constexpr bool operator!=(decimal a, decimal b) noexcept
+        {
+            return a.m_value != b.m_value;
+        }
+        friend constexpr bool operator<(decimal a, decimal b) noexcept
+        {
+            return a.m_value < b.m_value;
+        }
+        friend constexpr bool operator>(decimal a, decimal b) noexcept
+        {
+            return a.m_value > b.m_value;
+        }
+        friend constexpr bool operator<=(decimal a, decimal b) noexcept
+        {
+            return a.m_value <= b.m_value;
+        }
+        friend constexpr bool operator>=(decimal a, decimal b) noexcept
+        {
+            return a.m_value >= b.m_value;
+        }
+
+    private:
+        constexpr explicit decimal(int64_t v) noexcept : m_value(v) {}
+
+        static constexpr int64_t _pow10(int n) noexcept
+        {
+            return n == 0 ? 1 : 10 * _pow10(n - 1);
+        }
+
+        int64_t m_value{0};
+    };
+
+    /// What to do with the fractional digits a \ref decimal can't hold
+    enum class decimal_rounding : unsigned char {
+        exact,
+        truncate,
+        half_away_from_zero,
+        half_even
+    };
+
+    namespace detail {
+        template <typename CharT>
+        struct decimal_parser {
+            using iterator = const CharT*;
+
+            /**
+             * Parses the decimal at `begin`, with at most `digits`
+             * significant digits, `scale` of them fractional, into `val`,
+             * multiplied by `10^scale`.
+             * Returns a pointer past the decimal.
+             */
+            static expected<iterator> parse(iterator begin,
+                                            iterator end,
+                                            int digits,
+                                            int scale,
+                                            decimal_rounding rounding,
+                                            int64_t& val)
+            {
+                auto it = begin;
+                bool negative = false;
+                if (it != end && (*it == ascii_widen<CharT>('-') ||
+                                  *it == ascii_widen<CharT>('+'))) {
+                    negative = *it == ascii_widen<CharT>('-');
+                    ++it;
+                }
+
+                const auto int_begin = it;
+                while (it != end && *it == ascii_widen<CharT>('0')) {
+                    ++it;
+                }
+                uint64_t value = 0;
+                read_digits(it, end, digits - scale, value);
+                if (it != end && is_digit(*it)) {
+                    return _out_of_range();
+                }
+                bool has_digits = it != int_begin;
+
+                // the first `scale` fractional digits, then the first of
+                // the rest, and whether any of the others isn't a zero
+                int excess = 0;
+                bool sticky = false;
+                if (it != end && *it == ascii_widen<CharT>('.')) {
+                    const auto frac_begin = ++it;
+                    uint64_t frac = 0;
+                    const auto n = read_digits(it, end, scale, frac);
+                    value = value * pow10(scale) + frac * pow10(scale - n);
+                    if (it != end && is_digit(*it)) {
+                        excess =
+                            static_cast<int>(*it - ascii_widen<CharT>('0'));
+                        sticky = skip_digits(++it, end);
+                    }
+                    has_digits = has_digits || it != frac_begin;
+                }
+                else {
+                    value *= pow10(scale);
+                }
+                if (!has_digits) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected a decimal number");
+                }
+
+                if (rounding == decimal_rounding::exact) {
+                    if (excess != 0 || sticky) {
+                        return error(error::value_out_of_range,
+                                     "Too many fractional digits");
+                    }
+                }
+                else if (rounding == decimal_rounding::half_away_from_zero) {
+                    value += excess >= 5 ? 1 : 0;
+                }
+                else if (rounding == decimal_rounding::half_even) {
+                    const bool odd = (value & 1) != 0;
+                    value += excess > 5 || (excess == 5 && (sticky || odd))
+                                 ? 1
+                                 : 0;
+                }
+                if (value >= pow10(digits)) {
+                    return _out_of_range();
+                }
+                val = negative ? -static_cast<int64_t>(value)
+                               : static_cast<int64_t>(value);
+                return it;
+            }
+
+            /// Reads at most `max` digits into `v`, returns their number
+            static int read_digits(iterator& it,
+                                   iterator end,
+                                   int max,
+                                   uint64_t& v)
+            {
+                int n = 0;
+                _read_digits8(it, end, max, v, n);
+                for (; n < max && it != end && is_digit(*it); ++it, ++n) {
+                    v = v * 10 +
+                        static_cast<uint64_t>(*it - ascii_widen<CharT>('0'));
+                }
+                return n;
+            }
+            /// Skips digits, returns whether any of them wasn't a zero
+            static bool skip_digits(iterator& it, iterator end)
+            {
+                bool nonzero = _skip_digits8(it, end);
+                for (; it != end && is_digit(*it); ++it) {
+                    nonzero = nonzero || *it != ascii_widen<CharT>('0');
+                }
+                return nonzero;
+            }
+
+            static uint64_t pow10(int n)
+            {
+                static const uint64_t table[] = {
+                    UINT64_C(1),
+                    UINT64_C(10),
+                    UINT64_C(100),
+                    UINT64_C(1000),
+                    UINT64_C(10000),
+                    UINT64_C(100000),
+                    UINT64_C(1000000),
+                    UINT64_C(10000000),
+                    UINT64_C(100000000),
+                    UINT64_C(1000000000),
+                    UINT64_C(10000000000),
+                    UINT64_C(100000000000),
+                    UINT64_C(1000000000000),
+                    UINT64_C(10000000000000),
+                    UINT64_C(100000000000000),
+                    UINT64_C(1000000000000000),
+                    UINT64_C(10000000000000000),
+                    UINT64_C(100000000000000000),
+                    UINT64_C(1000000000000000000)};
+                return table[n];
+            }
+
+        private:
+            static error _out_of_range()
+            {
+                return error(error::value_out_of_range,
+                             "Out of range: too many digits before the "
+                             "decimal point");
+            }
+
+            static void _read_digits8(const char*& it,
+                                      const char* end,
+                                      int max,
+                                      uint64_t& v,
+                                      int& n)
+            {
+                for (; max - n >= 8 && end - it >= 8; it += 8, n += 8) {
+                    const auto w = swar::load8(it);
+                    if (!swar::is_8_digits(w)) {
+                        break;
+                    }
+                    v = v * 100000000 + swar::parse_8_digits(w);
+                }
+            }
+            static void _read_digits8(const wchar_t*&,
+                                      const wchar_t*,
+                                      int,
+                                      uint64_t&,
+                                      int&)
+            {
+            }
+
+            static bool _skip_digits8(const char*& it, const char* end)
+            {
+                bool nonzero = false;
+                for (; end - it >= 8; it += 8) {
+                    const auto w = swar::load8(it);
+                    if (!swar::is_8_digits(w)) {
+                        break;
+                    }
+                    nonzero = nonzero || w != UINT64_C(0x3030303030303030);
+                }
+                return nonzero;
+            }
+            static bool _skip_digits8(const wchar_t*&, const wchar_t*)
+            {
+                return false;
+            }
+        };
+    }  // namespace detail
+
+    template <typename CharT, int Digits, int Scale>
+    struct scanner<CharT, decimal<Digits, Scale>> {
+        template <typename ParseCtx>
+        error parse(ParseCtx& pctx)
+        {
+            pctx.arg_begin();
+            if (SCN_UNLIKELY(!pctx)) {
+                return error(error::invalid_format_string,
+                             "Unexpected format string end");
+            }
+            if (!pctx.check_arg_end()) {
+                const auto ch = pctx.next();
+                if (ch == detail::ascii_widen<CharT>('t')) {
+                    rounding = decimal_rounding::truncate;
+                }
+                else if (ch == detail::ascii_widen<CharT>('r')) {
+                    rounding = decimal_rounding::half_away_from_zero;
+                }
+                else if (ch == detail::ascii_widen<CharT>('e')) {
+                    rounding = decimal_rounding::half_even;
+                }
+                else {
+                    return error(error::invalid_format_string,
+                                 "Invalid decimal rounding");
+                }
+                pctx.advance();
+            }
+            if (!pctx || !pctx.check_arg_end()) {
+                return error(error::invalid_format_string,
+                             "Expected argument end");
+            }
+            pctx.arg_end();
+            return {};
+        }
+
+        template <typename Context>
+        error scan(decimal<Digits, Scale>& val, Context& ctx)
+        {
+            int64_t tmp{};
+            auto e = read_with_parser(
+                ctx.range(), [&](const CharT* b, const CharT* end) {
+                    return detail::decimal_parser<CharT>::parse(
+                        b, end, Digits, Scale, rounding, tmp);
+                });
+            if (!e) {
+                return e;
+            }
+            val = decimal<Digits, Scale>::from_scaled(tmp);
+            return {};
+        }
+
+        decimal_rounding rounding{decimal_rounding::exact};
+    };
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_DECIMAL_H
@@ -0,0 +1,353 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_ENUM_H
+#define SCN_DETAIL_ENUM_H
+
+#include "scan.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup enum Enumerations
+     *
+     * An enumeration can be scanned by its enumerator names, after
+     * registering them by specializing \ref enum_names:
+     *
+     * \code{.cpp}
+     * enum class color { red, green, blue };
+     *
+     * template <>
+     * struct scn::enum_names<color> {
+     *     static scn::span<const scn::enum_entry<color>> entries()
+     *     {
+     *         static const scn::enum_entry<color> e[] = {
+     *             {"red", color::red},
+     *             {"green", color::green},
+     *             {"blue", color::blue}};
+     *         return {std::begin(e), std::end(e)};
+     *     }
+     *     // optional, defaults to false
+     *     static constexpr bool case_insensitive = true;
+     * };
+     *
+     * color c;
+     * scn::scan("green", "{}", c);
+     * \endcode
+     *
+     * A word is read, as with a string, and looked up from a perfect hash
+     * table of the names, built the first time an enumeration is scanned:
+     * a name is found with a single hash and comparison, however many
+     * enumerators there are.
+     *
+     * Format string: `{}` or `{:i}`, where `i` makes the matching
+     * case-insensitive (ASCII only).
+     * Names are ASCII, and can be scanned from wide ranges, too.
+     */
+
+    /// @{
+
+    /// A name of an enumerator, see \ref enum_names
+    template <typename T>
+    struct enum_entry {
+        const char* name;
+        T value;
+    };
+
+    /**
+     * Specialize to make `T` scannable by its enumerator names, with a static
+     * member function `entries()`, returning a
+     * `span<const enum_entry<T>>`, and optionally a
+     * `static constexpr bool case_insensitive`.
+     * If a name appears more than once, the first one is used.
+     */
+    template <typename T, typename Enable = void>
+    struct enum_names {
+    };
+
+    /// @}
+
+    namespace detail {
+        template <typename T, typename = void>
+        struct has_enum_names : std::false_type {
+        };
+        template <typename T>
+        struct has_enum_names<T, void_t<decltype(enum_names<T>::entries())>>
+            : std::true_type {
+        };
+
+        template <typename T, typename = void>
+        struct enum_names_case_insensitive : std::false_type {
+        };
+        template <typename T>
+        struct enum_names_case_insensitive<
+            T,
+            void_t<decltype(enum_names<T>::case_insensitive)>>
+            : std::integral_constant<bool, enum_names<T>::case_insensitive> {
+        };
+
+        // Registered unscoped enums are scanned by name, not as an int
+        template <typename T, typename Char>
+        struct convert_to_int<
+            T,
+            Char,
+            typename std::enable_if<has_enum_names<T>::value>::type>
+            : std::false_type {
+        };
+
+        template <typename CharT>
+        constexpr uint32_t enum_fold(CharT ch, bool icase) noexcept
+        {
+            return (icase && ch >= ascii_widen<CharT>('A') &&
+                    ch <= ascii_widen<CharT>('Z'))
+                       ? static_cast<uint32_t>(ch) + 32
+                       : static_cast<uint32_t>(ch);
+        }
+
+        /**
+         * Perfect hash table of the names of the enumeration `T`:
+         * the seed of the hash function is chosen so that no two names
+         * end up in the same slot.
+         * If no seed is found in `max_tries` tries, over a few table sizes,
+         * the names are looked up one at a time instead.
+         */
+        template <typename T>
+        class enum_table {
+        public:
+            explicit enum_table(bool icase, uint32_t max_tries = 256)
+                : m_icase(icase)
+            {
+                const auto entries = enum_names<T>::entries();
+                std::vector<const enum_entry<T>*> unique;
+                for (const auto& e : entries) {
+                    const auto len = std::strlen(e.name);
+                    const bool dup = std::any_of(
+                        unique.begin(), unique.end(),
+                        [&](const enum_entry<T>* u) {
+                            return std::strlen(u->name) == len &&
+                                   _equal(u->name, e.name, len);
+                        });
+                    if (!dup) {
+                        unique.push_back(&e);
+                        m_min_len = (std::min)(m_min_len, len);
+                        m_max_len = (std::max)(m_max_len, len);
+                    }
+                }
+
+                std::size_t size = 1;
+                while (size < unique.size() * 2) {
+                    size *= 2;
+                }
+                // a few tries for every table size,
+                // before trying a larger one
+                for (uint32_t tries = 0; tries < max_tries; size *= 2) {
+                    for (uint32_t seed = 1; seed <= 64 && tries < max_tries;
+                         ++seed, ++tries) {
+                        if (_build(unique, size, seed)) {
+                            return;
+                        }
+                    }
+                }
+
+                m_linear = true;
+                m_slots.resize(unique.size());
+                for (std::size_t i = 0; i < unique.size(); ++i) {
+                    m_slots[i].entry = unique[i];
+                    m_slots[i].len = std::strlen(unique[i]->name);
+                }
+            }
+
+            /// The entry named `s`, or `nullptr`
+            template <typename CharT>
+            const enum_entry<T>* find(const CharT* s, std::size_t n) const
+            {
+                if (n < m_min_len || n > m_max_len) {
+                    return nullptr;
+                }
+                if (SCN_UNLIKELY(m_linear)) {
+                    for (const auto& sl : m_slots) {
+                        if (sl.len == n && _equal(sl.entry->name, s, n)) {
+                            return sl.entry;
+                        }
+                    }
+                    return nullptr;
+                }
+                const auto& sl = m_slots[_hash(m_seed, s, n, m_icase) & m_mask];
+                if (sl.entry && sl.len == n && _equal(sl.entry->name, s, n)) {
+                    return sl.entry;
+                }
+                return nullptr;
+            }
+
+        private:
+            struct slot {
+                const enum_entry<T>* entry{nullptr};
+                std::size_t len{0};
+            };
+
+            template <typename CharT>
+            static uint32_t _hash(uint32_t seed,
+                                  const CharT* s,
+                                  std::size_t n,
+                                  bool icase) noexcept
+            {
+                auto h = seed * 0x9e3779b9u ^ static_cast<uint32_t>(n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    h = (h ^ enum_fold(s[i], icase)) * 0x01000193u;
+                }
+                return h ^ (h >> 15);
+            }
+
+            template <typename CharT>
+            bool _equal(const char* name, const CharT* s, std::size_t n) const
+            {
+                for (std::size_t i = 0; i < n; ++i) {
+                    if (enum_fold(static_cast<CharT>(name[i]), m_icase) !=
+                        enum_fold(s[i], m_icase)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            bool _build(const std::vector<const enum_entry<T>*>& entries,
+                        std::size_t size,
+                        uint32_t seed)
+            {
+                m_slots.assign(size, slot{});
+                m_mask = size - 1;
+                m_seed = seed;
+                for (auto e : entries) {
+                    const auto len = std::strlen(e->name);
+                    auto& sl = m_slots[_hash(seed, e->name, len, m_icase) &
+                                       m_mask];
+                    if (sl.entry) {
+                        return false;
+                    }
+                    sl.entry = e;
+                    sl.len = len;
+                }
+                return true;
+            }
+
+            std::vector<slot> m_slots{};
+            std::size_t m_mask{0};
+            std::size_t m_min_len{static_cast<std::size_t>(-1)};
+            std::size_t m_max_len{0};
+            uint32_t m_seed{0};
+            bool m_icase;
+            bool m_linear{false};
+        };
+
+        SCN_CLANG_PUSH
+        SCN_CLANG_IGNORE("-Wexit-time-destructors")
+        template <typename T>
+        const enum_table<T>& get_enum_table(bool icase)
+        {
+            if (icase) {
+                static const enum_table<T> icase_table{true};
+                return icase_table;
+            }
+            static const enum_table<T> table{false};
+            return table;
+        }
+        SCN_CLANG_POP
+
+        template <typename T>
+        struct enum_scanner {
+            template <typename ParseCtx>
+            error parse(ParseCtx& pctx)
+            {
+                using char_type = typename ParseCtx::char_type;
+
+                pctx.arg_begin();
+                if (SCN_UNLIKELY(!pctx)) {
+                    return error(error::invalid_format_string,
+                                 "Unexpected format string end");
+                }
+                if (pctx.next() == ascii_widen<char_type>('i')) {
+                    case_insensitive = true;
+                    pctx.advance();
+                }
+                if (!pctx.check_arg_end()) {
+                    return error(error::invalid_format_string,
+                                 "Expected argument end");
+                }
+                pctx.arg_end();
+                return {};
+            }
+
+            template <typename Context>
+            error scan(T& val, Context& ctx)
+            {
+                using char_type = typename Context::char_type;
+
+                auto is_space_pred = [&ctx](char_type ch) {
+                    return ctx.locale().is_space(ch) || ctx.is_delimiter(ch);
+                };
+                const auto& table = get_enum_table<T>(case_insensitive);
+
+                const enum_entry<T>* e = nullptr;
+                if (Context::range_type::is_contiguous) {
+                    auto s = read_until_space_zero_copy(ctx.range(),
+                                                        is_space_pred, false);
+                    if (!s) {
+                        return s.error();
+                    }
+                    e = table.find(s.value().data(), s.value().size());
+                }
+                else {
+                    small_vector<char_type, 32> tmp;
+                    auto outputit = std::back_inserter(tmp);
+                    auto ret = read_until_space(ctx.range(), outputit,
+                                                is_space_pred, false);
+                    if (SCN_UNLIKELY(!ret)) {
+                        return ret;
+                    }
+                    e = table.find(tmp.data(), tmp.size());
+                }
+
+                if (!e) {
+                    return error(error::invalid_scanned_value,
+                                 "Unknown enumerator name");
+                }
+                val = e->value;
+                return {};
+            }
+
+            bool case_insensitive{enum_names_case_insensitive<T>::value};
+        };
+    }  // namespace detail
+
+    template <typename CharT, typename T>
+    struct scanner<
+        CharT,
+        T,
+        typename std::enable_if<detail::has_enum_names<T>::value>::type>
+        : public detail::enum_scanner<T> {
+    };
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_ENUM_H
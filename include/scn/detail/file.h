@@ -65,7 +65,6 @@ namespace scn {
                 o.m_end = nullptr;
 
                 SCN_ENSURE(!o.valid());
-                SCN_ENSURE(valid());
             }
             byte_mapped_file& operator=(byte_mapped_file&& o) noexcept
             {
@@ -81,7 +80,6 @@ namespace scn {
                 o.m_end = nullptr;
 
                 SCN_ENSURE(!o.valid());
-                SCN_ENSURE(valid());
                 return *this;
             }
 
@@ -132,6 +130,15 @@ namespace scn {
         {
             return reinterpret_cast<sentinel>(byte_mapped_file::end());
         }
+
+        basic_string_view<CharT> make_view() const
+        {
+            return {begin(), end()};
+        }
+        detail::range_wrapper<basic_string_view<CharT>> wrap() const
+        {
+            return {make_view()};
+        }
     };
 
     using mapped_file = basic_mapped_file<char>;
@@ -193,6 +200,9 @@ namespace scn {
             bool sync(F sync_fn)
             {
                 if (n == 0) {
+                    // nothing to put back: drop the history, but keep the
+                    // capacity, so that the cache doesn't grow without bound
+                    buffer.clear();
                     return true;
                 }
                 auto s = span<char_type>(std::addressof(*(buffer.end() - n)),
@@ -0,0 +1,320 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_FIXED_H
+#define SCN_DETAIL_FIXED_H
+
+#include "scan.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup fixed Fixed-width records
+     *
+     * In a fixed-width record, every field is at a fixed position, instead of
+     * being separated from the other fields by whitespace or a separator.
+     * Values shorter than their field are padded with spaces, numbers usually
+     * on the left (right-aligned), and text on the right.
+     *
+     * A \ref fixed_layout lists the positions and widths of the fields, and
+     * \ref scan_fixed scans the fields of a record into values, one field per
+     * value. A field is a slice of the record, without any searching, and
+     * the padding around the value is trimmed. Integers and floating-point
+     * numbers are then converted directly from the slice.
+     *
+     * \code{.cpp}
+     * // ACCOUNT   AMOUNT  QTY
+     * // AB12     1234.50   10
+     * auto layout = scn::fixed_layout{}.add(8).add(10).add(5);
+     * std::string account;
+     * double amount{};
+     * int qty{};
+     * auto e = scn::scan_fixed(line, layout, account, amount, qty);
+     * \endcode
+     */
+
+    /// @{
+
+    /// Position of a field in a fixed-width record
+    struct fixed_field {
+        fixed_field() = default;
+        constexpr fixed_field(std::size_t o, std::size_t w)
+            : offset(o), width(w)
+        {
+        }
+
+        /// Offset of the first character of the field, from the beginning of
+        /// the record
+        std::size_t offset{0};
+        /// Number of characters in the field
+        std::size_t width{0};
+    };
+
+    /// Positions of the fields of a fixed-width record
+    class fixed_layout {
+    public:
+        fixed_layout() = default;
+        /// The fields `{offset, width}` in the order they're scanned in
+        fixed_layout(std::initializer_list<fixed_field> fields)
+            : m_fields(fields)
+        {
+        }
+
+        /// Adds a field of `width` characters right after the previous one
+        fixed_layout& add(std::size_t width)
+        {
+            const auto offset =
+                m_fields.empty() ? 0 : m_fields.back().offset +
+                                           m_fields.back().width;
+            m_fields.emplace_back(offset, width);
+            return *this;
+        }
+        /// Adds a field of `width` characters at `offset`
+        fixed_layout& add(std::size_t offset, std::size_t width)
+        {
+            m_fields.emplace_back(offset, width);
+            return *this;
+        }
+
+        /// Number of fields
+        std::size_t size() const noexcept
+        {
+            return m_fields.size();
+        }
+        bool empty() const noexcept
+        {
+            return m_fields.empty();
+        }
+        const fixed_field& operator[](std::size_t i) const
+        {
+            SCN_EXPECT(i < size());
+            return m_fields[i];
+        }
+
+        /// Offset of the end of the field ending the farthest
+        std::size_t record_width() const noexcept
+        {
+            std::size_t w = 0;
+            for (const auto& f : m_fields) {
+                w = (std::max)(w, f.offset + f.width);
+            }
+            return w;
+        }
+
+    private:
+        std::vector<fixed_field> m_fields{};
+    };
+
+    namespace detail {
+        /// Scans the fields of fixed-width records
+        struct fixed_field_scanner {
+            // Field `f` of `record`, without the padding,
+            // clipped to the end of the record
+            template <typename CharT>
+            static basic_string_view<CharT> slice(
+                basic_string_view<CharT> record,
+                const fixed_field& f)
+            {
+                if (f.offset >= record.size()) {
+                    return {};
+                }
+                const auto space = ascii_widen<CharT>(' ');
+                auto b = record.data() + f.offset;
+                auto e = b + (std::min)(f.width, record.size() - f.offset);
+                while (b != e && *b == space) {
+                    ++b;
+                }
+                while (b != e && *(e - 1) == space) {
+                    --e;
+                }
+                return {b, static_cast<std::size_t>(e - b)};
+            }
+
+            template <typename CharT, typename T>
+            static error scan(basic_string_view<CharT> record,
+                              const fixed_field& f,
+                              T& val)
+            {
+                if (f.offset >= record.size() && f.width != 0) {
+                    return error(error::end_of_range,
+                                 "Fixed-width record too short for a field");
+                }
+                return _scan(slice(record, f), val,
+                             dispatch_tag<T>{});
+            }
+
+        private:
+            struct integer_tag {
+            };
+            struct float_tag {
+            };
+            struct other_tag {
+            };
+
+            // The types scanned with integer_scanner and float_scanner,
+            // without instantiating scanner<CharT, T> for the other types
+            template <typename T>
+            struct is_scanned_integer
+                : std::integral_constant<
+                      bool,
+                      detail::is_integer<T>::value &&
+                          sizeof(T) >= sizeof(short) &&
+                          !std::is_same<T, wchar_t>::value &&
+                          !std::is_same<T, char16_t>::value &&
+                          !std::is_same<T, char32_t>::value> {
+            };
+
+            template <typename T>
+            using dispatch_tag = typename std::conditional<
+                is_scanned_integer<T>::value,
+                integer_tag,
+                typename std::conditional<std::is_floating_point<T>::value,
+                                          float_tag,
+                                          other_tag>::type>::type;
+
+            static error _leftover()
+            {
+                return error(error::invalid_scanned_value,
+                             "Unexpected characters after the value of a "
+                             "fixed-width field");
+            }
+
+            // Integers are always decimal: a zero-padded field isn't octal
+            template <typename CharT, typename T>
+            static error _scan(basic_string_view<CharT> field,
+                               T& val,
+                               integer_tag)
+            {
+                if (field.empty()) {
+                    return error(error::invalid_scanned_value,
+                                 "Empty fixed-width integer field");
+                }
+                scanner<CharT, T> s{};
+                s.base = 10;
+                T tmp{};
+                auto ret = s._parse_int(
+                    tmp, make_span(field.data(), field.size()).as_const(),
+                    ascii_widen<CharT>('\0'));
+                if (!ret) {
+                    return ret.error();
+                }
+                if (static_cast<std::size_t>(ret.value()) != field.size()) {
+                    return _leftover();
+                }
+                val = tmp;
+                return {};
+            }
+            template <typename CharT, typename T>
+            static error _scan(basic_string_view<CharT> field,
+                               T& val,
+                               float_tag)
+            {
+                if (field.empty()) {
+                    return error(error::invalid_scanned_value,
+                                 "Empty fixed-width floating-point field");
+                }
+                scanner<CharT, T> s{};
+                T tmp{};
+                auto ret = s._read_float(
+                    tmp, make_span(field.data(), field.size()).as_const());
+                if (!ret) {
+                    return ret.error();
+                }
+                if (static_cast<std::size_t>(ret.value()) != field.size()) {
+                    return _leftover();
+                }
+                val = tmp;
+                return {};
+            }
+            // Strings get the field without the padding,
+            // everything else is scanned as a whole field
+            template <typename CharT, typename T>
+            static error _scan(basic_string_view<CharT> field,
+                               T& val,
+                               other_tag)
+            {
+                return field_scanner::scan(field, val);
+            }
+        };
+
+        template <typename CharT, typename... Args>
+        error scan_fixed_impl(basic_string_view<CharT> record,
+                              const fixed_layout& layout,
+                              Args&... a)
+        {
+            if (layout.size() < sizeof...(Args)) {
+                return error(error::invalid_argument,
+                             "Fewer fields in a fixed-width layout than "
+                             "values to scan");
+            }
+            error e{};
+            std::size_t i = 0;
+            // Stops at the first error
+            int expand[] = {
+                0, (e ? (e = fixed_field_scanner::scan(record, layout[i++], a),
+                         0)
+                      : 0)...};
+            SCN_UNUSED(expand);
+            return e;
+        }
+    }  // namespace detail
+
+    /**
+     * Scans the fields of the fixed-width record `record` into `a...`, one
+     * field per argument, in the order of the fields in `layout`.
+     * `record` is a contiguous range, like a `string_view` of a line.
+     *
+     * Spaces padding the value in a field on either side are ignored.
+     * Integers are always decimal, so that zero-padded numbers aren't
+     * octal, and the whole field has to be a number.
+     * Strings and `string_view`s are assigned the field, without the
+     * padding. Other types are scanned with their \ref scanner, as in
+     * `basic_csv_record::scan_field`.
+     *
+     * A record shorter than `layout.record_width()` is accepted, if every
+     * field starts within it, so trailing padding can be left out.
+     * Otherwise, returns an error with the code `error::end_of_range`.
+     */
+    template <typename Range, typename... Args>
+    error scan_fixed(const Range& record,
+                     const fixed_layout& layout,
+                     Args&... a)
+    {
+        static_assert(sizeof...(Args) > 0,
+                      "Have to scan at least a single argument");
+        using char_type = typename std::remove_const<
+            typename std::remove_pointer<decltype(detail::ranges::data(
+                record))>::type>::type;
+        return detail::scan_fixed_impl(
+            basic_string_view<char_type>{
+                detail::ranges::data(record),
+                static_cast<std::size_t>(detail::ranges::size(record))},
+            layout, a...);
+    }
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_FIXED_H
@@ -0,0 +1,189 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_FOLLOW_H
+#define SCN_DETAIL_FOLLOW_H
+
+#include "lines.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup follow Following growing files
+     *
+     * \ref file_follower reads the lines appended to a file (like a log file)
+     * since the previous poll, like `tail -f`. Only the appended bytes are
+     * read, and an incomplete final line is kept until the rest of it is
+     * appended.
+     *
+     * The position in the file is a \ref follow_checkpoint, which can be
+     * saved, so that a restarted process resumes where it left off.
+     */
+
+    /// @{
+
+    /// Position of a \ref file_follower
+    struct follow_checkpoint {
+        /// Offset of the first byte not yet passed on as a part of a line
+        uint64_t offset{0};
+        /// Identity of the file (inode number, or file index on Windows),
+        /// or 0, if not known
+        uint64_t file_id{0};
+    };
+
+    /// Writes `cp` into the file `filename`
+    error save_follow_checkpoint(const follow_checkpoint& cp,
+                                 const char* filename);
+    /// Reads a checkpoint written with \ref save_follow_checkpoint
+    expected<follow_checkpoint> load_follow_checkpoint(const char* filename);
+
+    /**
+     * Reads the lines appended to a file.
+     *
+     * If the file shrinks, it's assumed to have been truncated, and it's
+     * read again from the beginning. If the file at the path is replaced
+     * (rotated), the new file is opened, once the old one has been read to
+     * the end.
+     */
+    class file_follower {
+    public:
+        file_follower() = default;
+        /**
+         * Opens the file `filename`, to be read from `cp`.
+         * If `cp` has a `file_id` not matching the file, it's read from the
+         * beginning instead.
+         */
+        explicit file_follower(const char* filename,
+                               follow_checkpoint cp = follow_checkpoint{});
+
+        file_follower(const file_follower&) = delete;
+        file_follower& operator=(const file_follower&) = delete;
+
+        file_follower(file_follower&& o) noexcept;
+        file_follower& operator=(file_follower&& o) noexcept;
+
+        ~file_follower();
+
+        bool valid() const noexcept
+        {
+            return m_fd != -1;
+        }
+
+        /**
+         * Reads the bytes appended to the file since the previous call, and
+         * calls `on_line` with every complete line as a `string_view`, without
+         * the line terminator.
+         * A partial final line is kept for the next call.
+         *
+         * The file is read a chunk at a time, and the lines in a chunk are
+         * passed on before the next one is read, so that only a chunk and a
+         * partial line are buffered. At most \ref max_chunks_per_poll chunks
+         * are read per call: \ref wait returns immediately, if there's more.
+         *
+         * \return The number of lines passed to `on_line`
+         */
+        template <typename F>
+        expected<std::size_t> poll(F&& on_line,
+                                   line_ending e = line_ending::lf)
+        {
+            std::size_t n = 0;
+            for (std::size_t i = 0; i < max_chunks_per_poll; ++i) {
+                auto ret = _read_appended();
+                if (!ret) {
+                    return ret;
+                }
+                if (ret.value() == 0) {
+                    break;
+                }
+
+                // The partial line before the chunk has no line breaks
+                const auto chunk_end = m_buffer.rbegin() +
+                                       static_cast<std::ptrdiff_t>(ret.value());
+                const auto last =
+                    std::find(m_buffer.rbegin(), chunk_end, '\n');
+                if (last == chunk_end) {
+                    continue;
+                }
+                const auto complete =
+                    static_cast<std::size_t>(m_buffer.rend() - last);
+
+                for (auto line :
+                     lines(string_view{m_buffer.data(), complete}, e)) {
+                    on_line(line);
+                    ++n;
+                }
+                m_buffer.erase(0, complete);
+                m_checkpoint.offset += complete;
+            }
+            return n;
+        }
+
+        /// Most chunks (of 1 MiB) read by a single \ref poll
+        static constexpr std::size_t max_chunks_per_poll = 16;
+
+        /**
+         * Waits until the file changes, or `timeout_ms` milliseconds have
+         * passed. Uses inotify on Linux, and polls the size of the file
+         * elsewhere.
+         *
+         * \return `true`, if the file may have been appended to
+         */
+        bool wait(int timeout_ms);
+
+        /// The position to resume from, after the lines passed on so far
+        follow_checkpoint checkpoint() const noexcept
+        {
+            return m_checkpoint;
+        }
+
+        /// The incomplete final line read so far
+        string_view pending() const noexcept
+        {
+            return {m_buffer.data(), m_buffer.size()};
+        }
+
+    private:
+        error _open(follow_checkpoint cp);
+        void _close() noexcept;
+        // Reads a chunk of the appended bytes into m_buffer,
+        // returns the number of bytes read
+        expected<std::size_t> _read_appended();
+
+        std::string m_filename{};
+        std::string m_buffer{};
+        follow_checkpoint m_checkpoint{};
+        // file offset of the end of m_buffer
+        uint64_t m_read_end{0};
+        int m_fd{-1};
+        int m_notify{-1};
+    };
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY && !defined(SCN_FOLLOW_CPP)
+#include "follow.cpp"
+#endif
+
+#endif  // SCN_DETAIL_FOLLOW_H
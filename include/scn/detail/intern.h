@@ -0,0 +1,347 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_INTERN_H
+#define SCN_DETAIL_INTERN_H
+
+#include "arena.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup intern String interning
+     *
+     * Scanning a string field with only a few different values (like status
+     * codes, host names, or tags) into a \ref interned destination looks
+     * it up in an intern pool, which stores every different string once.
+     * The scanned value is a small integer id, and a \ref string_view into the
+     * pool: no memory is allocated for a string that's already in the pool,
+     * and interned strings can be compared by comparing their ids.
+     */
+
+    /// @{
+
+    namespace detail {
+        inline uint64_t intern_load64(const unsigned char* p) noexcept
+        {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+        inline uint64_t intern_mix(uint64_t a, uint64_t b) noexcept
+        {
+            // 64x64 -> 128-bit multiply, folded back into 64 bits
+            const uint64_t ah = a >> 32, al = a & 0xffffffffu;
+            const uint64_t bh = b >> 32, bl = b & 0xffffffffu;
+            const uint64_t ll = al * bl, lh = al * bh, hl = ah * bl,
+                           hh = ah * bh;
+            const uint64_t mid = (ll >> 32) + (lh & 0xffffffffu) +
+                                 (hl & 0xffffffffu);
+            const uint64_t lo = (mid << 32) | (ll & 0xffffffffu);
+            const uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+            return lo ^ hi;
+        }
+
+        /**
+         * Hashes `n` bytes at `data`, eight bytes at a time
+         * (the tail with overlapping loads, without a loop over the bytes).
+         */
+        inline uint64_t intern_hash(const void* data, std::size_t n) noexcept
+        {
+            constexpr uint64_t k0 = 0xa0761d6478bd642full;
+            constexpr uint64_t k1 = 0xe7037ed1a0b428dbull;
+
+            auto p = static_cast<const unsigned char*>(data);
+            uint64_t h = k0 ^ static_cast<uint64_t>(n);
+            if (n >= 8) {
+                for (; n > 8; n -= 8, p += 8) {
+                    h = intern_mix(h ^ intern_load64(p), k1);
+                }
+                // the last eight bytes, overlapping the previous load
+                h = intern_mix(h ^ intern_load64(p + n - 8), k1);
+            }
+            else if (n >= 4) {
+                uint32_t a, b;
+                std::memcpy(&a, p, 4);
+                std::memcpy(&b, p + n - 4, 4);
+                h = intern_mix(h ^ ((uint64_t{a} << 32) | b), k1);
+            }
+            else if (n > 0) {
+                const uint64_t v = (uint64_t{p[0]} << 16) |
+                                   (uint64_t{p[n / 2]} << 8) | p[n - 1];
+                h = intern_mix(h ^ v, k1);
+            }
+            return intern_mix(h, k0 ^ k1);
+        }
+    }  // namespace detail
+
+    /**
+     * A set of strings, each one identified by a sequential id, starting
+     * from 0.
+     *
+     * The strings are stored in a \ref monotonic_arena, and found with an
+     * open-addressing hash table (linear probing), which stores the hash of
+     * every string: a lookup compares hashes first, and the characters only
+     * when the hashes match.
+     * The pool can't be moved, because the views into it must stay valid.
+     */
+    template <typename CharT>
+    class basic_intern_pool {
+    public:
+        using char_type = CharT;
+        using id_type = uint32_t;
+        using view_type = basic_string_view<CharT>;
+
+        /// Returned by \ref find, if the string is not in the pool
+        static constexpr id_type npos = static_cast<id_type>(-1);
+
+        /// Makes room for `expected_size` strings
+        explicit basic_intern_pool(std::size_t expected_size = 64)
+        {
+            std::size_t cap = 16;
+            while (cap < expected_size * 2) {
+                cap *= 2;
+            }
+            m_slots.resize(cap);
+            m_strings.reserve(expected_size);
+        }
+
+        basic_intern_pool(const basic_intern_pool&) = delete;
+        basic_intern_pool& operator=(const basic_intern_pool&) = delete;
+        basic_intern_pool(basic_intern_pool&&) = delete;
+        basic_intern_pool& operator=(basic_intern_pool&&) = delete;
+
+        ~basic_intern_pool() = default;
+
+        /// The id of `s`, adding it to the pool, if it's not there yet
+        id_type intern(view_type s)
+        {
+            const auto h = _hash(s);
+            auto i = _probe(s, h);
+            if (m_slots[i].id != 0) {
+                return m_slots[i].id - 1;
+            }
+
+            SCN_EXPECT(m_strings.size() < npos - 1);
+            auto p = m_arena.allocate_array<CharT>(s.size());
+            if (s.size() != 0) {
+                std::memcpy(p, s.data(), s.size() * sizeof(CharT));
+            }
+            m_strings.push_back(view_type{p, s.size()});
+            const auto id = static_cast<id_type>(m_strings.size() - 1);
+            m_slots[i] = slot{h, id + 1};
+
+            // keep the load factor at most 1/2
+            if (m_strings.size() * 2 > m_slots.size()) {
+                _grow();
+            }
+            return id;
+        }
+
+        /// The id of `s`, or \ref npos, if it's not in the pool
+        id_type find(view_type s) const
+        {
+            const auto& sl = m_slots[_probe(s, _hash(s))];
+            return sl.id != 0 ? sl.id - 1 : npos;
+        }
+
+        /// The string with the id `id`, `id < size()`
+        view_type str(id_type id) const
+        {
+            SCN_EXPECT(id < m_strings.size());
+            return m_strings[id];
+        }
+
+        /// Number of strings in the pool
+        std::size_t size() const noexcept
+        {
+            return m_strings.size();
+        }
+
+    private:
+        struct slot {
+            uint64_t hash{0};
+            // id + 1, or 0 if the slot is empty
+            id_type id{0};
+        };
+
+        static uint64_t _hash(view_type s) noexcept
+        {
+            return detail::intern_hash(s.data(), s.size() * sizeof(CharT));
+        }
+
+        // Index of the slot containing s, or of the empty slot to put it in
+        std::size_t _probe(view_type s, uint64_t h) const
+        {
+            const auto mask = m_slots.size() - 1;
+            for (auto i = static_cast<std::size_t>(h) & mask;;
+                 i = (i + 1) & mask) {
+                const auto& sl = m_slots[i];
+                if (sl.id == 0) {
+                    return i;
+                }
+                if (sl.hash == h) {
+                    const auto& str = m_strings[sl.id - 1];
+                    if (str.size() == s.size() &&
+                        std::memcmp(str.data(), s.data(),
+                                    s.size() * sizeof(CharT)) == 0) {
+                        return i;
+                    }
+                }
+            }
+        }
+
+        void _grow()
+        {
+            std::vector<slot> old(m_slots.size() * 2);
+            old.swap(m_slots);
+            const auto mask = m_slots.size() - 1;
+            for (const auto& sl : old) {
+                if (sl.id == 0) {
+                    continue;
+                }
+                auto i = static_cast<std::size_t>(sl.hash) & mask;
+                while (m_slots[i].id != 0) {
+                    i = (i + 1) & mask;
+                }
+                m_slots[i] = sl;
+            }
+        }
+
+        std::vector<slot> m_slots{};
+        std::vector<view_type> m_strings{};
+        monotonic_arena m_arena{};
+    };
+
+    template <typename CharT>
+    constexpr typename basic_intern_pool<CharT>::id_type
+        basic_intern_pool<CharT>::npos;
+
+    using intern_pool = basic_intern_pool<char>;
+    using wintern_pool = basic_intern_pool<wchar_t>;
+
+    /**
+     * A string interned into a pool of the type `Pool`, when scanned into.
+     *
+     * `Pool` needs to have the member types `char_type` and `id_type`,
+     * and the member functions `id_type intern(basic_string_view<char_type>)`
+     * and `basic_string_view<char_type> str(id_type) const`, like
+     * \ref basic_intern_pool "intern_pool".
+     */
+    template <typename Pool>
+    class interned {
+    public:
+        using pool_type = Pool;
+        using char_type = typename Pool::char_type;
+        using id_type = typename Pool::id_type;
+
+        explicit interned(Pool& p) noexcept : m_pool(std::addressof(p)) {}
+
+        /// Interns `s` into the pool
+        void assign(basic_string_view<char_type> s)
+        {
+            m_id = m_pool->intern(s);
+            m_set = true;
+        }
+
+        /// `true`, if a string has been scanned into `*this`
+        bool has_value() const noexcept
+        {
+            return m_set;
+        }
+        /// The id of the string in the pool, requires `has_value()`
+        id_type id() const noexcept
+        {
+            SCN_EXPECT(m_set);
+            return m_id;
+        }
+        /// The string in the pool, requires `has_value()`
+        basic_string_view<char_type> view() const
+        {
+            SCN_EXPECT(m_set);
+            return m_pool->str(m_id);
+        }
+
+        Pool& pool() const noexcept
+        {
+            return *m_pool;
+        }
+
+    private:
+        Pool* m_pool;
+        id_type m_id{};
+        bool m_set{false};
+    };
+
+    /// @}
+
+    namespace detail {
+        struct interned_scanner : string_scanner {
+            template <typename Context, typename Pool>
+            error scan(interned<Pool>& val, Context& ctx)
+            {
+                using char_type = typename Context::char_type;
+                static_assert(
+                    std::is_same<char_type, typename Pool::char_type>::value,
+                    "The character type of the pool must match the range");
+
+                if (Context::range_type::is_contiguous) {
+                    auto s = _read_zero_copy(ctx);
+                    if (!s) {
+                        return s.error();
+                    }
+                    const auto chars = s.value().chars;
+                    if (s.value().escaped) {
+                        small_vector<char_type, 64> tmp;
+                        auto outputit = std::back_inserter(tmp);
+                        string_escapes::unescape(chars, m_quote, outputit);
+                        val.assign({tmp.data(), tmp.size()});
+                        return {};
+                    }
+                    val.assign({chars.data(), chars.size()});
+                    return {};
+                }
+
+                small_vector<char_type, 64> tmp;
+                auto outputit = std::back_inserter(tmp);
+                auto ret = _read(ctx, outputit);
+                if (SCN_UNLIKELY(!ret)) {
+                    return ret;
+                }
+                if (SCN_UNLIKELY(tmp.empty() && !_allow_empty(ctx))) {
+                    return error(error::invalid_scanned_value,
+                                 "Empty string parsed");
+                }
+                val.assign({tmp.data(), tmp.size()});
+                return {};
+            }
+        };
+    }  // namespace detail
+
+    template <typename CharT, typename Pool>
+    struct scanner<CharT, interned<Pool>> : public detail::interned_scanner {
+    };
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_INTERN_H
@@ -0,0 +1,530 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_KV_H
+#define SCN_DETAIL_KV_H
+
+#include "scan.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup kv Key-value extraction
+     *
+     * A \ref basic_kv_extractor picks the values of a few wanted keys out of
+     * a record of key-value pairs, like a logfmt line, or a flat JSON object
+     * (one line of JSON Lines), and scans them into typed destinations.
+     *
+     * The keys and values are delimited with vectorized searches (see
+     * \ref simd), and only the values of the wanted keys are scanned: other
+     * values, including nested JSON objects and arrays, are skipped over.
+     * The search ends as soon as every wanted key has been found.
+     */
+
+    /// @{
+
+    /// Syntax of the records read by a \ref basic_kv_extractor
+    enum class kv_format {
+        /**
+         * Space-separated `key=value` pairs, with optional quotes around the
+         * values: `level=info msg="hello world" took=12ms`.
+         * A key without `=` has the value `true`.
+         */
+        logfmt,
+        /// A flat JSON object: `{"level": "info", "took": 12}`
+        json
+    };
+
+    namespace detail {
+        template <typename CharT>
+        struct kv_value_scanner {
+            using token_type = string_token<CharT>;
+
+            // Quoted values with escapes are unescaped
+            template <typename Traits, typename Allocator>
+            static error scan(token_type tok,
+                              std::basic_string<CharT, Traits, Allocator>& val)
+            {
+                if (!tok.escaped) {
+                    val.assign(tok.chars.data(), tok.chars.size());
+                    return {};
+                }
+                val.clear();
+                auto outputit = std::back_inserter(val);
+                string_escapes::unescape(tok.chars, quote_style::backslash,
+                                         outputit);
+                return {};
+            }
+            template <typename T>
+            static error scan(token_type tok, T& val)
+            {
+                if (tok.escaped) {
+                    return error(error::invalid_scanned_value,
+                                 "Cannot scan a value with escape sequences "
+                                 "into a type other than a string");
+                }
+                return field_scanner::scan(
+                    basic_string_view<CharT>{tok.chars.data(),
+                                             tok.chars.size()},
+                    val);
+            }
+
+            template <typename T>
+            static error erased(void* dest, token_type tok)
+            {
+                return scan(tok, *static_cast<T*>(dest));
+            }
+        };
+    }  // namespace detail
+
+    /**
+     * Extracts the values of a set of keys from records of key-value pairs.
+     *
+     * \code{.cpp}
+     * int status{};
+     * std::string path;
+     * scn::kv_extractor ex{scn::kv_format::logfmt};
+     * ex.add("status", status).add("path", path);
+     *
+     * for (auto line : scn::lines(source)) {
+     *     auto ret = ex.extract(line);
+     *     if (ret && ex.found(0)) {
+     *         // status has been scanned
+     *     }
+     * }
+     * \endcode
+     *
+     * If a key appears more than once in a record, its first value is used.
+     * In JSON, a `null` value is treated like a missing key.
+     */
+    template <typename CharT>
+    class basic_kv_extractor {
+    public:
+        using char_type = CharT;
+        using string_view_type = basic_string_view<CharT>;
+
+        /// Maximum number of keys
+        static constexpr std::size_t max_keys = 64;
+
+        explicit basic_kv_extractor(kv_format f = kv_format::logfmt)
+            : m_format(f)
+        {
+            const char spaces[] = {' ', '\t', '\n', '\r', '\v', '\f'};
+            for (auto ch : spaces) {
+                m_spaces.insert(ch);
+                m_word_chars.insert(ch);
+                m_key_chars.insert(ch);
+                m_literal_chars.insert(ch);
+            }
+            m_word_chars.invert();
+            m_key_chars.insert('=');
+            m_key_chars.invert();
+            m_literal_chars.insert(',');
+            m_literal_chars.insert('}');
+            m_literal_chars.insert(']');
+            m_literal_chars.invert();
+
+            m_string_chars.insert('"');
+            m_string_chars.insert('\\');
+            m_string_chars.invert();
+            for (auto ch : {'"', '{', '}', '[', ']'}) {
+                m_nested_chars.insert(ch);
+            }
+            m_nested_chars.invert();
+        }
+
+        /**
+         * Adds `key`, the value of which is scanned into `dest`.
+         * Strings are assigned the whole value (without the quotes, and with
+         * the escape sequences decoded), other types are scanned as with
+         * `"{}"`.
+         * `key` is not copied, and `dest` is stored as a pointer: both have to
+         * outlive the extractor.
+         */
+        template <typename T>
+        basic_kv_extractor& add(string_view_type key, T& dest)
+        {
+            SCN_EXPECT(m_keys.size() < max_keys);
+            m_keys.push_back(
+                {key, std::addressof(dest),
+                 &detail::kv_value_scanner<CharT>::template erased<T>});
+            m_lengths |= _length_bit(key.size());
+            return *this;
+        }
+        template <typename T>
+        basic_kv_extractor& add(const CharT* key, T& dest)
+        {
+            return add(string_view_type{key}, dest);
+        }
+
+        /// Number of keys
+        std::size_t size() const noexcept
+        {
+            return m_keys.size();
+        }
+
+        /**
+         * Finds the keys in `record`, and scans their values into their
+         * destinations. The destinations of the keys not found are left
+         * untouched.
+         *
+         * \return The number of keys found, or an error, if the record is
+         * malformed, or a value couldn't be scanned. Once every key has been
+         * found, the rest of the record is not looked at, and a record not
+         * containing any of the keys is not looked at at all.
+         */
+        expected<std::size_t> extract(string_view_type record)
+        {
+            m_found = 0;
+            m_count = 0;
+            if (m_keys.empty()) {
+                return std::size_t{0};
+            }
+            const auto b = record.data();
+            const auto e = b + record.size();
+            if (!_may_contain_key(b, e)) {
+                return std::size_t{0};
+            }
+            auto ret = m_format == kv_format::json ? _json(b, e)
+                                                   : _logfmt(b, e);
+            if (!ret) {
+                return ret;
+            }
+            return m_count;
+        }
+
+        /// Whether key `i` (in the order they were added) was found by the
+        /// last call to \ref extract
+        bool found(std::size_t i) const noexcept
+        {
+            return ((m_found >> i) & 1) != 0;
+        }
+
+    private:
+        using token_type = detail::string_token<CharT>;
+
+        struct key_entry {
+            string_view_type key;
+            void* dest;
+            error (*scan)(void*, token_type);
+        };
+
+        static uint64_t _length_bit(std::size_t n) noexcept
+        {
+            return uint64_t{1} << (n < 63 ? n : 63);
+        }
+        bool _done() const noexcept
+        {
+            return m_count == m_keys.size();
+        }
+
+        /**
+         * Whether `key` appears anywhere in `[b, e)`, not necessarily as a
+         * key: the first and the last characters of `key` are matched a
+         * block at a time, and the rest is compared only at the positions
+         * where both match.
+         */
+        static bool _contains(const CharT* b,
+                              const CharT* e,
+                              string_view_type key) noexcept
+        {
+            const auto n = static_cast<std::ptrdiff_t>(key.size());
+            if (n == 0 || n > 32) {
+                // Not worth it
+                return true;
+            }
+            const CharT chars[3] = {key[0], key[key.size() - 1], key[0]};
+            // A match beginning at bit `step` or later is found in the
+            // next block
+            const auto step = 64 - (n - 1);
+            const auto starts =
+                n == 1 ? ~uint64_t{0} : (uint64_t{1} << step) - 1;
+            for (std::ptrdiff_t off = 0; (e - b) - off >= n; off += step) {
+                const auto p = b + off;
+                uint64_t masks[3]{};
+                detail::match_masks(p, e, chars, masks);
+                auto candidates =
+                    masks[0] & (masks[1] >> (n - 1)) & starts;
+                while (candidates != 0) {
+                    const auto i = detail::countr_zero(candidates);
+                    if (std::equal(key.begin(), key.end(), p + i)) {
+                        return true;
+                    }
+                    candidates &= candidates - 1;
+                }
+            }
+            return false;
+        }
+        // A line without any of the keys is skipped with a single pass
+        bool _may_contain_key(const CharT* b, const CharT* e) const noexcept
+        {
+            for (const auto& k : m_keys) {
+                if (_contains(b, e, k.key)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Index of the key [b, e) among the ones not found yet, or -1
+        std::ptrdiff_t _lookup(const CharT* b, const CharT* e) const
+        {
+            const auto n = static_cast<std::size_t>(e - b);
+            if ((m_lengths & _length_bit(n)) == 0) {
+                return -1;
+            }
+            for (std::size_t i = 0; i < m_keys.size(); ++i) {
+                const auto& k = m_keys[i];
+                if (k.key.size() == n && !found(i) &&
+                    std::equal(b, e, k.key.data())) {
+                    return static_cast<std::ptrdiff_t>(i);
+                }
+            }
+            return -1;
+        }
+
+        error _value(std::ptrdiff_t i, token_type tok)
+        {
+            const auto idx = static_cast<std::size_t>(i);
+            m_found |= uint64_t{1} << idx;
+            ++m_count;
+            return m_keys[idx].scan(m_keys[idx].dest, tok);
+        }
+
+        // Reads the quoted string beginning at `p`, and advances `p`
+        // past it
+        expected<token_type> _string(const CharT*& p, const CharT* e) const
+        {
+            token_type tok{};
+            auto q = detail::find_closing_quote(p + 1, e,
+                                                detail::quote_style::backslash,
+                                                m_string_chars, tok.escaped);
+            if (!q) {
+                return q.error();
+            }
+            tok.chars = span<const CharT>{p + 1, q.value()};
+            p = q.value() + 1;
+            return tok;
+        }
+
+        error _logfmt(const CharT* p, const CharT* e)
+        {
+            static const CharT true_str[] = {
+                detail::ascii_widen<CharT>('t'),
+                detail::ascii_widen<CharT>('r'),
+                detail::ascii_widen<CharT>('u'),
+                detail::ascii_widen<CharT>('e')};
+            const auto eq = detail::ascii_widen<CharT>('=');
+            const auto quote = detail::ascii_widen<CharT>('"');
+
+            while (!_done()) {
+                p = m_spaces.find_first_not_of(p, e);
+                if (p == e) {
+                    break;
+                }
+                const auto key_begin = p;
+                p = m_key_chars.find_first_not_of(p, e);
+                const auto i = _lookup(key_begin, p);
+
+                token_type tok{};
+                if (p == e || *p != eq) {
+                    // A flag without a value
+                    tok.chars = span<const CharT>{true_str, true_str + 4};
+                }
+                else if (++p != e && *p == quote) {
+                    auto s = _string(p, e);
+                    if (!s) {
+                        return s.error();
+                    }
+                    tok = s.value();
+                }
+                else {
+                    const auto value_begin = p;
+                    p = m_word_chars.find_first_not_of(p, e);
+                    tok.chars = span<const CharT>{value_begin, p};
+                }
+                if (i >= 0) {
+                    auto ret = _value(i, tok);
+                    if (!ret) {
+                        return ret;
+                    }
+                }
+            }
+            return {};
+        }
+
+        // Skips the JSON object or array beginning at `p`
+        error _skip_nested(const CharT*& p, const CharT* e) const
+        {
+            const auto quote = detail::ascii_widen<CharT>('"');
+            std::size_t depth = 0;
+            while (true) {
+                p = m_nested_chars.find_first_not_of(p, e);
+                if (p == e) {
+                    return error(error::invalid_scanned_value,
+                                 "Unterminated JSON object or array");
+                }
+                if (*p == quote) {
+                    auto s = _string(p, e);
+                    if (!s) {
+                        return s.error();
+                    }
+                    continue;
+                }
+                if (*p == detail::ascii_widen<CharT>('{') ||
+                    *p == detail::ascii_widen<CharT>('[')) {
+                    ++depth;
+                }
+                else if (--depth == 0) {
+                    ++p;
+                    return {};
+                }
+                ++p;
+            }
+        }
+
+        error _json(const CharT* p, const CharT* e)
+        {
+            static const CharT null_str[] = {
+                detail::ascii_widen<CharT>('n'),
+                detail::ascii_widen<CharT>('u'),
+                detail::ascii_widen<CharT>('l'),
+                detail::ascii_widen<CharT>('l')};
+            const auto quote = detail::ascii_widen<CharT>('"');
+
+            p = m_spaces.find_first_not_of(p, e);
+            if (p == e || *p != detail::ascii_widen<CharT>('{')) {
+                return error(error::invalid_scanned_value,
+                             "Expected a JSON object");
+            }
+            ++p;
+            while (!_done()) {
+                p = m_spaces.find_first_not_of(p, e);
+                if (p != e && *p == detail::ascii_widen<CharT>('}')) {
+                    break;
+                }
+                if (p == e || *p != quote) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected a key in a JSON object");
+                }
+                auto key = _string(p, e);
+                if (!key) {
+                    return key.error();
+                }
+                // Keys with escape sequences never match
+                const auto i =
+                    key.value().escaped
+                        ? -1
+                        : _lookup(key.value().chars.begin(),
+                                  key.value().chars.end());
+
+                p = m_spaces.find_first_not_of(p, e);
+                if (p == e || *p != detail::ascii_widen<CharT>(':')) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected ':' after a key in a JSON object");
+                }
+                p = m_spaces.find_first_not_of(p + 1, e);
+                if (p == e) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected a value in a JSON object");
+                }
+
+                token_type tok{};
+                const auto value_begin = p;
+                if (*p == quote) {
+                    auto s = _string(p, e);
+                    if (!s) {
+                        return s.error();
+                    }
+                    tok = s.value();
+                }
+                else if (*p == detail::ascii_widen<CharT>('{') ||
+                         *p == detail::ascii_widen<CharT>('[')) {
+                    // Scanned as its JSON text, if wanted
+                    auto ret = _skip_nested(p, e);
+                    if (!ret) {
+                        return ret;
+                    }
+                    tok.chars = span<const CharT>{value_begin, p};
+                }
+                else {
+                    p = m_literal_chars.find_first_not_of(p, e);
+                    if (p == value_begin) {
+                        return error(error::invalid_scanned_value,
+                                     "Expected a value in a JSON object");
+                    }
+                    tok.chars = span<const CharT>{value_begin, p};
+                }
+
+                const bool null = p - value_begin == 4 &&
+                                  std::equal(value_begin, p, null_str);
+                if (i >= 0 && !null) {
+                    auto ret = _value(i, tok);
+                    if (!ret) {
+                        return ret;
+                    }
+                }
+
+                p = m_spaces.find_first_not_of(p, e);
+                if (p != e && *p == detail::ascii_widen<CharT>(',')) {
+                    ++p;
+                    continue;
+                }
+                if (p == e || *p != detail::ascii_widen<CharT>('}')) {
+                    return error(error::invalid_scanned_value,
+                                 "Expected ',' or '}' in a JSON object");
+                }
+                break;
+            }
+            return {};
+        }
+
+        // Whitespace
+        detail::scanset m_spaces{};
+        // Everything but whitespace
+        detail::scanset m_word_chars{};
+        // Everything but whitespace and '='
+        detail::scanset m_key_chars{};
+        // Everything but whitespace, and ',', '}' and ']', which end
+        // a JSON number or literal
+        detail::scanset m_literal_chars{};
+        // Everything but the quote and the escape character
+        detail::scanset m_string_chars{};
+        // Everything but quotes and brackets
+        detail::scanset m_nested_chars{};
+        std::vector<key_entry> m_keys{};
+        // Bit min(n, 63) is set, if there's a key of length n
+        uint64_t m_lengths{0};
+        uint64_t m_found{0};
+        std::size_t m_count{0};
+        kv_format m_format;
+    };
+
+    using kv_extractor = basic_kv_extractor<char>;
+    using wkv_extractor = basic_kv_extractor<wchar_t>;
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_KV_H
@@ -0,0 +1,275 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_LINE_INDEX_H
+#define SCN_DETAIL_LINE_INDEX_H
+
+#include "scan.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup line_index Line index
+     *
+     * Random access to the lines of a large, immutable file.
+     *
+     * A \ref line_index stores the offsets of the beginnings of the lines of
+     * a source. The offsets are delta-encoded in blocks of 256 lines, with
+     * the narrowest integer width (1, 2, 4 or 8 bytes) that fits the block,
+     * so an index usually takes a bit over two bytes per line.
+     * Finding the offset of a line is O(1).
+     *
+     * An index can be saved into a file, and loaded later by mapping that file
+     * into memory: loading doesn't read or decode the index.
+     * \ref indexed_file does this automatically, with a sidecar file next to
+     * the source.
+     *
+     * Building an index with more than one thread requires linking with the
+     * platform thread library (`Threads::Threads` in CMake), which the
+     * `scn::scn` target does automatically.
+     */
+
+    /// @{
+
+    namespace detail {
+        struct line_index_access;
+    }  // namespace detail
+
+    /// Identifies the version of a source file an index was built from
+    struct source_stamp {
+        uint64_t size{0};
+        /// In nanoseconds, where the platform has them, otherwise seconds
+        int64_t mtime{0};
+    };
+
+    /**
+     * Size and modification time of the file `filename`,
+     * or zeroes, if it can't be queried.
+     */
+    source_stamp get_source_stamp(const char* filename);
+
+    namespace detail {
+        /**
+         * Writes `[data, data + size)` into a temporary file next to
+         * `filename`, and renames it over `filename`, so that processes
+         * that have the old file mapped keep seeing the old contents.
+         */
+        error replace_file(const char* filename,
+                           const void* data,
+                           std::size_t size);
+    }  // namespace detail
+
+    class line_index {
+    public:
+        line_index() = default;
+
+        line_index(const line_index&) = delete;
+        line_index& operator=(const line_index&) = delete;
+
+        line_index(line_index&& o) noexcept
+            : m_buffer(std::move(o.m_buffer)), m_map(std::move(o.m_map))
+        {
+            _init();
+            o._reset();
+        }
+        line_index& operator=(line_index&& o) noexcept
+        {
+            m_buffer = std::move(o.m_buffer);
+            m_map = std::move(o.m_map);
+            _init();
+            o._reset();
+            return *this;
+        }
+
+        ~line_index() = default;
+
+        bool valid() const noexcept
+        {
+            return m_data != nullptr;
+        }
+
+        /// Number of lines
+        std::size_t size() const noexcept
+        {
+            return static_cast<std::size_t>(m_lines);
+        }
+
+        /// Offset of the beginning of line `i` in the source
+        std::size_t offset(std::size_t i) const noexcept;
+
+        /// The source the index was built from
+        source_stamp stamp() const noexcept
+        {
+            return m_stamp;
+        }
+
+        /// Size of the encoded index, in bytes
+        std::size_t size_in_bytes() const noexcept
+        {
+            return m_size;
+        }
+
+        /// Pointer to the encoded index, `size_in_bytes()` long
+        const unsigned char* data() const noexcept
+        {
+            return m_data;
+        }
+
+    private:
+        friend struct detail::line_index_access;
+
+        void _init() noexcept;
+        void _reset() noexcept
+        {
+            m_buffer.clear();
+            m_data = nullptr;
+            m_size = 0;
+            m_lines = 0;
+            m_blocks = nullptr;
+            m_deltas = nullptr;
+            m_stamp = {};
+        }
+
+        std::vector<unsigned char> m_buffer{};
+        detail::byte_mapped_file m_map{};
+        const unsigned char* m_data{nullptr};
+        std::size_t m_size{0};
+        uint64_t m_lines{0};
+        const unsigned char* m_blocks{nullptr};
+        const unsigned char* m_deltas{nullptr};
+        source_stamp m_stamp{};
+    };
+
+    /**
+     * Builds the index of the lines of `source`.
+     * The lines are as in \ref lines: a final line without a terminating
+     * `'\n'` is a line, but an empty one after it is not.
+     *
+     * \param threads Number of threads to use, or 0 for as many as there are
+     * hardware threads. Sources of at most a few megabytes are always indexed
+     * on the calling thread.
+     * \param stamp Stored in the index as-is, to later check whether it's
+     * out of date. Defaults to the size of `source`, and no modification time.
+     */
+    line_index make_line_index(string_view source,
+                               unsigned threads = 1,
+                               source_stamp stamp = source_stamp{});
+
+    /**
+     * Writes `index` into the file `filename`, replacing it
+     * (see \ref detail::replace_file), instead of overwriting it in place.
+     */
+    error save_line_index(const line_index& index, const char* filename);
+
+    /**
+     * Maps an index saved with \ref save_line_index from the file `filename`.
+     * The returned index is not `valid()`, if the file can't be mapped, or
+     * doesn't contain a consistent index created on a platform of the same
+     * endianness. The offsets of a loaded index are never larger than the
+     * size of the source it was stamped with.
+     */
+    line_index load_line_index(const char* filename);
+
+    /// Options for \ref indexed_file
+    struct line_index_options {
+        /// Passed to \ref make_line_index, if the index needs to be built
+        unsigned threads{1};
+        /// Save a built index to the sidecar file
+        bool save{true};
+    };
+
+    /**
+     * A \ref mapped_file, and the \ref line_index of its lines.
+     *
+     * The index is loaded from the sidecar file `filename + ".lidx"`, if it
+     * exists and the size and modification time of the file match the ones
+     * it was built from. Otherwise, the index is built, and saved to the
+     * sidecar, if `options.save` is `true` (a failure to save is ignored).
+     */
+    class indexed_file {
+    public:
+        indexed_file() = default;
+        explicit indexed_file(
+            const char* filename,
+            line_index_options options = line_index_options{});
+
+        /// `true`, if the file could be mapped
+        bool valid() const noexcept
+        {
+            return m_file.valid();
+        }
+
+        const mapped_file& file() const noexcept
+        {
+            return m_file;
+        }
+        const line_index& index() const noexcept
+        {
+            return m_index;
+        }
+
+        /// Number of lines (records) in the file
+        std::size_t size() const noexcept
+        {
+            return m_index.size();
+        }
+
+        /// Line `i` without its terminating newline, `i < size()`
+        string_view line(std::size_t i) const noexcept;
+
+        /**
+         * Scans line `i` according to the format string `f`, as if by
+         * `scn::scan(line(i), f, a...)`.
+         * If `i >= size()`, returns an error with the code
+         * `error::value_out_of_range`.
+         */
+        template <typename Format, typename... Args>
+        auto scan_record(std::size_t i, const Format& f, Args&... a) const
+            -> decltype(scan(std::declval<string_view>(), f, a...))
+        {
+            if (i >= size()) {
+                return {error(error::value_out_of_range,
+                              "Record index out of range"),
+                        string_view{}};
+            }
+            return scan(line(i), f, a...);
+        }
+
+        /// Path of the sidecar index file of `filename`
+        static std::string sidecar_path(const char* filename);
+
+    private:
+        mapped_file m_file{};
+        line_index m_index{};
+    };
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY && \
+    !defined(SCN_LINE_INDEX_CPP)
+#include "line_index.cpp"
+#endif
+
+#endif  // SCN_DETAIL_LINE_INDEX_H
@@ -0,0 +1,259 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_LINES_H
+#define SCN_DETAIL_LINES_H
+
+#include "reader.h"
+
+#include <algorithm>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /// How the lines of a \ref lines_view are terminated
+    enum class line_ending {
+        /// Lines end in `'\n'`
+        lf,
+        /// Lines end in `'\n'`, and a `'\r'` preceding it is dropped
+        crlf
+    };
+
+    namespace detail {
+        inline std::size_t count_until(const char* begin,
+                                       const char* end,
+                                       char ch) noexcept
+        {
+            return count_char(begin, end, ch);
+        }
+        inline std::size_t count_until(const wchar_t* begin,
+                                       const wchar_t* end,
+                                       wchar_t ch) noexcept
+        {
+            return static_cast<std::size_t>(std::count(begin, end, ch));
+        }
+    }  // namespace detail
+
+    /**
+     * \ingroup scanning_operations
+     *
+     * An input range of the lines of a contiguous range, as
+     * `basic_string_view`s pointing into it. Returned by \ref lines.
+     *
+     * Lines are read lazily, one at a time, and the underlying range is
+     * advanced past every line read.
+     * The line terminator is not included in the lines.
+     * A final line without a terminator is a line, but an empty range after
+     * the final terminator is not.
+     */
+    template <typename WrappedRange>
+    class lines_view {
+    public:
+        using range_type = WrappedRange;
+        using char_type = typename WrappedRange::char_type;
+        using string_view_type = basic_string_view<char_type>;
+        using difference_type = std::ptrdiff_t;
+
+        static_assert(WrappedRange::is_contiguous,
+                      "scn::lines requires a contiguous range");
+
+        class iterator {
+        public:
+            using value_type = string_view_type;
+            using reference = const value_type&;
+            using pointer = const value_type*;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::input_iterator_tag;
+
+            iterator() = default;
+            explicit iterator(lines_view* v) : m_view(v) {}
+
+            reference operator*() const
+            {
+                SCN_EXPECT(m_view && m_view->m_has_line);
+                return m_view->m_line;
+            }
+            pointer operator->() const
+            {
+                return std::addressof(operator*());
+            }
+
+            iterator& operator++()
+            {
+                SCN_EXPECT(m_view);
+                m_view->_next();
+                return *this;
+            }
+            iterator operator++(int)
+            {
+                auto tmp = *this;
+                operator++();
+                return tmp;
+            }
+
+            bool operator==(const iterator& o) const
+            {
+                return _done() == o._done();
+            }
+            bool operator!=(const iterator& o) const
+            {
+                return !operator==(o);
+            }
+
+        private:
+            bool _done() const
+            {
+                return m_view == nullptr || !m_view->m_has_line;
+            }
+
+            lines_view* m_view{nullptr};
+        };
+
+        lines_view(WrappedRange r, line_ending e)
+            : m_range(std::move(r)), m_ending(e)
+        {
+        }
+
+        /// Reads the first unread line, if there's no current line
+        iterator begin()
+        {
+            if (!m_has_line) {
+                _next();
+            }
+            return iterator{this};
+        }
+        iterator end() const
+        {
+            return {};
+        }
+
+        /**
+         * Skips the next `n` lines, including the current one, if
+         * `begin()` has been called since the last skip.
+         * Lines are counted in bulk, without looking at them one by one.
+         *
+         * \return The number of lines skipped, less than `n` only if the end
+         * of the range was reached
+         */
+        difference_type skip(difference_type n)
+        {
+            difference_type skipped = 0;
+            if (n > 0 && m_has_line) {
+                m_has_line = false;
+                ++skipped;
+            }
+            return skipped + _skip_unread(n - skipped);
+        }
+
+        /// The unread rest of the underlying range
+        typename WrappedRange::return_type range() const
+        {
+            return m_range.range();
+        }
+
+    private:
+        char_type _newline() const
+        {
+            return detail::ascii_widen<char_type>('\n');
+        }
+
+        void _next()
+        {
+            m_has_line = false;
+            if (m_range.begin() == m_range.end()) {
+                return;
+            }
+            const auto b = m_range.data();
+            const auto e = b + m_range.size();
+            auto p = detail::find_until(b, e, _newline());
+            m_range.advance((p == e ? p : p + 1) - b);
+            if (m_ending == line_ending::crlf && p != b &&
+                *(p - 1) == detail::ascii_widen<char_type>('\r')) {
+                --p;
+            }
+            m_line = string_view_type{b, static_cast<size_t>(p - b)};
+            m_has_line = true;
+        }
+
+        difference_type _skip_unread(difference_type n)
+        {
+            // Count whole blocks at a time, and only search for the
+            // individual newlines in the block containing the last one
+            constexpr std::ptrdiff_t block_size = 4096;
+
+            if (n <= 0 || m_range.begin() == m_range.end()) {
+                return 0;
+            }
+            const auto nl = _newline();
+            const auto b = m_range.data();
+            const auto e = b + m_range.size();
+            auto it = b;
+            difference_type skipped = 0;
+            while (skipped != n && it != e) {
+                const auto block_end =
+                    e - it > block_size ? it + block_size : e;
+                const auto c = static_cast<difference_type>(
+                    detail::count_until(it, block_end, nl));
+                if (c < n - skipped) {
+                    skipped += c;
+                    it = block_end;
+                    continue;
+                }
+                for (; skipped != n; ++skipped) {
+                    it = detail::find_until(it, block_end, nl) + 1;
+                }
+            }
+            if (skipped != n && *(e - 1) != nl) {
+                // final line without a terminator
+                ++skipped;
+            }
+            m_range.advance(it - b);
+            return skipped;
+        }
+
+        WrappedRange m_range;
+        string_view_type m_line{};
+        line_ending m_ending;
+        bool m_has_line{false};
+    };
+
+    /**
+     * \ingroup scanning_operations
+     *
+     * Returns a \ref lines_view over the contiguous range `r`:
+     *
+     * \code{.cpp}
+     * for (auto line : scn::lines(source)) {
+     *     // line is a string_view
+     * }
+     * \endcode
+     *
+     * Unlike calling `scn::getline` in a loop, the range is wrapped only
+     * once, and lines are searched for in bulk (see \ref simd).
+     * Nothing is allocated.
+     */
+    template <typename Range>
+    auto lines(Range&& r, line_ending e = line_ending::lf)
+        -> lines_view<decltype(detail::wrap(std::forward<Range>(r)))>
+    {
+        return {detail::wrap(std::forward<Range>(r)), e};
+    }
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_LINES_H
@@ -214,6 +214,11 @@ namespace scn {
 
         constexpr basic_default_locale_ref() = default;
 
+        constexpr bool is_default() const noexcept
+        {
+            return true;
+        }
+
         constexpr bool is_space(char_type ch) const
         {
             return detail::is_space(ch);
@@ -251,11 +256,16 @@ namespace scn {
         }
 
         template <typename T>
-        expected<std::ptrdiff_t> read_num(T&, const string_type&)
+        expected<std::ptrdiff_t> read_num(T&, string_view_type)
         {
             return error(error::invalid_operation,
                          "No read_num with basic_default_locale_ref");
         }
+        template <typename T>
+        expected<std::ptrdiff_t> read_num(T& val, const string_type& buf)
+        {
+            return read_num(val, string_view_type(buf.data(), buf.size()));
+        }
     };
 
     template <typename CharT>
@@ -323,7 +333,12 @@ namespace scn {
         }
 
         template <typename T>
-        expected<std::ptrdiff_t> read_num(T& val, const string_type& buf);
+        expected<std::ptrdiff_t> read_num(T& val, string_view_type buf);
+        template <typename T>
+        expected<std::ptrdiff_t> read_num(T& val, const string_type& buf)
+        {
+            return read_num(val, string_view_type(buf.data(), buf.size()));
+        }
 
         constexpr bool is_default() const noexcept
         {
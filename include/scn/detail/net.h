@@ -0,0 +1,584 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_NET_H
+#define SCN_DETAIL_NET_H
+
+#include "scan.h"
+
+#include <array>
+#include <cstdint>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup net Network addresses
+     *
+     * Scanners for IPv4 and IPv6 addresses, CIDR prefixes and MAC
+     * addresses:
+     *  - \ref ipv4_address: dotted-quad, `192.168.0.1`, without leading
+     *    zeros in the numbers (which would be octal elsewhere)
+     *  - \ref ipv6_address: as in RFC 4291, `2001:db8::ff00:42:8329`,
+     *    `::ffff:192.0.2.128`. A zone (`%eth0`) isn't a part of the
+     *    address, and is left unread.
+     *  - \ref ip_address: either of the above
+     *  - \ref cidr: an address and a prefix length, `10.0.0.0/8`.
+     *    The bits after the prefix don't need to be zero.
+     *  - \ref mac_address: `00:1a:2b:3c:4d:5e`, `00-1A-2B-3C-4D-5E`,
+     *    or `001a.2b3c.4d5e`
+     *
+     * The bytes of the addresses are in network byte order, so they can be
+     * copied into an `in_addr` or an `in6_addr` with `std::memcpy`.
+     *
+     * On contiguous ranges, the characters of a dotted-quad, a MAC
+     * address and the hexadecimal groups of an IPv6 address are classified
+     * 8 at a time (see \ref detail::swar), instead of looping over them.
+     */
+
+    /// @{
+
+    /// An IPv4 address
+    struct ipv4_address {
+        /// In network byte order
+        std::array<unsigned char, 4> bytes{{}};
+
+        /// The address as an integer, `a.b.c.d` is `a << 24 | ... | d`
+        uint32_t to_uint() const noexcept
+        {
+            return uint32_t{bytes[0]} << 24 | uint32_t{bytes[1]} << 16 |
+                   uint32_t{bytes[2]} << 8 | uint32_t{bytes[3]};
+        }
+    };
+
+    /// An IPv6 address
+    struct ipv6_address {
+        /// In network byte order
+        std::array<unsigned char, 16> bytes{{}};
+    };
+
+    /// An IPv4 or an IPv6 address
+    struct ip_address {
+        ipv4_address v4{};
+        ipv6_address v6{};
+        /// `true`, if the address is `v6`, otherwise it's `v4`
+        bool is_v6{false};
+    };
+
+    /// An address, and the length of its network prefix in bits
+    template <typename Address>
+    struct cidr {
+        Address address{};
+        int prefix_length{0};
+    };
+    using ipv4_cidr = cidr<ipv4_address>;
+    using ipv6_cidr = cidr<ipv6_address>;
+
+    /// A MAC (EUI-48) address
+    struct mac_address {
+        std::array<unsigned char, 6> bytes{{}};
+    };
+
+    namespace detail {
+        template <typename CharT>
+        struct net_parser {
+            using iterator = const CharT*;
+
+            static bool is_digit(CharT ch)
+            {
+                return detail::is_digit(ch);
+            }
+            static int hex_value(CharT ch)
+            {
+                if (ch >= ascii_widen<CharT>('0') &&
+                    ch <= ascii_widen<CharT>('9')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('0'));
+                }
+                if (ch >= ascii_widen<CharT>('a') &&
+                    ch <= ascii_widen<CharT>('f')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('a')) + 10;
+                }
+                if (ch >= ascii_widen<CharT>('A') &&
+                    ch <= ascii_widen<CharT>('F')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('A')) + 10;
+                }
+                return -1;
+            }
+
+            static expected<iterator> ipv4(iterator begin,
+                                           iterator end,
+                                           ipv4_address& a)
+            {
+                auto it = begin;
+                if (_ipv4_swar(it, end, a)) {
+                    return it;
+                }
+                it = begin;
+                for (std::size_t i = 0; i < 4; ++i) {
+                    if (i != 0) {
+                        if (it == end || *it != ascii_widen<CharT>('.')) {
+                            return _invalid("Expected an IPv4 address");
+                        }
+                        ++it;
+                    }
+                    if (it == end || !is_digit(*it)) {
+                        return _invalid("Expected an IPv4 address");
+                    }
+                    const auto start = it;
+                    int v = 0;
+                    for (; it != end && is_digit(*it) && it - start < 3;
+                         ++it) {
+                        v = v * 10 + static_cast<int>(
+                                         *it - ascii_widen<CharT>('0'));
+                    }
+                    if ((it != end && is_digit(*it)) ||
+                        (it - start > 1 &&
+                         *start == ascii_widen<CharT>('0'))) {
+                        return _invalid("Invalid number in an IPv4 address");
+                    }
+                    if (v > 255) {
+                        return error(error::value_out_of_range,
+                                     "Number in an IPv4 address out of range");
+                    }
+                    a.bytes[i] = static_cast<unsigned char>(v);
+                }
+                return it;
+            }
+
+            static expected<iterator> ipv6(iterator begin,
+                                           iterator end,
+                                           ipv6_address& a)
+            {
+                uint16_t groups[8] = {};
+                int n = 0;
+                // index of the group "::" is before, or -1
+                int gap = -1;
+                auto it = begin;
+                if (end - it >= 2 && it[0] == ascii_widen<CharT>(':') &&
+                    it[1] == ascii_widen<CharT>(':')) {
+                    gap = 0;
+                    it += 2;
+                }
+                while (n < 8) {
+                    const auto group_begin = it;
+                    unsigned v = 0;
+                    const auto len = _hex_group(it, end, v);
+                    if (len == 0) {
+                        if (gap == n) {
+                            // ends with "::"
+                            break;
+                        }
+                        return _invalid("Expected an IPv6 address");
+                    }
+                    if (len > 4) {
+                        return _invalid("Invalid group in an IPv6 address");
+                    }
+                    if (it != end && *it == ascii_widen<CharT>('.')) {
+                        // embedded IPv4 address
+                        if (n > 6) {
+                            return _invalid("Invalid IPv6 address");
+                        }
+                        ipv4_address v4{};
+                        auto r = ipv4(group_begin, end, v4);
+                        if (!r) {
+                            return r;
+                        }
+                        it = r.value();
+                        groups[n++] = static_cast<uint16_t>(
+                            v4.bytes[0] << 8 | v4.bytes[1]);
+                        groups[n++] = static_cast<uint16_t>(
+                            v4.bytes[2] << 8 | v4.bytes[3]);
+                        break;
+                    }
+                    groups[n++] = static_cast<uint16_t>(v);
+
+                    // a ':' not followed by a group isn't a part of the
+                    // address
+                    if (end - it < 2 || *it != ascii_widen<CharT>(':')) {
+                        break;
+                    }
+                    if (it[1] == ascii_widen<CharT>(':')) {
+                        if (gap != -1) {
+                            return _invalid("Invalid IPv6 address");
+                        }
+                        gap = n;
+                        it += 2;
+                    }
+                    else if (hex_value(it[1]) >= 0) {
+                        ++it;
+                    }
+                    else {
+                        break;
+                    }
+                }
+                if ((gap == -1 && n != 8) || (gap != -1 && n == 8)) {
+                    return _invalid("Invalid IPv6 address");
+                }
+
+                // expand "::"
+                const int zeros = 8 - n;
+                for (int i = 0, g = 0; i < 8; ++i) {
+                    uint16_t v = 0;
+                    if (gap == -1 || i < gap || i >= gap + zeros) {
+                        v = groups[g++];
+                    }
+                    a.bytes[static_cast<std::size_t>(2 * i)] =
+                        static_cast<unsigned char>(v >> 8);
+                    a.bytes[static_cast<std::size_t>(2 * i + 1)] =
+                        static_cast<unsigned char>(v & 0xff);
+                }
+                return it;
+            }
+
+            static expected<iterator> ip(iterator begin,
+                                         iterator end,
+                                         ip_address& a)
+            {
+                // An IPv6 address has a ':' after at most 4 hex digits
+                auto it = begin;
+                for (int i = 0; i < 4 && it != end && hex_value(*it) >= 0;
+                     ++i, ++it) {
+                }
+                a.is_v6 = it != end && *it == ascii_widen<CharT>(':');
+                if (a.is_v6) {
+                    return ipv6(begin, end, a.v6);
+                }
+                return ipv4(begin, end, a.v4);
+            }
+
+            static expected<iterator> address(iterator begin,
+                                              iterator end,
+                                              ipv4_address& a)
+            {
+                return ipv4(begin, end, a);
+            }
+            static expected<iterator> address(iterator begin,
+                                              iterator end,
+                                              ipv6_address& a)
+            {
+                return ipv6(begin, end, a);
+            }
+            static expected<iterator> address(iterator begin,
+                                              iterator end,
+                                              ip_address& a)
+            {
+                return ip(begin, end, a);
+            }
+
+            template <typename Address>
+            static expected<iterator> address(iterator begin,
+                                              iterator end,
+                                              cidr<Address>& c)
+            {
+                auto r = address(begin, end, c.address);
+                if (!r) {
+                    return r;
+                }
+                return prefix_length(r.value(), end,
+                                     max_prefix_length(c.address),
+                                     c.prefix_length);
+            }
+            static expected<iterator> address(iterator begin,
+                                              iterator end,
+                                              mac_address& a)
+            {
+                return mac(begin, end, a);
+            }
+
+            static int max_prefix_length(const ipv4_address&)
+            {
+                return 32;
+            }
+            static int max_prefix_length(const ipv6_address&)
+            {
+                return 128;
+            }
+            static int max_prefix_length(const ip_address& a)
+            {
+                return a.is_v6 ? 128 : 32;
+            }
+
+            // "/n", n <= max
+            static expected<iterator> prefix_length(iterator begin,
+                                                    iterator end,
+                                                    int max,
+                                                    int& len)
+            {
+                auto it = begin;
+                if (it == end || *it != ascii_widen<CharT>('/')) {
+                    return _invalid("Expected a CIDR prefix length");
+                }
+                ++it;
+                if (it == end || !is_digit(*it)) {
+                    return _invalid("Expected a CIDR prefix length");
+                }
+                int v = 0;
+                for (; it != end && is_digit(*it); ++it) {
+                    v = v * 10 +
+                        static_cast<int>(*it - ascii_widen<CharT>('0'));
+                    if (v > max) {
+                        return error(error::value_out_of_range,
+                                     "CIDR prefix length out of range");
+                    }
+                }
+                len = v;
+                return it;
+            }
+
+            static expected<iterator> mac(iterator begin,
+                                          iterator end,
+                                          mac_address& a)
+            {
+                auto it = begin;
+                if (_mac_swar(it, end, a)) {
+                    return it;
+                }
+                it = begin;
+                unsigned v{};
+                const auto first = _hex_group(it, end, v);
+                it = begin;
+                if (first == 4) {
+                    // 001a.2b3c.4d5e
+                    for (std::size_t i = 0; i < 3; ++i) {
+                        if (i != 0) {
+                            if (it == end ||
+                                *it != ascii_widen<CharT>('.')) {
+                                return _invalid("Expected a MAC address");
+                            }
+                            ++it;
+                        }
+                        if (_hex_group(it, end, v) != 4) {
+                            return _invalid("Expected a MAC address");
+                        }
+                        a.bytes[2 * i] = static_cast<unsigned char>(v >> 8);
+                        a.bytes[2 * i + 1] =
+                            static_cast<unsigned char>(v & 0xff);
+                    }
+                    return it;
+                }
+                if (first != 2 || end - it < 3) {
+                    return _invalid("Expected a MAC address");
+                }
+                // 00:1a:2b:3c:4d:5e or 00-1a-2b-3c-4d-5e
+                const auto sep = it[2];
+                if (sep != ascii_widen<CharT>(':') &&
+                    sep != ascii_widen<CharT>('-')) {
+                    return _invalid("Expected a MAC address");
+                }
+                for (std::size_t i = 0; i < 6; ++i) {
+                    if (i != 0) {
+                        if (it == end || *it != sep) {
+                            return _invalid("Expected a MAC address");
+                        }
+                        ++it;
+                    }
+                    if (_hex_group(it, end, v) != 2) {
+                        return _invalid("Expected a MAC address");
+                    }
+                    a.bytes[i] = static_cast<unsigned char>(v);
+                }
+                return it;
+            }
+
+        private:
+            static error _invalid(const char* msg)
+            {
+                return error(error::invalid_scanned_value, msg);
+            }
+
+            // Reads hex digits into `v`, returns their number,
+            // reading at most 5
+            template <typename C>
+            static int _hex_group(const C*& it, const C* end, unsigned& v)
+            {
+                v = 0;
+                int n = 0;
+                for (; n < 5 && it != end; ++n, ++it) {
+                    const auto d = hex_value(*it);
+                    if (d < 0) {
+                        break;
+                    }
+                    v = v << 4 | static_cast<unsigned>(d);
+                }
+                return n;
+            }
+            static int _hex_group(const char*& it,
+                                  const char* end,
+                                  unsigned& v)
+            {
+                const auto w = swar::load(it, end - it);
+                const auto mask = swar::movemask(swar::hex_digit_mask(w));
+                const auto n = (std::min)(countr_zero(~mask), 5);
+                const auto nibbles = swar::hex_nibbles(w);
+                v = 0;
+                for (int i = 0; i < n; ++i) {
+                    v = v << 4 | swar::byte(nibbles, i);
+                }
+                it += n;
+                return n;
+            }
+
+            // The common case of a dotted-quad, from the bitmasks of the
+            // digits and the dots in the first 16 characters
+            static bool _ipv4_swar(const char*& it,
+                                   const char* end,
+                                   ipv4_address& a)
+            {
+                const auto n = end - it;
+                if (n < 7) {
+                    return false;
+                }
+                const auto lo = swar::load(it, n);
+                const auto hi = n > 8 ? swar::load(it + 8, n - 8) : 0;
+                const auto digits = swar::movemask(swar::digit_mask(lo)) |
+                                    swar::movemask(swar::digit_mask(hi)) << 8;
+                const auto dots =
+                    swar::movemask(swar::in_range(lo, '.', '.')) |
+                    swar::movemask(swar::in_range(hi, '.', '.')) << 8;
+                const auto chars = digits | dots;
+                if (chars == 0xffffu) {
+                    return false;
+                }
+                const auto len = countr_zero(~chars);
+                auto d = dots & ((1u << len) - 1);
+                if (popcount(d) != 3) {
+                    return false;
+                }
+                int starts[5] = {0, 0, 0, 0, len + 1};
+                for (int i = 1; i < 4; ++i) {
+                    starts[i] = countr_zero(d) + 1;
+                    d &= d - 1;
+                }
+                for (std::size_t i = 0; i < 4; ++i) {
+                    const auto p = it + starts[i];
+                    const auto group_len = starts[i + 1] - starts[i] - 1;
+                    if (group_len < 1 || group_len > 3 ||
+                        (group_len > 1 && p[0] == '0')) {
+                        return false;
+                    }
+                    int v = p[0] - '0';
+                    for (int j = 1; j < group_len; ++j) {
+                        v = v * 10 + (p[j] - '0');
+                    }
+                    if (v > 255) {
+                        return false;
+                    }
+                    a.bytes[i] = static_cast<unsigned char>(v);
+                }
+                it += len;
+                return true;
+            }
+            static bool _ipv4_swar(const wchar_t*&,
+                                   const wchar_t*,
+                                   ipv4_address&)
+            {
+                return false;
+            }
+
+            // xx:xx:xx:xx:xx:xx as two 8-character words, around the ':'
+            // in the middle
+            static bool _mac_swar(const char*& it,
+                                  const char* end,
+                                  mac_address& a)
+            {
+                if (end - it < 17 || (it[2] != ':' && it[2] != '-') ||
+                    it[8] != it[2]) {
+                    return false;
+                }
+                constexpr uint64_t sep_bytes = UINT64_C(0x0000ff0000ff0000);
+                const auto seps = UINT64_C(0x0101010101010101) *
+                                  static_cast<unsigned char>(it[2]) &
+                                  sep_bytes;
+                const auto w0 = swar::load8(it);
+                const auto w1 = swar::load8(it + 9);
+                // bytes 0, 1, 3, 4, 6 and 7
+                constexpr unsigned hex_bytes = 0xdbu;
+                if ((w0 & sep_bytes) != seps || (w1 & sep_bytes) != seps ||
+                    (swar::movemask(swar::hex_digit_mask(w0)) & hex_bytes) !=
+                        hex_bytes ||
+                    (swar::movemask(swar::hex_digit_mask(w1)) & hex_bytes) !=
+                        hex_bytes) {
+                    return false;
+                }
+                const auto n0 = swar::hex_nibbles(w0);
+                const auto n1 = swar::hex_nibbles(w1);
+                for (std::size_t i = 0; i < 3; ++i) {
+                    const auto b = static_cast<int>(3 * i);
+                    a.bytes[i] = static_cast<unsigned char>(
+                        swar::byte(n0, b) << 4 | swar::byte(n0, b + 1));
+                    a.bytes[i + 3] = static_cast<unsigned char>(
+                        swar::byte(n1, b) << 4 | swar::byte(n1, b + 1));
+                }
+                it += 17;
+                return true;
+            }
+            static bool _mac_swar(const wchar_t*&,
+                                  const wchar_t*,
+                                  mac_address&)
+            {
+                return false;
+            }
+        };
+
+        struct address_scanner : public empty_parser {
+            // `val` is written only if the whole address is valid
+            template <typename T, typename Context>
+            error scan(T& val, Context& ctx)
+            {
+                using char_type = typename Context::char_type;
+
+                T tmp{};
+                auto e = read_with_parser(
+                    ctx.range(),
+                    [&](const char_type* b, const char_type* end) {
+                        return net_parser<char_type>::address(b, end, tmp);
+                    },
+                    max_chars);
+                if (!e) {
+                    return e;
+                }
+                val = tmp;
+                return {};
+            }
+
+            // The longest address, with a prefix length
+            static constexpr std::size_t max_chars = 64;
+        };
+    }  // namespace detail
+
+    template <typename CharT>
+    struct scanner<CharT, ipv4_address> : public detail::address_scanner {
+    };
+    template <typename CharT>
+    struct scanner<CharT, ipv6_address> : public detail::address_scanner {
+    };
+    template <typename CharT>
+    struct scanner<CharT, ip_address> : public detail::address_scanner {
+    };
+    template <typename CharT, typename Address>
+    struct scanner<CharT, cidr<Address>> : public detail::address_scanner {
+    };
+    template <typename CharT>
+    struct scanner<CharT, mac_address> : public detail::address_scanner {
+    };
+
+    /// @}
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_NET_H
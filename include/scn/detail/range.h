@@ -136,6 +136,13 @@ namespace scn {
                 return ranges::end(m_range);
             }
 
+            /**
+             * Advances by `n` characters.
+             * The iterators of a caching range share their position,
+             * which is moved by stepping them: this only counts the
+             * characters, for callers stepping an iterator of their own.
+             * See \ref step and \ref step_back otherwise.
+             */
             iterator advance(difference_type n = 1) noexcept
             {
                 m_read += n;
@@ -144,6 +151,36 @@ namespace scn {
                 }
                 return m_begin;
             }
+            /**
+             * Advances by `n` characters, moving the position of a caching
+             * range, too.
+             */
+            iterator step(difference_type n = 1)
+            {
+                if (!is_caching_range<Range>::value) {
+                    return advance(n);
+                }
+                m_read += n;
+                for (; n > 0; --n) {
+                    ++m_begin;
+                }
+                return m_begin;
+            }
+            /**
+             * Goes back `n` characters, moving the position of a caching
+             * range, too.
+             */
+            iterator step_back(difference_type n = 1)
+            {
+                if (!is_caching_range<Range>::value) {
+                    return advance(-n);
+                }
+                m_read -= n;
+                for (; n > 0; --n) {
+                    --m_begin;
+                }
+                return m_begin;
+            }
             template <typename R = Range,
                       typename std::enable_if<
                           ranges::sized_range<R>::value>::type* = nullptr>
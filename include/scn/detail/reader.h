@@ -22,9 +22,14 @@
 #include "locale.h"
 #include "range.h"
 #include "result.h"
+#include "scanset.h"
+#include "simd.h"
 #include "small_vector.h"
 #include "span.h"
 
+#include <algorithm>
+#include <cwchar>
+
 namespace scn {
     SCN_BEGIN_NAMESPACE
 
@@ -70,7 +75,7 @@ namespace scn {
         }
         auto ch = *r.begin();
         if (ch) {
-            r.advance();
+            r.step();
         }
         return ch;
     }
@@ -231,7 +236,8 @@ namespace scn {
                 return tmp.error();
             }
             *it = tmp.value();
-            r.advance();
+            ++it;
+            r.step();
         }
         return {};
     }
@@ -349,6 +355,8 @@ namespace scn {
                 if (keep_final_space) {
                     *out = ch;
                     ++out;
+                    ++it;
+                    r.advance();
                 }
                 return {};
             }
@@ -371,9 +379,15 @@ namespace scn {
         if (r.begin() == r.end()) {
             return error(error::end_of_range, "EOF");
         }
+        bool read_any = false;
         for (auto it = r.begin(); it != r.end(); ++it, (void)r.advance()) {
             auto tmp = *it;
             if (!tmp) {
+                // EOF after reading something ends the word,
+                // like the end of a string would
+                if (read_any && tmp.error() == error::end_of_range) {
+                    return {};
+                }
                 return tmp.error();
             }
             auto ch = tmp.value();
@@ -381,17 +395,209 @@ namespace scn {
                 if (keep_final_space) {
                     *out = ch;
                     ++out;
+                    ++it;
+                    r.advance();
                 }
                 return {};
             }
             *out = ch;
             ++out;
+            read_any = true;
+        }
+        return {};
+    }
+
+    /// @}
+
+    namespace detail {
+        inline const char* find_until(const char* begin,
+                                      const char* end,
+                                      char ch) noexcept
+        {
+            return find_char(begin, end, ch);
+        }
+        inline const wchar_t* find_until(const wchar_t* begin,
+                                         const wchar_t* end,
+                                         wchar_t ch) noexcept
+        {
+            if (begin == end) {
+                return end;
+            }
+            auto p = std::wmemchr(begin, ch, static_cast<size_t>(end - begin));
+            return p ? p : end;
+        }
+    }  // namespace detail
+
+    // read_until_char_zero_copy
+
+    /// @{
+    /**
+     * Reads characters from `r` until `until` is found, and returns a `span`
+     * into the range.
+     * Equivalent to `read_until_space_zero_copy` with a predicate comparing
+     * against `until`, but searches the range in bulk (with `memchr`, or a
+     * vectorized kernel, see \ref simd).
+     * If `r.begin() == r.end()`, returns EOF.
+     * If the range does not satisfy `contiguous_range`,
+     * returns an empty `span`.
+     *
+     * \param keep_final Whether the found `until` is included in the returned
+     *                   span, and is advanced past.
+     */
+    template <
+        typename WrappedRange,
+        typename CharT,
+        typename std::enable_if<WrappedRange::is_contiguous>::type* = nullptr>
+    expected<span<const typename detail::extract_char_type<
+        typename WrappedRange::iterator>::type>>
+    read_until_char_zero_copy(WrappedRange& r, CharT until, bool keep_final)
+    {
+        using char_type = typename detail::extract_char_type<
+            typename WrappedRange::iterator>::type;
+
+        if (r.begin() == r.end()) {
+            return error(error::end_of_range, "EOF");
+        }
+        const auto b = r.data();
+        const auto e = b + r.size();
+        auto it = detail::find_until(b, e, static_cast<char_type>(until));
+        if (it != e && keep_final) {
+            ++it;
+        }
+        r.advance(it - b);
+        return {{b, it}};
+    }
+    template <
+        typename WrappedRange,
+        typename CharT,
+        typename std::enable_if<!WrappedRange::is_contiguous>::type* = nullptr>
+    expected<span<const typename detail::extract_char_type<
+        typename WrappedRange::iterator>::type>>
+    read_until_char_zero_copy(WrappedRange& r, CharT, bool)
+    {
+        if (r.begin() == r.end()) {
+            return error(error::end_of_range, "EOF");
+        }
+        return span<const typename detail::extract_char_type<
+            typename WrappedRange::iterator>::type>{};
+    }
+    /// @}
+
+    // read_until_char
+
+    /// @{
+    /**
+     * Reads characters from `r` until `until` is found, and writes them into
+     * `out`.
+     * Equivalent to `read_until_space` with a predicate comparing against
+     * `until`, but searches contiguous ranges in bulk.
+     * If `r.begin() == r.end()`, returns EOF.
+     *
+     * \param keep_final Whether the found `until` is written into `out`, and
+     *                   is advanced past.
+     */
+    template <
+        typename WrappedRange,
+        typename OutputIterator,
+        typename CharT,
+        typename std::enable_if<WrappedRange::is_contiguous>::type* = nullptr>
+    error read_until_char(WrappedRange& r,
+                          OutputIterator& out,
+                          CharT until,
+                          bool keep_final)
+    {
+        auto s = read_until_char_zero_copy(r, until, keep_final);
+        if (!s) {
+            return s.error();
         }
+        out = std::copy(s.value().begin(), s.value().end(), out);
         return {};
     }
+    template <
+        typename WrappedRange,
+        typename OutputIterator,
+        typename CharT,
+        typename std::enable_if<!WrappedRange::is_contiguous>::type* = nullptr>
+    error read_until_char(WrappedRange& r,
+                          OutputIterator& out,
+                          CharT until,
+                          bool keep_final)
+    {
+        using char_type = typename detail::extract_char_type<
+            typename WrappedRange::iterator>::type;
+        return read_until_space(
+            r, out, [until](char_type ch) { return ch == until; },
+            keep_final);
+    }
+    /// @}
 
+    // read_scanset_zero_copy
+
+    /// @{
+    /**
+     * Reads the longest run of characters in `set` from `r`, and returns a
+     * `span` into the range. The run may be empty.
+     * If `r.begin() == r.end()`, returns EOF.
+     * If the range does not satisfy `contiguous_range`,
+     * returns an empty `span`.
+     */
+    template <
+        typename WrappedRange,
+        typename std::enable_if<WrappedRange::is_contiguous>::type* = nullptr>
+    expected<span<const typename detail::extract_char_type<
+        typename WrappedRange::iterator>::type>>
+    read_scanset_zero_copy(WrappedRange& r, const detail::scanset& set)
+    {
+        if (r.begin() == r.end()) {
+            return error(error::end_of_range, "EOF");
+        }
+        const auto b = r.data();
+        const auto it = set.find_first_not_of(b, b + r.size());
+        r.advance(it - b);
+        return {{b, it}};
+    }
+    template <
+        typename WrappedRange,
+        typename std::enable_if<!WrappedRange::is_contiguous>::type* = nullptr>
+    expected<span<const typename detail::extract_char_type<
+        typename WrappedRange::iterator>::type>>
+    read_scanset_zero_copy(WrappedRange& r, const detail::scanset&)
+    {
+        if (r.begin() == r.end()) {
+            return error(error::end_of_range, "EOF");
+        }
+        return span<const typename detail::extract_char_type<
+            typename WrappedRange::iterator>::type>{};
+    }
     /// @}
 
+    // read_scanset
+
+    /**
+     * Reads the longest run of characters in `set` from `r`, and writes them
+     * into `out`. The run may be empty.
+     * If `r.begin() == r.end()`, returns EOF.
+     */
+    template <typename WrappedRange, typename OutputIterator>
+    error read_scanset(WrappedRange& r,
+                       OutputIterator& out,
+                       const detail::scanset& set)
+    {
+        if (WrappedRange::is_contiguous) {
+            auto s = read_scanset_zero_copy(r, set);
+            if (!s) {
+                return s.error();
+            }
+            out = std::copy(s.value().begin(), s.value().end(), out);
+            return {};
+        }
+        using char_type = typename detail::extract_char_type<
+            typename WrappedRange::iterator>::type;
+        return read_until_space(
+            r, out, [&set](char_type ch) { return !set.contains(ch); },
+            false);
+    }
+
     // read_until_space_ranged
 
     /// @{
@@ -427,6 +633,8 @@ namespace scn {
                 if (keep_final_space) {
                     *out = ch;
                     ++out;
+                    ++it;
+                    r.advance();
                 }
                 return {};
             }
@@ -461,6 +669,8 @@ namespace scn {
                 if (keep_final_space) {
                     *out = ch;
                     ++out;
+                    ++it;
+                    r.advance();
                 }
                 return {};
             }
@@ -478,7 +688,7 @@ namespace scn {
 
     /**
      * Puts back `n` characters into `r` as if by repeatedly calling
-     * `r.advance(-1)` .
+     * `r.step_back()` .
      */
     template <
         typename WrappedRange,
@@ -499,7 +709,7 @@ namespace scn {
     {
         for (detail::ranges::range_difference_t<WrappedRange> i = 0; i < n;
              ++i) {
-            r.advance(-1);
+            r.step_back();
             if (r.begin() == r.end()) {
                 return error(error::unrecoverable_source_error,
                              "Putback failed");
@@ -510,6 +720,75 @@ namespace scn {
 
     /// @}
 
+    // read_with_parser
+
+    /// @{
+
+    /**
+     * Reads a value, which determines its own end (like a date or a network
+     * address), with `parse(begin, end) -> expected<const CharT*>`, which
+     * returns a pointer past the value.
+     * On a contiguous range, `parse` is given the rest of `r`, and on other
+     * ranges, the rest of the line, at most `max_chars` characters of it.
+     * The characters after the value are put back.
+     */
+    template <
+        typename WrappedRange,
+        typename Parse,
+        typename std::enable_if<WrappedRange::is_contiguous>::type* = nullptr>
+    error read_with_parser(WrappedRange& r, Parse parse, std::size_t = 0)
+    {
+        auto s = read_all_zero_copy(r);
+        if (!s) {
+            return s.error();
+        }
+        const auto end = s.value().data() + s.value().size();
+        auto ret = parse(s.value().data(), end);
+        if (!ret) {
+            return ret.error();
+        }
+        if (ret.value() != end) {
+            return putback_n(r, end - ret.value());
+        }
+        return {};
+    }
+    template <
+        typename WrappedRange,
+        typename Parse,
+        typename std::enable_if<!WrappedRange::is_contiguous>::type* = nullptr>
+    error read_with_parser(WrappedRange& r,
+                           Parse parse,
+                           std::size_t max_chars = 256)
+    {
+        using char_type = typename WrappedRange::char_type;
+
+        detail::small_vector<char_type, 64> buf;
+        auto is_end_pred = [&](char_type ch) {
+            return ch == detail::ascii_widen<char_type>('\n') ||
+                   buf.size() >= max_chars;
+        };
+        auto outputit = std::back_inserter(buf);
+        auto e = read_until_space(r, outputit, is_end_pred, false);
+        if (buf.empty()) {
+            if (!e) {
+                return e;
+            }
+            return error(error::invalid_scanned_value,
+                         "Expected a value, got an empty line");
+        }
+        const auto end = buf.data() + buf.size();
+        auto ret = parse(static_cast<const char_type*>(buf.data()), end);
+        if (!ret) {
+            return ret.error();
+        }
+        if (ret.value() != end) {
+            return putback_n(r, end - ret.value());
+        }
+        return {};
+    }
+
+    /// @}
+
     // scan_low
     /// @}
 
@@ -566,6 +845,93 @@ namespace scn {
             }
         };
 
+        template <typename CharT>
+        bool is_ascii_alnum(CharT ch)
+        {
+            return (ch >= ascii_widen<CharT>('0') &&
+                    ch <= ascii_widen<CharT>('9')) ||
+                   (ch >= ascii_widen<CharT>('a') &&
+                    ch <= ascii_widen<CharT>('z')) ||
+                   (ch >= ascii_widen<CharT>('A') &&
+                    ch <= ascii_widen<CharT>('Z'));
+        }
+
+        /**
+         * Output iterator writing the first `size` characters written through
+         * it into `buf`, and counting all of them
+         */
+        template <typename CharT>
+        struct prefix_output_iterator {
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            prefix_output_iterator(CharT* b, std::ptrdiff_t s)
+                : buf(b), size(s)
+            {
+            }
+
+            prefix_output_iterator& operator*()
+            {
+                return *this;
+            }
+            prefix_output_iterator& operator=(CharT ch)
+            {
+                if (count < size) {
+                    buf[count] = ch;
+                }
+                ++count;
+                return *this;
+            }
+            prefix_output_iterator& operator++()
+            {
+                return *this;
+            }
+            prefix_output_iterator& operator++(int)
+            {
+                return *this;
+            }
+
+            CharT* buf;
+            std::ptrdiff_t size;
+            std::ptrdiff_t count{0};
+        };
+
+        /**
+         * Appends characters to a string in chunks: they're gathered into an
+         * array, which is bulk-copied to the end of the string when full, or
+         * on `flush()`, instead of calling `push_back` for every character.
+         */
+        template <typename String>
+        class bulk_appender {
+        public:
+            using value_type = typename String::value_type;
+
+            explicit bulk_appender(String& s) : m_str(std::addressof(s)) {}
+
+            void push_back(value_type ch)
+            {
+                if (m_size == chunk_size) {
+                    flush();
+                }
+                m_buf[m_size++] = ch;
+            }
+            void flush()
+            {
+                m_str->insert(m_str->end(), m_buf, m_buf + m_size);
+                m_size = 0;
+            }
+
+        private:
+            static constexpr std::size_t chunk_size = 64;
+
+            String* m_str;
+            value_type m_buf[chunk_size];
+            std::size_t m_size{0};
+        };
+
         struct buffer_scanner : public empty_parser {
             template <typename Context>
             error scan(span<typename Context::char_type>& val, Context& ctx)
@@ -589,16 +955,8 @@ namespace scn {
                     return {};
                 }
 
-                small_vector<char_type, 32> buf(val.size());
-                auto it = buf.begin();
-                auto e = read_into(ctx.range(), it, val.ssize());
-                if (!e) {
-                    return e;
-                }
-                buf.erase(it);
-                std::memcpy(val.begin(), buf.begin(),
-                            buf.size() * sizeof(char_type));
-                return {};
+                auto it = val.begin();
+                return read_into(ctx.range(), it, val.ssize());
             }
         };
 
@@ -669,29 +1027,33 @@ namespace scn {
                     }
                     const auto max_len =
                         detail::max(truename.size(), falsename.size());
-                    std::basic_string<char_type> buf;
-                    buf.reserve(max_len);
+                    // Only the beginning of the word is compared,
+                    // the rest of it is only counted
+                    small_vector<char_type, 16> buf(max_len);
 
-                    auto tmp_it = std::back_inserter(buf);
+                    auto tmp_it = prefix_output_iterator<char_type>{
+                        buf.data(), static_cast<std::ptrdiff_t>(max_len)};
                     auto e = read_until_space(
                         ctx.range(), tmp_it,
                         [&ctx](char_type ch) {
-                            return ctx.locale().is_space(ch);
+                            return ctx.locale().is_space(ch) ||
+                                   ctx.is_delimiter(ch);
                         },
                         false);
                     if (!e) {
                         return e;
                     }
+                    const auto len = static_cast<size_t>(tmp_it.count);
 
                     bool found = false;
-                    if (buf.size() >= falsename.size()) {
+                    if (len >= falsename.size()) {
                         if (std::equal(falsename.begin(), falsename.end(),
                                        buf.begin())) {
                             val = false;
                             found = true;
                         }
                     }
-                    if (!found && buf.size() >= truename.size()) {
+                    if (!found && len >= truename.size()) {
                         if (std::equal(truename.begin(), truename.end(),
                                        buf.begin())) {
                             val = true;
@@ -702,9 +1064,7 @@ namespace scn {
                         return {};
                     }
                     else {
-                        auto pb =
-                            putback_n(ctx.range(),
-                                      static_cast<std::ptrdiff_t>(buf.size()));
+                        auto pb = putback_n(ctx.range(), tmp_it.count);
                         if (!pb) {
                             return pb;
                         }
@@ -741,7 +1101,7 @@ namespace scn {
 
         template <typename T>
         struct integer_scanner {
-            static_assert(std::is_integral<T>::value, "");
+            static_assert(is_integer<T>::value, "");
 
             template <typename ParseCtx>
             error parse(ParseCtx& pctx)
@@ -778,7 +1138,7 @@ namespace scn {
                             continue;
                         }
                         else if (ch == detail::ascii_widen<char_type>('i')) {
-                            if (std::is_unsigned<T>::value) {
+                            if (!is_signed_integer<T>::value) {
                                 return error(
                                     error::invalid_format_string,
                                     "'i' format specifier expects signed "
@@ -789,7 +1149,7 @@ namespace scn {
                             continue;
                         }
                         else if (ch == detail::ascii_widen<char_type>('u')) {
-                            if (std::is_signed<T>::value) {
+                            if (is_signed_integer<T>::value) {
                                 return error(
                                     error::invalid_format_string,
                                     "'u' format specifier expects unsigned "
@@ -882,6 +1242,11 @@ namespace scn {
                         error::invalid_format_string,
                         "Localized integers can only be scanned in base 10");
                 }
+                if (is_int128<T>::value && (localized & digits) != 0) {
+                    return error(error::invalid_format_string,
+                                 "Localized digits aren't supported with "
+                                 "128-bit integers");
+                }
                 if (!pctx.check_arg_end()) {
                     return error(error::invalid_format_string,
                                  "Expected argument end");
@@ -898,10 +1263,10 @@ namespace scn {
                     T tmp = 0;
                     expected<std::ptrdiff_t> ret{0};
                     if (SCN_UNLIKELY((localized & digits) != 0)) {
-                        SCN_CLANG_PUSH_IGNORE_UNDEFINED_TEMPLATE
-                        std::basic_string<char_type> str(s.data(), s.size());
-                        ret = ctx.locale().read_num(tmp, str);
-                        SCN_CLANG_POP_IGNORE_UNDEFINED_TEMPLATE
+                        ret = _read_localized(
+                            tmp,
+                            basic_string_view<char_type>{s.data(), s.size()},
+                            ctx, is_int128<T>{});
                     }
                     else {
                         ret = _parse_int(tmp, s,
@@ -922,10 +1287,6 @@ namespace scn {
                     return {};
                 };
 
-                auto is_space_pred = [&ctx](char_type ch) {
-                    return ctx.locale().is_space(ch);
-                };
-
                 if (Context::range_type::is_contiguous) {
                     auto s = read_all_zero_copy(ctx.range());
                     if (!s) {
@@ -934,12 +1295,31 @@ namespace scn {
                     return do_parse_int(s.value());
                 }
 
-                small_vector<char_type, 32> buf;
+                // Characters that can't be a part of an integer would be put
+                // back after parsing, so stop reading at them
+                const bool check_chars = (localized & digits) == 0;
+                const auto thsep = ctx.locale().thousands_separator();
+                const bool allow_thsep = have_thsep || localized != 0;
+                auto is_end_pred = [&](char_type ch) {
+                    if (ctx.locale().is_space(ch) || ctx.is_delimiter(ch)) {
+                        return true;
+                    }
+                    return check_chars && !is_ascii_alnum(ch) &&
+                           ch != detail::ascii_widen<char_type>('-') &&
+                           ch != detail::ascii_widen<char_type>('+') &&
+                           !(allow_thsep && ch == thsep);
+                };
+
+                small_vector<char_type, 64> buf;
                 auto outputit = std::back_inserter(buf);
-                auto e = read_until_space(ctx.range(), outputit, is_space_pred,
-                                          false);
-                if (!e && buf.empty()) {
-                    return e;
+                auto e =
+                    read_until_space(ctx.range(), outputit, is_end_pred, false);
+                if (buf.empty()) {
+                    if (!e) {
+                        return e;
+                    }
+                    return error(error::invalid_scanned_value,
+                                 "Expected an integer");
                 }
 
                 return do_parse_int(make_span(buf).as_const());
@@ -954,6 +1334,30 @@ namespace scn {
             uint8_t localized{0};
             bool have_thsep{false};
 
+            template <typename CharT, typename Context>
+            static expected<std::ptrdiff_t> _read_localized(
+                T& val,
+                basic_string_view<CharT> s,
+                Context& ctx,
+                std::false_type)
+            {
+                SCN_CLANG_PUSH_IGNORE_UNDEFINED_TEMPLATE
+                return ctx.locale().read_num(val, s);
+                SCN_CLANG_POP_IGNORE_UNDEFINED_TEMPLATE
+            }
+            // Rejected by parse(): the locale can't read 128-bit integers
+            template <typename CharT, typename Context>
+            static expected<std::ptrdiff_t> _read_localized(
+                T&,
+                basic_string_view<CharT>,
+                Context&,
+                std::true_type)
+            {
+                return error(error::invalid_format_string,
+                             "Localized digits aren't supported with "
+                             "128-bit integers");
+            }
+
             template <typename CharT>
             expected<std::ptrdiff_t> _parse_int(T& val,
                                                 span<const CharT> s,
@@ -963,7 +1367,7 @@ namespace scn {
                 SCN_MSVC_IGNORE(4244)
                 SCN_MSVC_IGNORE(4127)  // conditional expression is constant
 
-                if (std::is_unsigned<T>::value) {
+                if (!is_signed_integer<T>::value) {
                     if (s[0] == detail::ascii_widen<CharT>('-')) {
                         return error(error::value_out_of_range,
                                      "Unexpected sign '-' when scanning an "
@@ -1071,7 +1475,17 @@ namespace scn {
                 SCN_MSVC_IGNORE(4389)  // == signed/unsigned mismatch
                 SCN_MSVC_IGNORE(4244)  // lossy conversion
 
-                using utype = typename std::make_unsigned<T>::type;
+                if (!have_thsep) {
+                    if (base == 16 || base == 8) {
+                        return _read_pow2(val, minus_sign, buf);
+                    }
+                    if (is_int128<T>::value && base == 10) {
+                        return _read_dec128(val, minus_sign, buf,
+                                            is_int128<T>{});
+                    }
+                }
+
+                using utype = typename make_unsigned<T>::type;
 
                 const auto ubase = static_cast<utype>(base);
                 SCN_ASSUME(ubase > 0);
@@ -1082,7 +1496,7 @@ namespace scn {
 
                 const auto cut = div(
                     [&]() -> utype {
-                        if (std::is_signed<T>::value) {
+                        if (is_signed_integer<T>::value) {
                             if (minus_sign) {
                                 return abs_int_min;
                             }
@@ -1119,6 +1533,10 @@ namespace scn {
                     }
                 }
                 else {
+                    for (const auto e = _unchecked_digits_end(it, end); it != e;
+                         ++it) {
+                        val = val * 10 + (*it - ascii_widen<CharT>('0'));
+                    }
                     for (; it != end; ++it) {
                         const auto digit = _char_to_int(*it);
                         if (digit >= ubase) {
@@ -1144,39 +1562,359 @@ namespace scn {
                 SCN_GCC_POP
             }
 
-            unsigned char _char_to_int(char ch) const
+            /*
+             * End of the leading decimal digits of `[it, end)` that can be
+             * read without overflow checks: the run of digits is found with
+             * the vectorized `find_non_digit`, and every digit of it fits,
+             * if there are at most `digits10` of them after the leading
+             * zeros. Only for `char`, in base 10.
+             */
+            const char* _unchecked_digits_end(const char* it,
+                                              const char* end) const
             {
-                static constexpr unsigned char digits_arr[] = {
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   255, 255,
-                    255, 255, 255, 255, 255, 10,  11,  12,  13,  14,  15,  16,
-                    17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,
-                    29,  30,  31,  32,  33,  34,  35,  255, 255, 255, 255, 255,
-                    255, 10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,
-                    21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,  32,
-                    33,  34,  35,  255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
-                    255, 255, 255, 255};
-                return digits_arr[static_cast<unsigned char>(ch)];
+                if (base != 10) {
+                    return it;
+                }
+                const auto digits_end = find_non_digit(it, end);
+                auto first = it;
+                while (first != digits_end && *first == '0') {
+                    ++first;
+                }
+                constexpr auto max_digits = std::numeric_limits<T>::digits10;
+                return digits_end - first <= max_digits ? digits_end
+                                                        : first + max_digits;
             }
-            unsigned char _char_to_int(wchar_t ch) const
+            template <typename CharT>
+            const CharT* _unchecked_digits_end(const CharT* it,
+                                               const CharT*) const
+            {
+                return it;
+            }
+
+            /*
+             * Bases 16 and 8: digits are shifted into an accumulator of at
+             * least 64 bits, with 8 digits at a time for `char`, and
+             * overflow shows up as set high bits, instead of needing a
+             * cutoff computed with a division.
+             */
+            template <typename CharT>
+            expected<const CharT*> _read_pow2(T& val,
+                                              bool minus_sign,
+                                              span<const CharT> buf) const
             {
                 SCN_GCC_PUSH
                 SCN_GCC_IGNORE("-Wconversion")
-                if (ch >= std::numeric_limits<char>::min() &&
-                    ch <= std::numeric_limits<char>::max()) {
+                SCN_GCC_IGNORE("-Wsign-conversion")
+
+                SCN_CLANG_PUSH
+                SCN_CLANG_IGNORE("-Wconversion")
+                SCN_CLANG_IGNORE("-Wsign-conversion")
+
+                SCN_MSVC_PUSH
+                SCN_MSVC_IGNORE(4244)  // lossy conversion
+
+                using utype = typename make_unsigned<T>::type;
+                using acc_type = typename std::conditional<
+                    (sizeof(utype) > sizeof(uint64_t)), utype,
+                    uint64_t>::type;
+
+                constexpr auto uint_max = static_cast<utype>(-1);
+                constexpr auto max = is_signed_integer<T>::value
+                                         ? static_cast<utype>(uint_max >> 1)
+                                         : uint_max;
+
+                auto it = buf.begin();
+                const auto end = buf.end();
+                while (it != end && *it == ascii_widen<CharT>('0')) {
+                    ++it;
+                }
+
+                auto r = _pow2_blocks(it, end, acc_type{0});
+                if (!r.overflow) {
+                    r = _pow2_digits(r.end, end, r.value);
+                }
+                const auto limit =
+                    static_cast<acc_type>(minus_sign ? max + 1 : max);
+                if (SCN_UNLIKELY(r.overflow || r.value > limit)) {
+                    if (!minus_sign) {
+                        return error(error::value_out_of_range,
+                                     "Out of range: integer overflow");
+                    }
+                    return error(error::value_out_of_range,
+                                 "Out of range: integer underflow");
+                }
+                const auto u = static_cast<utype>(r.value);
+                val = static_cast<T>(minus_sign ? 0 - u : u);
+                return r.end;
+
+                SCN_MSVC_POP
+                SCN_CLANG_POP
+                SCN_GCC_POP
+            }
+
+            template <typename CharT, typename Acc>
+            struct pow2_result {
+                const CharT* end;
+                Acc value;
+                bool overflow;
+            };
+
+            // Whole blocks of 8 digits, with SWAR
+            template <typename Acc>
+            pow2_result<char, Acc> _pow2_blocks(const char* it,
+                                                const char* end,
+                                                Acc acc) const
+            {
+                constexpr int acc_bits = static_cast<int>(sizeof(Acc)) * 8;
+                if (base == 16) {
+                    for (; end - it >= 8; it += 8) {
+                        const auto v = swar::load8(it);
+                        if (!swar::is_8_hex_digits(v)) {
+                            break;
+                        }
+                        if ((acc >> (acc_bits - 32)) != 0) {
+                            return {it, acc, true};
+                        }
+                        acc = (acc << 32) | swar::parse_8_hex_digits(v);
+                    }
+                }
+                else {
+                    for (; end - it >= 8; it += 8) {
+                        const auto v = swar::load8(it);
+                        if (!swar::is_8_octal_digits(v)) {
+                            break;
+                        }
+                        if ((acc >> (acc_bits - 24)) != 0) {
+                            return {it, acc, true};
+                        }
+                        acc = (acc << 24) | swar::parse_8_octal_digits(v);
+                    }
+                }
+                return {it, acc, false};
+            }
+            template <typename CharT, typename Acc>
+            pow2_result<CharT, Acc> _pow2_blocks(const CharT* it,
+                                                 const CharT*,
+                                                 Acc acc) const
+            {
+                return {it, acc, false};
+            }
+
+            // The rest of the digits, one at a time
+            template <typename CharT, typename Acc>
+            pow2_result<CharT, Acc> _pow2_digits(const CharT* it,
+                                                 const CharT* end,
+                                                 Acc acc) const
+            {
+                constexpr int acc_bits = static_cast<int>(sizeof(Acc)) * 8;
+                const int shift = base == 16 ? 4 : 3;
+                const auto ubase = static_cast<unsigned>(base);
+                for (; it != end; ++it) {
+                    const unsigned digit = _char_to_int(*it);
+                    if (digit >= ubase) {
+                        break;
+                    }
+                    if ((acc >> (acc_bits - shift)) != 0) {
+                        return {it, acc, true};
+                    }
+                    acc = (acc << shift) | digit;
+                }
+                return {it, acc, false};
+            }
+
+            template <typename CharT>
+            expected<const CharT*> _read_dec128(T&,
+                                                bool,
+                                                span<const CharT>,
+                                                std::false_type) const
+            {
+                SCN_UNREACHABLE;
+            }
+#if SCN_HAS_INT128
+            /*
+             * A decimal 128-bit integer has at most 39 digits. The first 38
+             * are read as two chunks of at most 19 digits, which always fit
+             * in 64 bits, and are combined with a single 64x64-bit
+             * multiplication. Only the 39th digit can overflow, and it's
+             * checked against constant limits, so that no 128-bit division
+             * is needed at runtime.
+             */
+            template <typename CharT>
+            expected<const CharT*> _read_dec128(T& val,
+                                                bool minus_sign,
+                                                span<const CharT> buf,
+                                                std::true_type) const
+            {
+                SCN_GCC_PUSH
+                SCN_GCC_IGNORE("-Wconversion")
+                SCN_GCC_IGNORE("-Wsign-conversion")
+
+                SCN_CLANG_PUSH
+                SCN_CLANG_IGNORE("-Wconversion")
+                SCN_CLANG_IGNORE("-Wsign-conversion")
+
+                using utype = typename make_unsigned<T>::type;
+
+                constexpr auto uint_max = static_cast<utype>(-1);
+                constexpr auto max = is_signed_integer<T>::value
+                                         ? static_cast<utype>(uint_max >> 1)
+                                         : uint_max;
+                constexpr auto abs_min = static_cast<utype>(max + 1);
+                constexpr utype max_cutoff = max / 10;
+                constexpr unsigned max_cutlim = max % 10;
+                constexpr utype min_cutoff = abs_min / 10;
+                constexpr unsigned min_cutlim = abs_min % 10;
+
+                auto it = buf.begin();
+                const auto end = buf.end();
+
+                // Leading zeroes don't count towards the 39 digits
+                while (it != end && *it == ascii_widen<CharT>('0')) {
+                    ++it;
+                }
+
+                const auto hi = _read_dec_chunk(it, end);
+                utype u = hi.value;
+                it = hi.end;
+                if (hi.digits == max_chunk_digits) {
+                    static constexpr uint64_t pow10[] = {
+                        UINT64_C(1),
+                        UINT64_C(10),
+                        UINT64_C(100),
+                        UINT64_C(1000),
+                        UINT64_C(10000),
+                        UINT64_C(100000),
+                        UINT64_C(1000000),
+                        UINT64_C(10000000),
+                        UINT64_C(100000000),
+                        UINT64_C(1000000000),
+                        UINT64_C(10000000000),
+                        UINT64_C(100000000000),
+                        UINT64_C(1000000000000),
+                        UINT64_C(10000000000000),
+                        UINT64_C(100000000000000),
+                        UINT64_C(1000000000000000),
+                        UINT64_C(10000000000000000),
+                        UINT64_C(100000000000000000),
+                        UINT64_C(1000000000000000000),
+                        UINT64_C(10000000000000000000)};
+
+                    const auto lo = _read_dec_chunk(it, end);
+                    u = u * pow10[lo.digits] + lo.value;
+                    it = lo.end;
+                    if (lo.digits == max_chunk_digits && it != end &&
+                        _char_to_int(*it) < 10) {
+                        const auto cutoff =
+                            minus_sign ? min_cutoff : max_cutoff;
+                        const auto cutlim =
+                            minus_sign ? min_cutlim : max_cutlim;
+                        const unsigned digit = _char_to_int(*it);
+                        ++it;
+                        if (SCN_UNLIKELY(u > cutoff ||
+                                         (u == cutoff && digit > cutlim) ||
+                                         (it != end &&
+                                          _char_to_int(*it) < 10))) {
+                            if (!minus_sign) {
+                                return error(error::value_out_of_range,
+                                             "Out of range: integer overflow");
+                            }
+                            return error(error::value_out_of_range,
+                                         "Out of range: integer underflow");
+                        }
+                        u = u * 10 + digit;
+                    }
+                }
+                val = static_cast<T>(minus_sign ? 0 - u : u);
+                return it;
+
+                SCN_CLANG_POP
+                SCN_GCC_POP
+            }
+#endif
+
+            static constexpr int max_chunk_digits = 19;
+
+            template <typename CharT>
+            struct dec_chunk {
+                const CharT* end;
+                uint64_t value;
+                int digits;
+            };
+
+            // Reads at most `max_chunk_digits` decimal digits
+            static dec_chunk<char> _read_dec_chunk(const char* it,
+                                                   const char* end)
+            {
+                const auto first = it;
+                uint64_t val = 0;
+                while (end - it >= 8 && it - first <= max_chunk_digits - 8) {
+                    const auto v = swar::load8(it);
+                    if (!swar::is_8_digits(v)) {
+                        break;
+                    }
+                    val = val * 100000000 + swar::parse_8_digits(v);
+                    it += 8;
+                }
+                for (; it != end && it - first < max_chunk_digits; ++it) {
+                    const auto d = static_cast<unsigned char>(*it - '0');
+                    if (d > 9) {
+                        break;
+                    }
+                    val = val * 10 + d;
+                }
+                return {it, val, static_cast<int>(it - first)};
+            }
+            template <typename CharT>
+            static dec_chunk<CharT> _read_dec_chunk(const CharT* it,
+                                                    const CharT* end)
+            {
+                const auto first = it;
+                uint64_t val = 0;
+                for (; it != end && it - first < max_chunk_digits; ++it) {
+                    const auto d =
+                        static_cast<uint64_t>(*it) -
+                        static_cast<uint64_t>(ascii_widen<CharT>('0'));
+                    if (d > 9) {
+                        break;
+                    }
+                    val = val * 10 + d;
+                }
+                return {it, val, static_cast<int>(it - first)};
+            }
+
+            unsigned char _char_to_int(char ch) const
+            {
+                static constexpr unsigned char digits_arr[] = {
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    0,   1,   2,   3,   4,   5,   6,   7,   8,   9,   255, 255,
+                    255, 255, 255, 255, 255, 10,  11,  12,  13,  14,  15,  16,
+                    17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,
+                    29,  30,  31,  32,  33,  34,  35,  255, 255, 255, 255, 255,
+                    255, 10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,
+                    21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,  32,
+                    33,  34,  35,  255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+                    255, 255, 255, 255};
+                return digits_arr[static_cast<unsigned char>(ch)];
+            }
+            unsigned char _char_to_int(wchar_t ch) const
+            {
+                SCN_GCC_PUSH
+                SCN_GCC_IGNORE("-Wconversion")
+                if (ch >= std::numeric_limits<char>::min() &&
+                    ch <= std::numeric_limits<char>::max()) {
                     return _char_to_int(static_cast<char>(ch));
                 }
                 return 255;
@@ -1257,8 +1995,9 @@ namespace scn {
                     expected<std::ptrdiff_t> ret{0};
                     if (SCN_UNLIKELY(localized)) {
                         SCN_CLANG_PUSH_IGNORE_UNDEFINED_TEMPLATE
-                        std::basic_string<char_type> str(s.data(), s.size());
-                        ret = ctx.locale().read_num(tmp, str);
+                        ret = ctx.locale().read_num(
+                            tmp, basic_string_view<char_type>{s.data(),
+                                                              s.size()});
                         SCN_CLANG_POP_IGNORE_UNDEFINED_TEMPLATE
                     }
                     else {
@@ -1284,20 +2023,37 @@ namespace scn {
                 };
 
                 if (Context::range_type::is_contiguous) {
-                    auto s = read_until_space_zero_copy(ctx.range(),
-                                                        is_space_pred, false);
+                    auto s = ctx.delimiters()
+                                 ? read_scanset_zero_copy(
+                                       ctx.range(),
+                                       ctx.delimiters()->word_chars())
+                                 : read_until_space_zero_copy(
+                                       ctx.range(), is_space_pred, false);
                     if (!s) {
                         return s.error();
                     }
                     return do_parse_float(s.value());
                 }
 
-                small_vector<char_type, 32> buf;
+                // Characters that can't be a part of a number would be put
+                // back after parsing, so stop reading at them
+                auto is_end_pred = [&](char_type ch) {
+                    if (ctx.locale().is_space(ch) || ctx.is_delimiter(ch)) {
+                        return true;
+                    }
+                    return !localized && !_is_float_char(ch);
+                };
+
+                small_vector<char_type, 64> buf;
                 auto outputit = std::back_inserter(buf);
-                auto e = read_until_space(ctx.range(), outputit, is_space_pred,
-                                          false);
-                if (!e && buf.empty()) {
-                    return e;
+                auto e =
+                    read_until_space(ctx.range(), outputit, is_end_pred, false);
+                if (buf.empty()) {
+                    if (!e) {
+                        return e;
+                    }
+                    return error(error::invalid_scanned_value,
+                                 "Expected a floating-point number");
                 }
 
                 return do_parse_float(make_span(buf).as_const());
@@ -1305,11 +2061,33 @@ namespace scn {
 
             bool localized{false};
 
+            // Characters that can appear in a number accepted by strtod
+            template <typename CharT>
+            static bool _is_float_char(CharT ch)
+            {
+                return is_ascii_alnum(ch) ||
+                       ch == detail::ascii_widen<CharT>('.') ||
+                       ch == detail::ascii_widen<CharT>('-') ||
+                       ch == detail::ascii_widen<CharT>('+') ||
+                       ch == detail::ascii_widen<CharT>('(') ||
+                       ch == detail::ascii_widen<CharT>(')') ||
+                       ch == detail::ascii_widen<CharT>('_');
+            }
+
             template <typename CharT>
             expected<std::ptrdiff_t> _read_float(T& val, span<const CharT> s)
             {
+                // strto* need a null-terminated string:
+                // copy the part of s that can be a part of a number
+                const auto len = static_cast<size_t>(
+                    std::find_if(s.begin(), s.end(),
+                                 [](CharT ch) { return !_is_float_char(ch); }) -
+                    s.begin());
+                small_vector<CharT, 64> str(len + 1);
+                std::copy(s.begin(), s.begin() + len, str.begin());
+                str[len] = CharT{0};
+
                 size_t chars{};
-                std::basic_string<CharT> str(s.data(), s.size());
                 SCN_CLANG_PUSH_IGNORE_UNDEFINED_TEMPLATE
                 auto ret = _read_float_impl(str.data(), chars);
                 SCN_CLANG_POP_IGNORE_UNDEFINED_TEMPLATE
@@ -1324,6 +2102,414 @@ namespace scn {
             expected<T> _read_float_impl(const CharT* str, size_t& chars);
         };
 
+        // Quoting of strings read with the `q` or `Q` format specifier
+        enum class quote_style : unsigned char {
+            none,
+            // "...", with "" as an escaped quote, like in CSV
+            doubled,
+            // "...", with C/JSON backslash escapes
+            backslash
+        };
+
+        /// A string token, as it appears in the source
+        template <typename CharT>
+        struct string_token {
+            string_token() = default;
+            string_token(span<const CharT> c, bool e) : chars(c), escaped(e)
+            {
+            }
+
+            span<const CharT> chars{};
+            // chars contains escape sequences, and needs to be unescaped
+            bool escaped{false};
+        };
+
+        struct string_escapes {
+            template <typename CharT>
+            static int hex_digit(CharT ch) noexcept
+            {
+                if (ch >= ascii_widen<CharT>('0') &&
+                    ch <= ascii_widen<CharT>('9')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('0'));
+                }
+                if (ch >= ascii_widen<CharT>('a') &&
+                    ch <= ascii_widen<CharT>('f')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('a')) + 10;
+                }
+                if (ch >= ascii_widen<CharT>('A') &&
+                    ch <= ascii_widen<CharT>('F')) {
+                    return static_cast<int>(ch - ascii_widen<CharT>('A')) + 10;
+                }
+                return -1;
+            }
+            template <typename CharT>
+            static bool read_hex(const CharT* p,
+                                 const CharT* end,
+                                 int n,
+                                 uint32_t& val) noexcept
+            {
+                if (end - p < n) {
+                    return false;
+                }
+                val = 0;
+                for (int i = 0; i < n; ++i) {
+                    const auto d = hex_digit(p[i]);
+                    if (d < 0) {
+                        return false;
+                    }
+                    val = val * 16 + static_cast<uint32_t>(d);
+                }
+                return true;
+            }
+
+            /**
+             * Decodes the escape sequence after a backslash, beginning at
+             * `p`, into the code point `cp`.
+             * \return The number of characters in the sequence (not
+             * counting the backslash), or 0, if it's invalid or truncated.
+             * A `\u` escape followed by another one is decoded as a
+             * surrogate pair.
+             */
+            template <typename CharT>
+            static std::ptrdiff_t decode(const CharT* p,
+                                         const CharT* end,
+                                         uint32_t& cp) noexcept
+            {
+                if (p == end) {
+                    return 0;
+                }
+                const auto c = static_cast<uint32_t>(p[0]);
+                switch (c) {
+                    case 'b':
+                        cp = 0x08;
+                        return 1;
+                    case 'f':
+                        cp = 0x0c;
+                        return 1;
+                    case 'n':
+                        cp = 0x0a;
+                        return 1;
+                    case 'r':
+                        cp = 0x0d;
+                        return 1;
+                    case 't':
+                        cp = 0x09;
+                        return 1;
+                    case 'v':
+                        cp = 0x0b;
+                        return 1;
+                    case 'a':
+                        cp = 0x07;
+                        return 1;
+                    case '0':
+                        cp = 0;
+                        return 1;
+                    case '"':
+                    case '\'':
+                    case '\\':
+                    case '/':
+                    case '?':
+                        cp = c;
+                        return 1;
+                    case 'x':
+                        return read_hex(p + 1, end, 2, cp) ? 3 : 0;
+                    case 'u':
+                        break;
+                    default:
+                        return 0;
+                }
+                if (!read_hex(p + 1, end, 4, cp)) {
+                    return 0;
+                }
+                if (cp >= 0xdc00 && cp <= 0xdfff) {
+                    // lone low surrogate
+                    return 0;
+                }
+                if (cp < 0xd800 || cp > 0xdbff) {
+                    return 5;
+                }
+                uint32_t lo{};
+                if (end - p < 11 || p[5] != ascii_widen<CharT>('\\') ||
+                    p[6] != ascii_widen<CharT>('u') ||
+                    !read_hex(p + 7, end, 4, lo) || lo < 0xdc00 ||
+                    lo > 0xdfff) {
+                    return 0;
+                }
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                return 11;
+            }
+
+            // Writes `cp` as UTF-8
+            template <typename OutputIt>
+            static void encode(uint32_t cp, OutputIt& out, char)
+            {
+                auto put = [&out](uint32_t v) {
+                    *out = static_cast<char>(static_cast<unsigned char>(v));
+                    ++out;
+                };
+                if (cp < 0x80) {
+                    put(cp);
+                }
+                else if (cp < 0x800) {
+                    put(0xc0 | (cp >> 6));
+                    put(0x80 | (cp & 0x3f));
+                }
+                else if (cp < 0x10000) {
+                    put(0xe0 | (cp >> 12));
+                    put(0x80 | ((cp >> 6) & 0x3f));
+                    put(0x80 | (cp & 0x3f));
+                }
+                else {
+                    put(0xf0 | (cp >> 18));
+                    put(0x80 | ((cp >> 12) & 0x3f));
+                    put(0x80 | ((cp >> 6) & 0x3f));
+                    put(0x80 | (cp & 0x3f));
+                }
+            }
+            // Writes `cp` as UTF-16 or UTF-32, depending on `wchar_t`
+            template <typename OutputIt>
+            static void encode(uint32_t cp, OutputIt& out, wchar_t)
+            {
+                if (sizeof(wchar_t) == 2 && cp >= 0x10000) {
+                    cp -= 0x10000;
+                    *out = static_cast<wchar_t>(0xd800 + (cp >> 10));
+                    ++out;
+                    *out = static_cast<wchar_t>(0xdc00 + (cp & 0x3ff));
+                    ++out;
+                    return;
+                }
+                *out = static_cast<wchar_t>(cp);
+                ++out;
+            }
+
+            /**
+             * Writes the contents of a quoted string, with the escape
+             * sequences (already validated when reading it) decoded,
+             * into `out`
+             */
+            template <typename CharT, typename OutputIt>
+            static void unescape(span<const CharT> s,
+                                 quote_style style,
+                                 OutputIt& out)
+            {
+                const auto quote = ascii_widen<CharT>('"');
+                const auto backslash = ascii_widen<CharT>('\\');
+                const auto end = s.end();
+                for (auto p = s.begin(); p != end; ++p) {
+                    if (style == quote_style::doubled && *p == quote) {
+                        // the first one of ""
+                        ++p;
+                    }
+                    else if (style == quote_style::backslash &&
+                             *p == backslash) {
+                        uint32_t cp{};
+                        const auto n = decode(p + 1, end, cp);
+                        SCN_ENSURE(n != 0);
+                        encode(cp, out, CharT{});
+                        p += n;
+                        continue;
+                    }
+                    *out = *p;
+                    ++out;
+                }
+            }
+        };
+
+        /**
+         * Finds the closing quote of a string quoted with `"`, the contents
+         * of which begin at `p`, and sets `escaped`, if the contents
+         * contain escape sequences.
+         * `body` contains every character but the quote and escape
+         * characters of `style`, for finding them in bulk.
+         */
+        template <typename CharT>
+        expected<const CharT*> find_closing_quote(const CharT* p,
+                                                  const CharT* end,
+                                                  quote_style style,
+                                                  const scanset& body,
+                                                  bool& escaped)
+        {
+            const auto quote = ascii_widen<CharT>('"');
+            while (true) {
+                p = body.find_first_not_of(p, end);
+                if (p == end) {
+                    return error(error::invalid_scanned_value,
+                                 "Unterminated quoted string");
+                }
+                if (*p == quote) {
+                    if (style == quote_style::doubled && end - p >= 2 &&
+                        p[1] == quote) {
+                        escaped = true;
+                        p += 2;
+                        continue;
+                    }
+                    return p;
+                }
+                // backslash
+                uint32_t cp{};
+                const auto n = string_escapes::decode(p + 1, end, cp);
+                if (n == 0) {
+                    return error(error::invalid_scanned_value,
+                                 "Invalid escape sequence in a quoted string");
+                }
+                escaped = true;
+                p += 1 + n;
+            }
+        }
+
+        /**
+         * Reads a string quoted with `"` from a contiguous range, and returns
+         * its contents, between the quotes, without copying.
+         * If the range doesn't begin with a quote, returns an empty token,
+         * without advancing the range.
+         */
+        template <
+            typename WrappedRange,
+            typename std::enable_if<WrappedRange::is_contiguous>::type* =
+                nullptr>
+        expected<string_token<typename detail::extract_char_type<
+            typename WrappedRange::iterator>::type>>
+        read_quoted_zero_copy(WrappedRange& r,
+                              quote_style style,
+                              const scanset& body)
+        {
+            using char_type = typename detail::extract_char_type<
+                typename WrappedRange::iterator>::type;
+
+            if (r.begin() == r.end()) {
+                return error(error::end_of_range, "EOF");
+            }
+            const auto b = r.data();
+            const auto e = b + r.size();
+            string_token<char_type> tok{};
+            if (*b != ascii_widen<char_type>('"')) {
+                return tok;
+            }
+            auto p = find_closing_quote(b + 1, e, style, body, tok.escaped);
+            if (!p) {
+                return p.error();
+            }
+            tok.chars = span<const char_type>{b + 1, p.value()};
+            r.advance(p.value() + 1 - b);
+            return tok;
+        }
+        template <
+            typename WrappedRange,
+            typename std::enable_if<!WrappedRange::is_contiguous>::type* =
+                nullptr>
+        expected<string_token<typename detail::extract_char_type<
+            typename WrappedRange::iterator>::type>>
+        read_quoted_zero_copy(WrappedRange& r, quote_style, const scanset&)
+        {
+            if (r.begin() == r.end()) {
+                return error(error::end_of_range, "EOF");
+            }
+            return string_token<typename detail::extract_char_type<
+                typename WrappedRange::iterator>::type>{};
+        }
+
+        /**
+         * Reads a string quoted with `"` from `r`, and writes its contents
+         * into `out`, with the escape sequences decoded.
+         * If the range doesn't begin with a quote, writes nothing, and sets
+         * `quoted` to `false`.
+         */
+        template <typename WrappedRange, typename OutputIt>
+        error read_quoted(WrappedRange& r,
+                          OutputIt& out,
+                          quote_style style,
+                          bool& quoted)
+        {
+            using char_type = typename detail::extract_char_type<
+                typename WrappedRange::iterator>::type;
+            const auto quote = ascii_widen<char_type>('"');
+            const auto backslash = ascii_widen<char_type>('\\');
+
+            quoted = false;
+            auto first = read_char(r);
+            if (!first) {
+                return first.error();
+            }
+            if (first.value() != quote) {
+                return putback_n(r, 1);
+            }
+            quoted = true;
+
+            // Reads the next character, EOF is an error
+            auto next = [&r](char_type& ch) -> error {
+                auto c = read_char(r);
+                if (!c) {
+                    if (c.error() == error::end_of_range) {
+                        return error(error::invalid_scanned_value,
+                                     "Unterminated quoted string");
+                    }
+                    return c.error();
+                }
+                ch = c.value();
+                return {};
+            };
+
+            while (true) {
+                char_type ch{};
+                auto e = next(ch);
+                if (!e) {
+                    return e;
+                }
+                if (ch == quote) {
+                    if (style != quote_style::doubled) {
+                        return {};
+                    }
+                    auto after = read_char(r);
+                    if (!after) {
+                        // The closing quote was the last character
+                        if (after.error() == error::end_of_range) {
+                            return {};
+                        }
+                        return after.error();
+                    }
+                    if (after.value() != quote) {
+                        return putback_n(r, 1);
+                    }
+                }
+                else if (ch == backslash && style == quote_style::backslash) {
+                    // Longest sequence: a surrogate pair, u1234\u5678
+                    char_type seq[11]{};
+                    std::ptrdiff_t len = 1;
+                    e = next(seq[0]);
+                    if (e) {
+                        if (seq[0] == ascii_widen<char_type>('x')) {
+                            len = 3;
+                        }
+                        else if (seq[0] == ascii_widen<char_type>('u')) {
+                            len = 5;
+                        }
+                    }
+                    for (std::ptrdiff_t i = 1; e && i < len; ++i) {
+                        e = next(seq[i]);
+                        uint32_t hi{};
+                        if (e && i == 4 && seq[0] == ascii_widen<char_type>('u') &&
+                            string_escapes::read_hex(seq + 1, seq + 5, 4, hi) &&
+                            hi >= 0xd800 && hi <= 0xdbff) {
+                            len = 11;
+                        }
+                    }
+                    if (!e) {
+                        return e;
+                    }
+                    uint32_t cp{};
+                    if (string_escapes::decode(seq, seq + len, cp) != len) {
+                        return error(
+                            error::invalid_scanned_value,
+                            "Invalid escape sequence in a quoted string");
+                    }
+                    string_escapes::encode(cp, out, char_type{});
+                    continue;
+                }
+                *out = ch;
+                ++out;
+            }
+        }
+
         struct string_scanner {
             template <typename ParseCtx>
             error parse(ParseCtx& pctx)
@@ -1334,7 +2520,28 @@ namespace scn {
                     return error(error::invalid_format_string,
                                  "Unexpected format string end");
                 }
-                if (pctx.next() == detail::ascii_widen<char_type>('s')) {
+                const auto ch = pctx.next();
+                if (ch == detail::ascii_widen<char_type>('s')) {
+                    pctx.advance();
+                }
+                else if (ch == detail::ascii_widen<char_type>('[')) {
+                    auto e = m_set.parse(pctx);
+                    if (!e) {
+                        return e;
+                    }
+                    m_has_set = true;
+                }
+                else if (ch == detail::ascii_widen<char_type>('q') ||
+                         ch == detail::ascii_widen<char_type>('Q')) {
+                    // The set of the characters of a quoted string,
+                    // which don't end it or begin an escape sequence
+                    m_set.insert(detail::ascii_widen<char_type>('"'));
+                    m_quote = quote_style::doubled;
+                    if (ch == detail::ascii_widen<char_type>('Q')) {
+                        m_set.insert(detail::ascii_widen<char_type>('\\'));
+                        m_quote = quote_style::backslash;
+                    }
+                    m_set.invert();
                     pctx.advance();
                 }
                 if (!pctx.check_arg_end()) {
@@ -1345,42 +2552,141 @@ namespace scn {
                 return {};
             }
 
-            template <typename Context>
-            error scan(std::basic_string<typename Context::char_type>& val,
+            template <typename Context, typename Traits, typename Allocator>
+            error scan(std::basic_string<typename Context::char_type,
+                                         Traits,
+                                         Allocator>& val,
                        Context& ctx)
             {
                 using char_type = typename Context::char_type;
 
-                auto is_space_pred = [&ctx](char_type ch) {
-                    return ctx.locale().is_space(ch);
-                };
-
+                // The string is written into val in place, reusing its
+                // capacity (and its allocator, e.g. a pmr memory resource)
                 if (Context::range_type::is_contiguous) {
-                    auto s = read_until_space_zero_copy(ctx.range(),
-                                                        is_space_pred, false);
+                    auto s = _read_zero_copy(ctx);
                     if (!s) {
                         return s.error();
                     }
-                    val = std::basic_string<char_type>{s.value().data(),
-                                                       s.value().size()};
+                    const auto chars = s.value().chars;
+                    if (s.value().escaped) {
+                        val.clear();
+                        auto outputit = std::back_inserter(val);
+                        string_escapes::unescape(chars, m_quote, outputit);
+                        return {};
+                    }
+                    val.assign(chars.data(), chars.size());
                     return {};
                 }
 
-                std::basic_string<char_type> tmp;
-                auto outputit = std::back_inserter(tmp);
-                auto ret = read_until_space(ctx.range(), outputit,
-                                            is_space_pred, false);
+                // Read into a buffer on the stack first, and only then
+                // into val, so that it's kept on error, and needs no more
+                // capacity than the new value
+                small_vector<char_type, 128> buf;
+                auto outputit = std::back_inserter(buf);
+                auto ret = _read(ctx, outputit);
                 if (SCN_UNLIKELY(!ret)) {
                     return ret;
                 }
-                if (SCN_UNLIKELY(tmp.empty())) {
+                if (SCN_UNLIKELY(buf.empty() && !_allow_empty(ctx))) {
                     return error(error::invalid_scanned_value,
                                  "Empty string parsed");
                 }
-                val = std::move(tmp);
+                val.assign(buf.data(), buf.size());
 
                 return {};
             }
+
+        protected:
+            // Quoted strings, and fields between delimiters, can be empty
+            template <typename Context>
+            bool _allow_empty(const Context& ctx) const noexcept
+            {
+                return m_quote != quote_style::none ||
+                       (ctx.delimiters() != nullptr && !m_has_set);
+            }
+
+            // Reads the characters of the value from a contiguous range:
+            // the contents of a quoted string, with `q` or `Q`,
+            // the longest run of characters in the scanset, if one was
+            // given, or until the next delimiter, if the context has
+            // delimiters, or until the next space
+            template <typename Context>
+            expected<string_token<typename Context::char_type>>
+            _read_zero_copy(Context& ctx)
+            {
+                using char_type = typename Context::char_type;
+                using token_type = string_token<char_type>;
+
+                if (m_quote != quote_style::none) {
+                    auto t = read_quoted_zero_copy(ctx.range(), m_quote, m_set);
+                    if (!t || t.value().chars.data() != nullptr) {
+                        return t;
+                    }
+                    // Not quoted
+                }
+                if (m_has_set) {
+                    auto s = read_scanset_zero_copy(ctx.range(), m_set);
+                    if (!s) {
+                        return s.error();
+                    }
+                    if (s.value().size() == 0) {
+                        return error(error::invalid_scanned_value,
+                                     "No characters matched the scanset");
+                    }
+                    return token_type{s.value(), false};
+                }
+                if (ctx.delimiters()) {
+                    auto s = read_scanset_zero_copy(
+                        ctx.range(), ctx.delimiters()->field_chars());
+                    if (!s) {
+                        return s.error();
+                    }
+                    // Between two delimiters: an empty field
+                    if (s.value().size() == 0 && !_allow_empty(ctx)) {
+                        return error(error::invalid_scanned_value,
+                                     "Empty string parsed");
+                    }
+                    return token_type{s.value(), false};
+                }
+                auto s = read_until_space_zero_copy(
+                    ctx.range(),
+                    [&ctx](char_type ch) { return ctx.locale().is_space(ch); },
+                    false);
+                if (!s) {
+                    return s.error();
+                }
+                return token_type{s.value(), false};
+            }
+            // Like _read_zero_copy, but writes the characters into `out`,
+            // with escape sequences decoded
+            template <typename Context, typename OutputIt>
+            error _read(Context& ctx, OutputIt& out)
+            {
+                using char_type = typename Context::char_type;
+
+                if (m_quote != quote_style::none) {
+                    bool quoted = false;
+                    auto e = read_quoted(ctx.range(), out, m_quote, quoted);
+                    if (!e || quoted) {
+                        return e;
+                    }
+                }
+                if (m_has_set) {
+                    return read_scanset(ctx.range(), out, m_set);
+                }
+                if (ctx.delimiters()) {
+                    return read_scanset(ctx.range(), out,
+                                        ctx.delimiters()->field_chars());
+                }
+                return read_until_space(
+                    ctx.range(), out,
+                    [&ctx](char_type ch) { return ctx.locale().is_space(ch); },
+                    false);
+            }
+
+            scanset m_set{};
+            bool m_has_set{false};
+            quote_style m_quote{quote_style::none};
         };
 
         struct string_view_scanner : string_scanner {
@@ -1390,21 +2696,22 @@ namespace scn {
                        Context& ctx)
             {
                 using char_type = typename Context::char_type;
-                auto is_space_pred = [&ctx](char_type ch) {
-                    return ctx.locale().is_space(ch);
-                };
                 if (!Context::range_type::is_contiguous) {
                     return error(error::invalid_operation,
                                  "Cannot read a string_view from a "
                                  "non-contiguous_range");
                 }
-                auto s = read_until_space_zero_copy(ctx.range(), is_space_pred,
-                                                    false);
+                auto s = _read_zero_copy(ctx);
                 if (!s) {
                     return s.error();
                 }
-                val = basic_string_view<char_type>(s.value().data(),
-                                                   s.value().size());
+                if (s.value().escaped) {
+                    return error(error::invalid_scanned_value,
+                                 "Cannot read a quoted string with escape "
+                                 "sequences into a string_view");
+                }
+                val = basic_string_view<char_type>(
+                    s.value().chars.data(), s.value().chars.size());
                 return {};
             }
         };
@@ -1448,6 +2755,16 @@ namespace scn {
     struct scanner<CharT, unsigned long long>
         : public detail::integer_scanner<unsigned long long> {
     };
+#if SCN_HAS_INT128
+    template <typename CharT>
+    struct scanner<CharT, detail::int128>
+        : public detail::integer_scanner<detail::int128> {
+    };
+    template <typename CharT>
+    struct scanner<CharT, detail::uint128>
+        : public detail::integer_scanner<detail::uint128> {
+    };
+#endif
     template <typename CharT>
     struct scanner<CharT, float> : public detail::float_scanner<float> {
     };
@@ -1458,8 +2775,9 @@ namespace scn {
     struct scanner<CharT, long double>
         : public detail::float_scanner<long double> {
     };
-    template <typename CharT>
-    struct scanner<CharT, std::basic_string<CharT>>
+    template <typename CharT, typename Allocator>
+    struct scanner<CharT,
+                   std::basic_string<CharT, std::char_traits<CharT>, Allocator>>
         : public detail::string_scanner {
     };
     template <typename CharT>
@@ -1469,6 +2787,28 @@ namespace scn {
     template <typename CharT>
     struct scanner<CharT, detail::monostate>;
 
+    namespace detail {
+        // Skips whitespace in a contiguous range, as determined by the default
+        // locale. `data` points to `*it`.
+        template <typename Iterator, typename Sentinel>
+        Iterator skip_default_whitespace(const char* data,
+                                         Iterator it,
+                                         Sentinel end)
+        {
+            const auto n = ranges::distance(it, end);
+            return it + (find_non_space(data, data + n) - data);
+        }
+        template <typename Iterator, typename Sentinel>
+        Iterator skip_default_whitespace(const wchar_t*,
+                                         Iterator it,
+                                         Sentinel end)
+        {
+            for (; it != end && is_space(*it); ++it) {
+            }
+            return it;
+        }
+    }  // namespace detail
+
     /// @{
 
     /**
@@ -1511,7 +2851,16 @@ namespace scn {
         SCN_CLANG_PUSH_IGNORE_UNDEFINED_TEMPLATE
 
         const auto end = ctx.range().end();
-        for (auto it = ctx.range().begin(); it != end; ++it) {
+        auto it = ctx.range().begin();
+        if (it != end && !ctx.locale().is_space(*it)) {
+            return {};
+        }
+        if (ctx.locale().is_default()) {
+            ctx.range().advance_to(
+                detail::skip_default_whitespace(ctx.range().data(), it, end));
+            return {};
+        }
+        for (; it != end; ++it) {
             if (!ctx.locale().is_space(*it)) {
                 ctx.range().advance_to(it);
                 return {};
@@ -1525,6 +2874,62 @@ namespace scn {
 
     /// @}
 
+    /// @{
+
+    /**
+     * \ingroup scan_low
+     *
+     * Equivalent to `skip_range_whitespace`, except that if `ctx` has
+     * delimiters (see \ref with_delimiters), a single delimiter, and the
+     * whitespace around it, is skipped. Another delimiter right after it
+     * is an empty field, and is left in the range.
+     */
+    template <typename Context,
+              typename std::enable_if<
+                  !Context::range_type::is_contiguous>::type* = nullptr>
+    error skip_range_separators(Context& ctx)
+    {
+        if (!ctx.delimiters()) {
+            return skip_range_whitespace(ctx);
+        }
+        const auto& d = *ctx.delimiters();
+        bool delimiter_skipped = false;
+        while (true) {
+            auto ch = read_char(ctx.range());
+            if (SCN_UNLIKELY(!ch)) {
+                return ch.error();
+            }
+            if (d.space_chars().contains(ch.value())) {
+                continue;
+            }
+            if (!delimiter_skipped && d.is_delimiter(ch.value())) {
+                delimiter_skipped = true;
+                continue;
+            }
+            return putback_n(ctx.range(), 1);
+        }
+    }
+    template <typename Context,
+              typename std::enable_if<
+                  Context::range_type::is_contiguous>::type* = nullptr>
+    error skip_range_separators(Context& ctx)
+    {
+        if (!ctx.delimiters()) {
+            return skip_range_whitespace(ctx);
+        }
+        // Reaching the end is not an error, as with skip_range_whitespace
+        const auto& d = *ctx.delimiters();
+        read_scanset_zero_copy(ctx.range(), d.space_chars());
+        auto it = ctx.range().begin();
+        if (it != ctx.range().end() && d.is_delimiter(*it)) {
+            ctx.range().advance_to(++it);
+            read_scanset_zero_copy(ctx.range(), d.space_chars());
+        }
+        return {};
+    }
+
+    /// @}
+
     SCN_END_NAMESPACE
 }  // namespace scn
 
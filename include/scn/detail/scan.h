@@ -121,6 +121,90 @@ namespace scn {
         return vscan(ctx, pctx, {args});
     }
 
+    // scan with delimiters
+
+    /**
+     * Equivalent to \ref scan, but the values end at the characters in `d`,
+     * instead of whitespace, so that delimited records, like
+     * comma-separated ones, can be scanned in a single pass.
+     *
+     *  - Strings are read until the next delimiter, and can contain
+     *    whitespace.
+     *  - Numbers, `bool`s and other words end at a delimiter or whitespace.
+     *  - Whitespace in the format string skips a single delimiter, and the
+     *    whitespace around it. Delimiters can also be matched with literal
+     *    characters in the format string.
+     *  - Two delimiters in a row are an empty field: an empty string, or an
+     *    error for other types.
+     *
+     * The search for the end of a value is vectorized on contiguous ranges
+     * (see \ref simd).
+     *
+     * \code{.cpp}
+     * std::string name;
+     * int age;
+     * double score;
+     * scn::scan(line, scn::with_delimiters(",;\t"), "{} {} {}",
+     *           name, age, score);
+     * // line == "John Doe,42;0.5" -> name == "John Doe"
+     * \endcode
+     */
+    template <typename Range,
+              typename CharT,
+              typename Format,
+              typename... Args>
+    auto scan(Range&& r,
+              const basic_delimiters<CharT>& d,
+              const Format& f,
+              Args&... a) -> detail::scan_result_for_range_t<Range>
+    {
+        static_assert(sizeof...(Args) > 0,
+                      "Have to scan at least a single argument");
+
+        using range_type = detail::range_wrapper_for_t<Range>;
+        using context_type = basic_context<range_type>;
+        using parse_context_type =
+            basic_parse_context<typename context_type::locale_type>;
+        static_assert(
+            std::is_same<typename context_type::char_type, CharT>::value,
+            "The character types of the delimiters and the range must match");
+
+        auto args = make_args<context_type, parse_context_type>(a...);
+        auto ctx = context_type(detail::wrap(std::forward<Range>(r)));
+        ctx.set_delimiters(std::addressof(d));
+        auto pctx = parse_context_type(f, ctx);
+        return vscan(ctx, pctx, {args});
+    }
+
+    /**
+     * Equivalent to \ref scan with delimiters, and a format string with
+     * the appropriate amount of space-separated `"{}"`s: the values are
+     * separated by a single delimiter, and any whitespace around it.
+     */
+    template <typename Range, typename CharT, typename... Args>
+    auto scan(Range&& r,
+              const basic_delimiters<CharT>& d,
+              detail::default_t,
+              Args&... a) -> detail::scan_result_for_range_t<Range>
+    {
+        static_assert(sizeof...(Args) > 0,
+                      "Have to scan at least a single argument");
+
+        using range_type = detail::range_wrapper_for_t<Range>;
+        using context_type = basic_context<range_type>;
+        using parse_context_type =
+            basic_empty_parse_context<typename context_type::locale_type>;
+        static_assert(
+            std::is_same<typename context_type::char_type, CharT>::value,
+            "The character types of the delimiters and the range must match");
+
+        auto args = make_args<context_type, parse_context_type>(a...);
+        auto ctx = context_type(detail::wrap(std::forward<Range>(r)));
+        ctx.set_delimiters(std::addressof(d));
+        auto pctx = parse_context_type(static_cast<int>(sizeof...(Args)), ctx);
+        return vscan(ctx, pctx, {args});
+    }
+
     // default format
 
     /**
@@ -149,6 +233,58 @@ namespace scn {
         return vscan(ctx, pctx, {args});
     }
 
+    // scan_static
+
+    /**
+     * Equivalent to \ref scan, but the arguments are not type-erased: the
+     * `parse` and `scan` member functions of the `scanner`s of the argument
+     * types are called directly, and can be inlined.
+     *
+     * Every call instantiates the scanning loop for the argument types, so
+     * this is best used in hot loops, and not everywhere.
+     *
+     * \see scan
+     */
+    template <typename Range, typename Format, typename... Args>
+    auto scan_static(Range&& r, const Format& f, Args&... a)
+        -> detail::scan_result_for_range_t<Range>
+    {
+        static_assert(sizeof...(Args) > 0,
+                      "Have to scan at least a single argument");
+
+        using range_type = detail::range_wrapper_for_t<Range>;
+        using context_type = basic_context<range_type>;
+        using parse_context_type =
+            basic_parse_context<typename context_type::locale_type>;
+
+        auto ctx = context_type(detail::wrap(std::forward<Range>(r)));
+        auto pctx = parse_context_type(f, ctx);
+        return visit_static(ctx, pctx, a...);
+    }
+
+    /**
+     * Equivalent to \ref scan with `scn::default_tag`, but with the arguments
+     * not type-erased.
+     *
+     * \see scan_static
+     */
+    template <typename Range, typename... Args>
+    auto scan_static(Range&& r, detail::default_t, Args&... a)
+        -> detail::scan_result_for_range_t<Range>
+    {
+        static_assert(sizeof...(Args) > 0,
+                      "Have to scan at least a single argument");
+
+        using range_type = detail::range_wrapper_for_t<Range>;
+        using context_type = basic_context<range_type>;
+        using parse_context_type =
+            basic_empty_parse_context<typename context_type::locale_type>;
+
+        auto ctx = context_type(detail::wrap(std::forward<Range>(r)));
+        auto pctx = parse_context_type(static_cast<int>(sizeof...(Args)), ctx);
+        return visit_static(ctx, pctx, a...);
+    }
+
     // value
 
     /**
@@ -202,6 +338,61 @@ namespace scn {
 #endif
     }
 
+    namespace detail {
+        /**
+         * Scans a whole field, already split from its record (like a CSV
+         * field), into a value
+         */
+        struct field_scanner {
+            // A string is the whole field
+            template <typename CharT, typename Traits, typename Allocator>
+            static error scan(basic_string_view<CharT> field,
+                              std::basic_string<CharT, Traits, Allocator>& val)
+            {
+                val.assign(field.data(), field.size());
+                return {};
+            }
+            template <typename CharT>
+            static error scan(basic_string_view<CharT> field,
+                              basic_string_view<CharT>& val)
+            {
+                val = field;
+                return {};
+            }
+
+            // Everything else with its scanner, as if by "{}",
+            // allowing whitespace around the value
+            template <typename CharT, typename T>
+            static error scan(basic_string_view<CharT> field, T& val)
+            {
+                using range_type =
+                    range_wrapper_for_t<basic_string_view<CharT>>;
+                using context_type = basic_context<range_type>;
+
+                auto ctx = context_type(wrap(std::move(field)));
+                auto e = skip_range_whitespace(ctx);
+                if (!e) {
+                    return e;
+                }
+                scanner<CharT, T> s{};
+                e = s.scan(val, ctx);
+                if (!e) {
+                    return e;
+                }
+                e = skip_range_whitespace(ctx);
+                if (!e) {
+                    return e;
+                }
+                if (ctx.range().begin() != ctx.range().end()) {
+                    return error(error::invalid_scanned_value,
+                                 "Unexpected characters after the value of a "
+                                 "field");
+                }
+                return {};
+            }
+        };
+    }  // namespace detail
+
     // scanf
 
     /**
@@ -341,33 +532,35 @@ namespace scn {
         auto getline_impl(WrappedRange& r, String& str, CharT until)
             -> detail::scan_result_for_range_t<WrappedRange, wrapped_error>
         {
-            auto until_pred = [until](CharT ch) { return ch == until; };
-            auto s = read_until_space_zero_copy(r, until_pred, true);
+            auto s = read_until_char_zero_copy(r, until, true);
             if (!s) {
                 return {std::move(s.error()), r.get_return()};
             }
             if (s.value().size() != 0) {
                 auto size = s.value().size();
-                if (until_pred(s.value()[size - 1])) {
+                if (s.value()[size - 1] == until) {
                     --size;
                 }
-                str.clear();
-                str.resize(size);
-                std::copy(s.value().begin(), s.value().begin() + size,
-                          str.begin());
+                str.assign(s.value().data(), s.value().data() + size);
                 return {{}, r.get_return()};
             }
 
-            String tmp;
-            auto out = std::back_inserter(tmp);
-            auto e = read_until_space(r, out, until_pred, true);
-            if (!e) {
+            // Read straight into str, to reuse its capacity
+            str.clear();
+            error e{};
+            {
+                bulk_appender<String> appender{str};
+                auto out = std::back_inserter(appender);
+                e = read_until_char(r, out, until, true);
+                appender.flush();
+            }
+            // EOF after reading some characters ends the final line
+            if (!e && (e.code() != error::end_of_range || str.empty())) {
                 return {std::move(e), r.get_return()};
             }
-            if (until_pred(tmp.back())) {
-                tmp.pop_back();
+            if (str.back() == until) {
+                str.pop_back();
             }
-            str = std::move(tmp);
             return {{}, r.get_return()};
         }
         template <typename WrappedRange, typename CharT>
@@ -376,14 +569,13 @@ namespace scn {
                           CharT until)
             -> detail::scan_result_for_range_t<WrappedRange, wrapped_error>
         {
-            auto until_pred = [until](CharT ch) { return ch == until; };
-            auto s = read_until_space_zero_copy(r, until_pred, true);
+            auto s = read_until_char_zero_copy(r, until, true);
             if (!s) {
                 return {std::move(s.error()), r.get_return()};
             }
             if (s.value().size() != 0) {
                 auto size = s.value().size();
-                if (until_pred(s.value()[size - 1])) {
+                if (s.value()[size - 1] == until) {
                     --size;
                 }
                 str = basic_string_view<CharT>{s.value().data(), size};
@@ -411,7 +603,9 @@ namespace scn {
      *
      * Otherwise, clears `str` by calling `str.clear()`, and then reads the
      * range into `str` as if by repeatedly calling \c str.push_back.
-     * `str.reserve` is also required to be present.
+     * The characters are written with `str.assign(first, last)` and
+     * `str.insert(str.end(), first, last)`, so that the capacity of `str`
+     * is reused.
      */
     template <typename Range, typename String, typename CharT>
     auto getline(Range&& r, String& str, CharT until)
@@ -515,23 +709,41 @@ namespace scn {
         template <typename WrappedRange,
                   typename CharT = typename detail::extract_char_type<
                       detail::range_wrapper_for_t<
-                          typename WrappedRange::iterator>>::type>
+                          typename WrappedRange::iterator>>::type,
+                  typename std::enable_if<
+                      !WrappedRange::is_contiguous>::type* = nullptr>
         auto ignore_until_impl(WrappedRange& r, CharT until)
             -> scan_result<WrappedRange, wrapped_error>
         {
-            auto until_pred = [until](CharT ch) { return ch == until; };
             ignore_iterator<CharT> it{};
-            auto e = read_until_space(r, it, until_pred, false);
+            auto e = read_until_char(r, it, until, false);
             if (!e) {
                 return {std::move(e), r.get_return()};
             }
             return {{}, r.get_return()};
         }
+        template <typename WrappedRange,
+                  typename CharT = typename detail::extract_char_type<
+                      detail::range_wrapper_for_t<
+                          typename WrappedRange::iterator>>::type,
+                  typename std::enable_if<
+                      WrappedRange::is_contiguous>::type* = nullptr>
+        auto ignore_until_impl(WrappedRange& r, CharT until)
+            -> scan_result<WrappedRange, wrapped_error>
+        {
+            auto s = read_until_char_zero_copy(r, until, false);
+            if (!s) {
+                return {std::move(s.error()), r.get_return()};
+            }
+            return {{}, r.get_return()};
+        }
 
         template <typename WrappedRange,
                   typename CharT = typename detail::extract_char_type<
                       detail::range_wrapper_for_t<
-                          typename WrappedRange::iterator>>::type>
+                          typename WrappedRange::iterator>>::type,
+                  typename std::enable_if<
+                      !WrappedRange::is_contiguous>::type* = nullptr>
         auto ignore_until_n_impl(WrappedRange& r,
                                  ranges::range_difference_t<WrappedRange> n,
                                  CharT until)
@@ -545,6 +757,28 @@ namespace scn {
             }
             return {{}, r.get_return()};
         }
+        template <typename WrappedRange,
+                  typename CharT = typename detail::extract_char_type<
+                      detail::range_wrapper_for_t<
+                          typename WrappedRange::iterator>>::type,
+                  typename std::enable_if<
+                      WrappedRange::is_contiguous>::type* = nullptr>
+        auto ignore_until_n_impl(WrappedRange& r,
+                                 ranges::range_difference_t<WrappedRange> n,
+                                 CharT until)
+            -> scan_result<WrappedRange, wrapped_error>
+        {
+            if (r.begin() == r.end()) {
+                return {error(error::end_of_range, "EOF"), r.get_return()};
+            }
+            using char_type = typename detail::extract_char_type<
+                typename WrappedRange::iterator>::type;
+            const auto b = r.data();
+            const auto e = b + detail::min<decltype(n)>(n, r.size());
+            r.advance(detail::find_until(b, e, static_cast<char_type>(until)) -
+                      b);
+            return {{}, r.get_return()};
+        }
     }  // namespace detail
 
     /**
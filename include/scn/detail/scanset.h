@@ -0,0 +1,266 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_SCANSET_H
+#define SCN_DETAIL_SCANSET_H
+
+#include "locale.h"
+#include "simd.h"
+#include "small_vector.h"
+
+#include <algorithm>
+#include <initializer_list>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    namespace detail {
+        /**
+         * The set of characters accepted by a `[...]` format specifier.
+         * Characters below 256 are kept in a bitmap, which is matched many
+         * characters at a time (see \ref simd), wider ones in a list of
+         * ranges.
+         */
+        class scanset {
+        public:
+            /**
+             * Parses a set from `pctx`, positioned at the opening `[`,
+             * and leaves `pctx` after the closing `]`.
+             */
+            template <typename ParseCtx>
+            error parse(ParseCtx& pctx)
+            {
+                using char_type = typename ParseCtx::char_type;
+                const auto close = ascii_widen<char_type>(']');
+                const auto dash = ascii_widen<char_type>('-');
+
+                SCN_EXPECT(pctx.next() == ascii_widen<char_type>('['));
+                pctx.advance();
+                bool inverted = false;
+                if (pctx && pctx.next() == ascii_widen<char_type>('^')) {
+                    inverted = true;
+                    pctx.advance();
+                }
+                // a ']' right after the opening "[" or "[^" is literal
+                for (bool first = true;; first = false) {
+                    if (!pctx) {
+                        return error(error::invalid_format_string,
+                                     "Unterminated scanset");
+                    }
+                    const auto lo = pctx.next();
+                    pctx.advance();
+                    if (lo == close && !first) {
+                        break;
+                    }
+                    // a '-' between two characters forms a range,
+                    // before the closing ']' it's literal
+                    if (pctx && pctx.next() == dash) {
+                        pctx.advance();
+                        if (pctx && pctx.next() != close) {
+                            const auto hi = pctx.next();
+                            pctx.advance();
+                            if (code(hi) < code(lo)) {
+                                return error(error::invalid_format_string,
+                                             "Invalid scanset range");
+                            }
+                            _insert(code(lo), code(hi));
+                            continue;
+                        }
+                        _insert(code(dash), code(dash));
+                    }
+                    _insert(code(lo), code(lo));
+                }
+                if (inverted) {
+                    invert();
+                }
+                return {};
+            }
+
+            void insert(char ch)
+            {
+                _insert(code(ch), code(ch));
+            }
+            void insert(wchar_t ch)
+            {
+                _insert(code(ch), code(ch));
+            }
+            /// Adds every character in `chars`
+            template <typename CharT>
+            void insert(basic_string_view<CharT> chars)
+            {
+                for (auto ch : chars) {
+                    insert(ch);
+                }
+            }
+            /// Replaces the set with its complement
+            void invert() noexcept
+            {
+                m_bytes.invert();
+                m_inverted = !m_inverted;
+            }
+
+            bool contains(char ch) const noexcept
+            {
+                return m_bytes.contains(static_cast<unsigned char>(ch));
+            }
+            bool contains(wchar_t ch) const noexcept
+            {
+                const auto c = code(ch);
+                if (c < 256) {
+                    return m_bytes.contains(static_cast<unsigned char>(c));
+                }
+                const bool in_ranges = std::any_of(
+                    m_wide.begin(), m_wide.end(), [c](const wide_range& r) {
+                        return c >= r.lo && c <= r.hi;
+                    });
+                return in_ranges != m_inverted;
+            }
+
+            /// First character in `[begin, end)` not in the set
+            const char* find_first_not_of(const char* begin,
+                                          const char* end) const noexcept
+            {
+                return find_not_in_set(begin, end, m_bytes);
+            }
+            const wchar_t* find_first_not_of(const wchar_t* begin,
+                                             const wchar_t* end) const
+                noexcept
+            {
+                for (; begin != end; ++begin) {
+                    if (!contains(*begin)) {
+                        return begin;
+                    }
+                }
+                return end;
+            }
+
+        private:
+            struct wide_range {
+                uint32_t lo;
+                uint32_t hi;
+            };
+
+            static uint32_t code(char ch) noexcept
+            {
+                return static_cast<unsigned char>(ch);
+            }
+            static uint32_t code(wchar_t ch) noexcept
+            {
+                return static_cast<uint32_t>(ch);
+            }
+
+            void _insert(uint32_t lo, uint32_t hi)
+            {
+                for (auto c = lo; c <= hi && c < 256; ++c) {
+                    m_bytes.insert(static_cast<unsigned char>(c));
+                }
+                if (hi >= 256) {
+                    m_wide.push_back(wide_range{lo < 256 ? 256 : lo, hi});
+                }
+            }
+
+            byte_set m_bytes{};
+            small_vector<wide_range, 2> m_wide{};
+            bool m_inverted{false};
+        };
+    }  // namespace detail
+
+
+    /**
+     * A set of delimiter characters, ending the values scanned with
+     * `scn::scan(range, delimiters, format, args...)`.
+     * Create with \ref with_delimiters.
+     */
+    template <typename CharT>
+    class basic_delimiters {
+    public:
+        using char_type = CharT;
+
+        explicit basic_delimiters(basic_string_view<char_type> chars)
+        {
+            m_fields.insert(chars);
+            m_separators.insert(chars);
+            for (char ch : {' ', '\t', '\n', '\v', '\f', '\r'}) {
+                const auto wch = detail::ascii_widen<char_type>(ch);
+                m_separators.insert(wch);
+                if (!m_fields.contains(wch)) {
+                    m_spaces.insert(wch);
+                }
+            }
+            m_words = m_separators;
+            m_fields.invert();
+            m_words.invert();
+        }
+
+        bool is_delimiter(char_type ch) const noexcept
+        {
+            return !m_fields.contains(ch);
+        }
+
+        /// Characters of a string value: anything but a delimiter
+        const detail::scanset& field_chars() const noexcept
+        {
+            return m_fields;
+        }
+        /// Characters of other values: anything but a delimiter or whitespace
+        const detail::scanset& word_chars() const noexcept
+        {
+            return m_words;
+        }
+        /// Delimiters and whitespace
+        const detail::scanset& separator_chars() const noexcept
+        {
+            return m_separators;
+        }
+        /// Whitespace, that isn't a delimiter
+        const detail::scanset& space_chars() const noexcept
+        {
+            return m_spaces;
+        }
+
+    private:
+        detail::scanset m_fields{};
+        detail::scanset m_words{};
+        detail::scanset m_separators{};
+        detail::scanset m_spaces{};
+    };
+
+    using delimiters = basic_delimiters<char>;
+    using wdelimiters = basic_delimiters<wchar_t>;
+
+    /**
+     * Creates a delimiter set of the characters in `chars`, e.g.
+     * `scn::with_delimiters(",;\t")`.
+     */
+    inline delimiters with_delimiters(const char* chars)
+    {
+        return delimiters{string_view{chars}};
+    }
+    inline wdelimiters with_delimiters(const wchar_t* chars)
+    {
+        return wdelimiters{wstring_view{chars}};
+    }
+    template <typename CharT>
+    basic_delimiters<CharT> with_delimiters(basic_string_view<CharT> chars)
+    {
+        return basic_delimiters<CharT>{chars};
+    }
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#endif  // SCN_DETAIL_SCANSET_H
@@ -0,0 +1,439 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#ifndef SCN_DETAIL_SIMD_H
+#define SCN_DETAIL_SIMD_H
+
+#include "util.h"
+
+#include <cstdint>
+
+#if SCN_MSVC
+#include <intrin.h>
+#endif
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    /**
+     * \defgroup simd Runtime CPU dispatch
+     *
+     * Some of the hot loops in the library (whitespace skipping, delimiter
+     * search, scanset matching and decimal digit runs) have vectorized
+     * implementations. The best implementation supported by the running CPU
+     * is selected once, on first use, so a single binary can be shipped to
+     * machines with differing instruction set support.
+     *
+     * The selection can be overridden by setting the environment variable
+     * `SCN_SIMD` to the name of a level (see \ref simd_level_name), e.g.
+     * `SCN_SIMD=scalar`. Levels not supported by the CPU are ignored.
+     */
+
+    /// @{
+
+    /// Instruction set level used by the vectorized kernels
+    enum class simd_level : unsigned char {
+        scalar = 0,
+        sse42,
+        avx2,
+        avx512bw,
+        neon
+    };
+
+    /// Instruction set extensions supported by the running CPU (and OS)
+    struct cpu_features {
+        bool sse42{false};
+        bool avx2{false};
+        bool avx512bw{false};
+        bool neon{false};
+    };
+
+    /// Queries the running CPU for supported instruction set extensions
+    cpu_features detect_cpu_features() noexcept;
+
+    /// Returns whether the kernels of level `l` can be used on this CPU
+    bool is_simd_level_supported(simd_level l) noexcept;
+
+    /// Returns the level of the kernels currently in use
+    simd_level get_simd_level() noexcept;
+
+    /**
+     * Returns the name of level `l`: one of `"scalar"`, `"sse4.2"`, `"avx2"`,
+     * `"avx512bw"` or `"neon"`.
+     * These are also the accepted values of the `SCN_SIMD` environment
+     * variable.
+     */
+    const char* simd_level_name(simd_level l) noexcept;
+
+    /// @}
+
+    namespace detail {
+        /**
+         * A set of bytes, as a 256-bit bitmap.
+         * The bit of byte `c` is bit `(c >> 4) & 7` of
+         * `bits[(c >> 7) * 16 + (c & 15)]`: the low nibble selects the
+         * table entry, so that the kernels can look up 16 bytes at a time
+         * with a single byte shuffle per half of the table.
+         */
+        struct byte_set {
+            uint8_t bits[32]{};
+
+            void insert(unsigned char c) noexcept
+            {
+                bits[(c >> 7) * 16 + (c & 15)] |=
+                    static_cast<uint8_t>(1u << ((c >> 4) & 7));
+            }
+            bool contains(unsigned char c) const noexcept
+            {
+                return ((bits[(c >> 7) * 16 + (c & 15)] >> ((c >> 4) & 7)) &
+                        1) != 0;
+            }
+            void invert() noexcept
+            {
+                for (auto& b : bits) {
+                    b = static_cast<uint8_t>(~b);
+                }
+            }
+        };
+
+        /**
+         * A set of kernels for a single `simd_level`.
+         * Every kernel takes a range `[begin, end)` and returns a pointer to
+         * the first character satisfying its condition, or `end`, if none
+         * was found.
+         */
+        struct simd_kernels {
+            simd_level level;
+            // first `ch`
+            const char* (*find_char)(const char*, const char*, char);
+            // first non-whitespace, as determined by `detail::is_space`
+            const char* (*find_non_space)(const char*, const char*);
+            // first character not in `[0-9]`
+            const char* (*find_non_digit)(const char*, const char*);
+            // first character not in `set`
+            const char* (*find_not_in_set)(const char*,
+                                           const char*,
+                                           const byte_set& set);
+            // number of occurrences of `ch` (doesn't return a pointer)
+            std::size_t (*count_char)(const char*, const char*, char);
+            // bitmasks of the occurrences of `chars[0..2]` in the first
+            // 64 characters into `masks[0..2]`, bit `i` for `begin[i]`
+            // (doesn't return a pointer)
+            void (*match_masks)(const char*,
+                                const char*,
+                                const char* chars,
+                                uint64_t* masks);
+        };
+
+        /**
+         * Picks the best level supported by `features`.
+         * If `override_name` names a level supported by `features`, that one
+         * is picked instead.
+         */
+        simd_level select_simd_level(cpu_features features,
+                                     const char* override_name) noexcept;
+
+        /// Kernels for level `l`, which must be supported
+        const simd_kernels& get_simd_kernels_for(simd_level l) noexcept;
+
+        /// Kernels in use, resolved once on first call
+        const simd_kernels& get_simd_kernels() noexcept;
+
+        inline const char* find_char(const char* begin,
+                                     const char* end,
+                                     char ch) noexcept
+        {
+            return get_simd_kernels().find_char(begin, end, ch);
+        }
+        inline const char* find_non_space(const char* begin,
+                                          const char* end) noexcept
+        {
+            return get_simd_kernels().find_non_space(begin, end);
+        }
+        inline const char* find_non_digit(const char* begin,
+                                          const char* end) noexcept
+        {
+            return get_simd_kernels().find_non_digit(begin, end);
+        }
+        inline const char* find_not_in_set(const char* begin,
+                                           const char* end,
+                                           const byte_set& set) noexcept
+        {
+            return get_simd_kernels().find_not_in_set(begin, end, set);
+        }
+        inline std::size_t count_char(const char* begin,
+                                      const char* end,
+                                      char ch) noexcept
+        {
+            return get_simd_kernels().count_char(begin, end, ch);
+        }
+
+        /**
+         * Sets `masks[j]` to the bitmask of the occurrences of `chars[j]`,
+         * for `j` in `[0, 3)`, in the block of the first
+         * `min(end - begin, 64)` characters of `[begin, end)`.
+         * Bit `i` of a mask is set, if `begin[i] == chars[j]`.
+         */
+        inline void match_masks(const char* begin,
+                                const char* end,
+                                const char (&chars)[3],
+                                uint64_t (&masks)[3]) noexcept
+        {
+            get_simd_kernels().match_masks(begin, end, chars, masks);
+        }
+
+        // Wide characters don't have vectorized kernels
+        inline void match_masks(const wchar_t* begin,
+                                const wchar_t* end,
+                                const wchar_t (&chars)[3],
+                                uint64_t (&masks)[3]) noexcept
+        {
+            masks[0] = masks[1] = masks[2] = 0;
+            const auto n = end - begin >= 64 ? 64 : end - begin;
+            for (std::ptrdiff_t i = 0; i < n; ++i) {
+                const auto bit = uint64_t{1} << static_cast<unsigned>(i);
+                for (int j = 0; j < 3; ++j) {
+                    if (begin[i] == chars[j]) {
+                        masks[j] |= bit;
+                    }
+                }
+            }
+        }
+
+        /**
+         * Bit `i` of the result is the XOR of the bits `[0, i]` of `v`.
+         * With `v` the bitmask of the quotes in a block, the set bits of
+         * the result are the characters inside quotes (counting the opening
+         * quotes, but not the closing ones).
+         */
+        inline uint64_t prefix_xor(uint64_t v) noexcept
+        {
+            v ^= v << 1;
+            v ^= v << 2;
+            v ^= v << 4;
+            v ^= v << 8;
+            v ^= v << 16;
+            v ^= v << 32;
+            return v;
+        }
+
+        // Index of the lowest set bit, `v` must not be zero
+        inline int countr_zero(uint32_t v) noexcept
+        {
+            SCN_EXPECT(v != 0);
+#if SCN_MSVC
+            unsigned long i{};
+            _BitScanForward(&i, v);
+            return static_cast<int>(i);
+#elif SCN_GCC_COMPAT
+            return __builtin_ctz(v);
+#else
+            int i = 0;
+            for (; (v & 1) == 0; v >>= 1) {
+                ++i;
+            }
+            return i;
+#endif
+        }
+        inline int countr_zero(uint64_t v) noexcept
+        {
+            SCN_EXPECT(v != 0);
+#if SCN_MSVC && defined(_M_X64)
+            unsigned long i{};
+            _BitScanForward64(&i, v);
+            return static_cast<int>(i);
+#elif SCN_GCC_COMPAT
+            return __builtin_ctzll(v);
+#else
+            const auto lo = static_cast<uint32_t>(v);
+            if (lo != 0) {
+                return countr_zero(lo);
+            }
+            return 32 + countr_zero(static_cast<uint32_t>(v >> 32));
+#endif
+        }
+
+        // Number of set bits. Doesn't use the popcnt instruction, unless
+        // the whole program is compiled for it: not every x86 CPU has it
+        inline int popcount(uint64_t v) noexcept
+        {
+#if SCN_GCC_COMPAT
+            return __builtin_popcountll(v);
+#else
+            v = v - ((v >> 1) & UINT64_C(0x5555555555555555));
+            v = (v & UINT64_C(0x3333333333333333)) +
+                ((v >> 2) & UINT64_C(0x3333333333333333));
+            v = (v + (v >> 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+            return static_cast<int>((v * UINT64_C(0x0101010101010101)) >> 56);
+#endif
+        }
+
+        /**
+         * SIMD within a register: operations on 8 characters at a time,
+         * packed into an `uint64_t` with the first character in the lowest
+         * byte, regardless of the endianness of the platform.
+         */
+        struct swar {
+            static uint64_t load8(const char* p) noexcept
+            {
+                // Compiles into a single load on little-endian platforms,
+                // written out, as a loop isn't unrolled at -O2
+                const auto b = [p](int i) {
+                    return uint64_t{static_cast<unsigned char>(p[i])};
+                };
+                return b(0) | b(1) << 8 | b(2) << 16 | b(3) << 24 |
+                       b(4) << 32 | b(5) << 40 | b(6) << 48 | b(7) << 56;
+            }
+
+            // true, if every byte of `v` is an ASCII digit
+            static bool is_8_digits(uint64_t v) noexcept
+            {
+                return (((v + UINT64_C(0x4646464646464646)) |
+                         (v - UINT64_C(0x3030303030303030))) &
+                        UINT64_C(0x8080808080808080)) == 0;
+            }
+
+            // Value of the 8 digits in `v`, `is_8_digits(v)` must be true
+            static uint32_t parse_8_digits(uint64_t v) noexcept
+            {
+                v -= UINT64_C(0x3030303030303030);
+                // byte 2i: 10 * d[2i] + d[2i + 1]
+                v = (v * 10) + (v >> 8);
+                // combine the pairs into the upper half of the product
+                v = (((v & UINT64_C(0x000000ff000000ff)) *
+                      UINT64_C(0x000f424000000064)) +
+                     (((v >> 16) & UINT64_C(0x000000ff000000ff)) *
+                      UINT64_C(0x0000271000000001))) >>
+                    32;
+                return static_cast<uint32_t>(v);
+            }
+
+            /**
+             * Every byte `i` of the result is `10 * d[i] + d[i + 1]`, where
+             * `d[i]` is the value of the digit in byte `i` of `v`, so that
+             * the value of a two-digit group starting at any byte can be
+             * read with a shift. `is_8_digits(v)` must be true.
+             */
+            static uint64_t digit_pairs(uint64_t v) noexcept
+            {
+                v -= UINT64_C(0x3030303030303030);
+                return (v * 10) + (v >> 8);
+            }
+            static unsigned byte(uint64_t v, int i) noexcept
+            {
+                return static_cast<unsigned>(v >> (8 * i)) & 0xffu;
+            }
+
+            // The first `n` characters at `p`, at most 8, the rest are zero
+            static uint64_t load(const char* p, std::ptrdiff_t n) noexcept
+            {
+                if (n >= 8) {
+                    return load8(p);
+                }
+                uint64_t v = 0;
+                for (std::ptrdiff_t i = 0; i < n; ++i) {
+                    v |= uint64_t{static_cast<unsigned char>(p[i])}
+                         << (8 * i);
+                }
+                return v;
+            }
+
+            // The high bit of every byte of `v` in `[lo, hi]`, `hi < 0x80`
+            static uint64_t in_range(uint64_t v,
+                                     unsigned char lo,
+                                     unsigned char hi) noexcept
+            {
+                constexpr uint64_t ones = UINT64_C(0x0101010101010101);
+                constexpr uint64_t high = UINT64_C(0x8080808080808080);
+                const auto low7 = v & ~high;
+                const auto ge = low7 + ones * (0x80u - lo);
+                const auto gt = low7 + ones * (0x7fu - hi);
+                return ge & ~gt & ~v & high;
+            }
+            static uint64_t digit_mask(uint64_t v) noexcept
+            {
+                return in_range(v, '0', '9');
+            }
+            static uint64_t hex_digit_mask(uint64_t v) noexcept
+            {
+                return in_range(v, '0', '9') |
+                       in_range(v | UINT64_C(0x2020202020202020), 'a', 'f');
+            }
+
+            // true, if every byte of `v` is a hexadecimal digit
+            static bool is_8_hex_digits(uint64_t v) noexcept
+            {
+                return hex_digit_mask(v) == UINT64_C(0x8080808080808080);
+            }
+            // true, if every byte of `v` is an octal digit
+            static bool is_8_octal_digits(uint64_t v) noexcept
+            {
+                return in_range(v, '0', '7') == UINT64_C(0x8080808080808080);
+            }
+
+            // Bit `i` of the result is the high bit of byte `i` of `m`
+            static unsigned movemask(uint64_t m) noexcept
+            {
+                return static_cast<unsigned>(
+                    ((m & UINT64_C(0x8080808080808080)) *
+                     UINT64_C(0x0002040810204081)) >>
+                    56);
+            }
+
+            // Values of the hexadecimal digits in the bytes of `v`,
+            // which must all be hexadecimal digits
+            static uint64_t hex_nibbles(uint64_t v) noexcept
+            {
+                // 'a' and 'A' have the bit 6 set, and 1 in the low nibble
+                return (v & UINT64_C(0x0f0f0f0f0f0f0f0f)) +
+                       ((v >> 6) & UINT64_C(0x0101010101010101)) * 9;
+            }
+
+            // Value of the 8 hexadecimal digits in `v`, the first one the
+            // most significant, `hex_digit_mask(v)` must be all set
+            static uint32_t parse_8_hex_digits(uint64_t v) noexcept
+            {
+                // pack nibble pairs into bytes, then byte pairs into 16-bit
+                // lanes, with shifts instead of multiplications
+                v = hex_nibbles(v);
+                v = ((v << 4) | (v >> 8)) & UINT64_C(0x00ff00ff00ff00ff);
+                v = ((v << 8) | (v >> 16)) & UINT64_C(0x0000ffff0000ffff);
+                return static_cast<uint32_t>((v << 16) | (v >> 32));
+            }
+
+            // Value of the 8 octal digits in `v`, the first one the most
+            // significant, `is_8_octal_digits(v)` must be true
+            static uint32_t parse_8_octal_digits(uint64_t v) noexcept
+            {
+                // 3-bit digits packed into 6-bit, 12-bit and 24-bit groups
+                v -= UINT64_C(0x3030303030303030);
+                v = ((v << 3) | (v >> 8)) & UINT64_C(0x003f003f003f003f);
+                v = ((v << 6) | (v >> 16)) & UINT64_C(0x00000fff00000fff);
+                return static_cast<uint32_t>(((v << 12) | (v >> 32)) &
+                                             UINT64_C(0xffffff));
+            }
+        };
+    }  // namespace detail
+
+    SCN_END_NAMESPACE
+}  // namespace scn
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY && !defined(SCN_SIMD_CPP)
+#include "simd.cpp"
+#endif
+
+#endif  // SCN_DETAIL_SIMD_H
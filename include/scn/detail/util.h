@@ -477,6 +477,48 @@ namespace scn {
             return {l / r, l % r};
         }
 
+#if SCN_HAS_INT128
+        __extension__ typedef __int128 int128;
+        __extension__ typedef unsigned __int128 uint128;
+#endif
+
+        // In strict ISO mode (-std=c++11, not gnu++11), the standard type
+        // traits don't consider __int128 an integer
+        template <typename T>
+        struct is_int128 : std::false_type {
+        };
+        template <typename T>
+        struct is_signed_integer : std::is_signed<T> {
+        };
+        template <typename T>
+        struct make_unsigned : std::make_unsigned<T> {
+        };
+#if SCN_HAS_INT128
+        template <>
+        struct is_int128<int128> : std::true_type {
+        };
+        template <>
+        struct is_int128<uint128> : std::true_type {
+        };
+        template <>
+        struct is_signed_integer<int128> : std::true_type {
+        };
+        template <>
+        struct make_unsigned<int128> {
+            using type = uint128;
+        };
+        template <>
+        struct make_unsigned<uint128> {
+            using type = uint128;
+        };
+#endif
+        template <typename T>
+        struct is_integer
+            : std::integral_constant<bool,
+                                     std::is_integral<T>::value ||
+                                         is_int128<T>::value> {
+        };
+
         template <typename T>
         constexpr T* launder(T* p) noexcept
         {
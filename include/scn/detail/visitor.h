@@ -20,6 +20,8 @@
 
 #include "reader.h"
 
+#include <tuple>
+
 namespace scn {
     SCN_BEGIN_NAMESPACE
 
@@ -87,6 +89,10 @@ namespace scn {
         SCN_VISIT_INT(unsigned int)
         SCN_VISIT_INT(unsigned long)
         SCN_VISIT_INT(unsigned long long)
+#if SCN_HAS_INT128
+        SCN_VISIT_INT(detail::int128)
+        SCN_VISIT_INT(detail::uint128)
+#endif
 #undef SCN_VISIT_INT
 
 #define SCN_VISIT_FLOAT(T)                       \
@@ -222,137 +228,269 @@ namespace scn {
     template <typename Context>
     using scan_result_for_t = typename scan_result_for<Context>::type;
 
-    template <typename Context, typename ParseCtx>
-    scan_result_for_t<Context> visit(Context& ctx,
-                                     ParseCtx& pctx,
-                                     basic_args<Context> args)
-    {
-        auto reterror = [&ctx](error e) -> scan_result_for_t<Context> {
-            return {std::move(e), ctx.range().get_return()};
-        };
-
-        auto arg = typename Context::arg_type();
-
+    namespace detail {
+        /**
+         * Index of the argument of the replacement field at the beginning of
+         * `pctx`, either given explicitly or the next one
+         */
+        template <typename Context, typename ParseCtx>
+        expected<std::ptrdiff_t> next_arg_index(Context& ctx, ParseCtx& pctx)
         {
-            auto ret = skip_range_whitespace(ctx);
-            if (!ret) {
-                return reterror(ret);
+            if (!pctx.has_arg_id()) {
+                return pctx.next_arg_id();
             }
+            auto id_wrapped = pctx.parse_arg_id();
+            if (!id_wrapped) {
+                return id_wrapped.error();
+            }
+            auto id = id_wrapped.value();
+            SCN_ENSURE(!id.empty());
+            if (!ctx.locale().is_digit(id.front())) {
+                // named arguments are not supported
+                return error(error::invalid_format_string,
+                             "Argument id out of range");
+            }
+            auto s = detail::integer_scanner<std::ptrdiff_t>{};
+            s.base = 10;
+            std::ptrdiff_t i{0};
+            auto span = make_span(id.data(), id.size()).as_const();
+            auto ret = s._read_int(i, false, span,
+                                   typename decltype(span)::value_type{0});
+            if (!ret || ret.value() != span.end()) {
+                return error(error::invalid_format_string,
+                             "Failed to parse argument id from "
+                             "format string");
+            }
+            if (!pctx.check_arg_id(i)) {
+                return error(error::invalid_format_string,
+                             "Argument id out of range");
+            }
+            return i;
         }
 
-        while (pctx) {
-            if (pctx.should_skip_ws()) {
-                // Skip whitespace from format string and from stream
-                // EOF is not an error
+        /**
+         * Arguments of \ref visit: type-erased `basic_args`, scanned through
+         * `visit_arg`
+         */
+        template <typename Context>
+        struct erased_arg_source {
+            using arg_type = typename Context::arg_type;
+
+            template <typename ParseCtx>
+            expected<arg_type> next(Context& ctx, ParseCtx& pctx)
+            {
+                auto i = next_arg_index(ctx, pctx);
+                if (!i) {
+                    return i.error();
+                }
+                return get_arg(args, i.value());
+            }
+            template <typename ParseCtx>
+            error scan(Context& ctx, ParseCtx& pctx, arg_type arg)
+            {
+                SCN_ENSURE(arg);
+                return visit_arg<Context>(
+                    basic_visitor<Context, ParseCtx>(ctx, pctx), arg);
+            }
+
+            basic_args<Context> args;
+        };
+
+        /**
+         * Drives the scanning of the arguments given by `source` according
+         * to the format string in `pctx`
+         */
+        template <typename Context, typename ParseCtx, typename ArgSource>
+        scan_result_for_t<Context> visit_with(Context& ctx,
+                                              ParseCtx& pctx,
+                                              ArgSource& source)
+        {
+            auto reterror = [&ctx](error e) -> scan_result_for_t<Context> {
+                return {std::move(e), ctx.range().get_return()};
+            };
+
+            {
                 auto ret = skip_range_whitespace(ctx);
-                if (SCN_UNLIKELY(!ret)) {
-                    if (ret == error::end_of_range) {
-                        break;
-                    }
-                    SCN_CLANG_PUSH_IGNORE_UNDEFINED_TEMPLATE
-                    auto rb = ctx.range().reset_to_rollback_point();
-                    if (!rb) {
-                        return reterror(rb);
-                    }
+                if (!ret) {
                     return reterror(ret);
                 }
-                // Don't advance pctx, should_skip_ws() does it for us
-                continue;
             }
 
-            // Non-brace character, or
-            // Brace followed by another brace, meaning a literal '{'
-            if (pctx.should_read_literal()) {
-                if (SCN_UNLIKELY(!pctx)) {
-                    return reterror(error(error::invalid_format_string,
-                                          "Unexpected end of format string"));
-                }
-                // Check for any non-specifier {foo} characters
-                auto ret = read_char(ctx.range());
-                SCN_CLANG_POP_IGNORE_UNDEFINED_TEMPLATE
-                if (!ret || !pctx.check_literal(ret.value())) {
-                    auto rb = ctx.range().reset_to_rollback_point();
-                    if (!rb) {
-                        // Failed rollback
-                        return reterror(rb);
+            while (pctx) {
+                if (pctx.should_skip_ws()) {
+                    // Skip whitespace from format string and from stream
+                    // (and delimiters, if any)
+                    // EOF is not an error
+                    auto ret = skip_range_separators(ctx);
+                    if (SCN_UNLIKELY(!ret)) {
+                        if (ret == error::end_of_range) {
+                            break;
+                        }
+                        SCN_CLANG_PUSH_IGNORE_UNDEFINED_TEMPLATE
+                        auto rb = ctx.range().reset_to_rollback_point();
+                        if (!rb) {
+                            return reterror(rb);
+                        }
+                        return reterror(ret);
                     }
-                    if (!ret) {
-                        // Failed read
-                        return reterror(ret.error());
+                    // Don't advance pctx, should_skip_ws() does it for us
+                    continue;
+                }
+
+                // Non-brace character, or
+                // Brace followed by another brace, meaning a literal '{'
+                if (pctx.should_read_literal()) {
+                    if (SCN_UNLIKELY(!pctx)) {
+                        return reterror(
+                            error(error::invalid_format_string,
+                                  "Unexpected end of format string"));
                     }
+                    // Check for any non-specifier {foo} characters
+                    auto ret = read_char(ctx.range());
+                    SCN_CLANG_POP_IGNORE_UNDEFINED_TEMPLATE
+                    if (!ret || !pctx.check_literal(ret.value())) {
+                        auto rb = ctx.range().reset_to_rollback_point();
+                        if (!rb) {
+                            // Failed rollback
+                            return reterror(rb);
+                        }
+                        if (!ret) {
+                            // Failed read
+                            return reterror(ret.error());
+                        }
 
-                    // Mismatching characters in scan string and stream
-                    return reterror(
-                        error(error::invalid_scanned_value,
-                              "Expected character from format string not "
-                              "found in the stream"));
+                        // Mismatching characters in scan string and stream
+                        return reterror(
+                            error(error::invalid_scanned_value,
+                                  "Expected character from format string "
+                                  "not found in the stream"));
+                    }
+                    // Bump pctx to next char
+                    pctx.advance();
                 }
-                // Bump pctx to next char
-                pctx.advance();
-            }
-            else {
-                // Scan argument
-                auto arg_wrapped = [&]() -> expected<typename Context::arg_type>
-                {
-                    if (!pctx.has_arg_id()) {
-                        return next_arg(args, pctx);
+                else {
+                    // Scan argument
+                    auto arg = source.next(ctx, pctx);
+                    if (!arg) {
+                        return reterror(arg.error());
                     }
-                    auto id_wrapped = pctx.parse_arg_id();
-                    if (!id_wrapped) {
-                        return id_wrapped.error();
+                    if (!pctx) {
+                        return reterror(
+                            error(error::invalid_format_string,
+                                  "Unexpected end of format argument"));
                     }
-                    auto id = id_wrapped.value();
-                    SCN_ENSURE(!id.empty());
-                    if (ctx.locale().is_digit(id.front())) {
-                        auto s = detail::integer_scanner<std::ptrdiff_t>{};
-                        s.base = 10;
-                        std::ptrdiff_t i{0};
-                        auto span = make_span(id.data(), id.size()).as_const();
-                        auto ret =
-                            s._read_int(i, false, span,
-                                        typename decltype(span)::value_type{0});
-                        if (!ret || ret.value() != span.end()) {
-                            return error(error::invalid_format_string,
-                                         "Failed to parse argument id from "
-                                         "format string");
+                    auto ret = source.scan(ctx, pctx, arg.value());
+                    if (!ret) {
+                        auto rb = ctx.range().reset_to_rollback_point();
+                        if (!rb) {
+                            return reterror(rb);
                         }
-                        return get_arg(args, pctx, i);
+                        return reterror(ret);
                     }
-                    return get_arg(args, pctx, id);
-                }
-                ();
-                if (!arg_wrapped) {
-                    return reterror(arg_wrapped.error());
-                }
-                arg = arg_wrapped.value();
-                SCN_ENSURE(arg);
-                if (!pctx) {
-                    return reterror(error(error::invalid_format_string,
-                                          "Unexpected end of format argument"));
-                }
-                auto ret = visit_arg<Context>(
-                    basic_visitor<Context, ParseCtx>(ctx, pctx), arg);
-                if (!ret) {
-                    auto rb = ctx.range().reset_to_rollback_point();
-                    if (!rb) {
-                        return reterror(rb);
+                    // Handle next arg and bump pctx
+                    pctx.arg_handled();
+                    if (pctx) {
+                        pctx.advance();
                     }
-                    return reterror(ret);
-                }
-                // Handle next arg and bump pctx
-                pctx.arg_handled();
-                if (pctx) {
-                    pctx.advance();
                 }
             }
+            if (pctx) {
+                // Format string not exhausted
+                return reterror(error(error::invalid_format_string,
+                                      "Format string not exhausted"));
+            }
+            ctx.range().set_rollback_point();
+            return {{}, ctx.range().get_return()};
+        }
+    }  // namespace detail
+
+    template <typename Context, typename ParseCtx>
+    scan_result_for_t<Context> visit(Context& ctx,
+                                     ParseCtx& pctx,
+                                     basic_args<Context> args)
+    {
+        auto source = detail::erased_arg_source<Context>{std::move(args)};
+        return detail::visit_with(ctx, pctx, source);
+    }
+
+    namespace detail {
+        template <std::size_t I,
+                  typename Context,
+                  typename ParseCtx,
+                  typename Tuple>
+        error scan_static_nth(Context&,
+                              ParseCtx&,
+                              std::ptrdiff_t,
+                              Tuple&,
+                              std::true_type)
+        {
+            return error(error::invalid_format_string,
+                         "Argument id out of range");
         }
-        if (pctx) {
-            // Format string not exhausted
-            return reterror(error(error::invalid_format_string,
-                                  "Format string not exhausted"));
+        template <std::size_t I,
+                  typename Context,
+                  typename ParseCtx,
+                  typename Tuple>
+        error scan_static_nth(Context& ctx,
+                              ParseCtx& pctx,
+                              std::ptrdiff_t i,
+                              Tuple& args,
+                              std::false_type)
+        {
+            if (i != static_cast<std::ptrdiff_t>(I)) {
+                return scan_static_nth<I + 1>(
+                    ctx, pctx, i, args,
+                    std::integral_constant<
+                        bool, I + 1 == std::tuple_size<Tuple>::value>{});
+            }
+            using value_type = typename std::remove_reference<
+                typename std::tuple_element<I, Tuple>::type>::type;
+            typename Context::template scanner_type<value_type> s;
+            auto err = pctx.parse(s);
+            if (!err) {
+                return err;
+            }
+            return s.scan(std::get<I>(args), ctx);
         }
-        ctx.range().set_rollback_point();
-        return {{}, ctx.range().get_return()};
+
+        /**
+         * Arguments of \ref visit_static: references to the arguments,
+         * scanned by calling `scanner<CharT, T>::parse` and `scan` directly
+         */
+        template <typename Context, typename... Args>
+        struct static_arg_source {
+            using arg_type = std::ptrdiff_t;
+
+            template <typename ParseCtx>
+            expected<arg_type> next(Context& ctx, ParseCtx& pctx)
+            {
+                return next_arg_index(ctx, pctx);
+            }
+            template <typename ParseCtx>
+            error scan(Context& ctx, ParseCtx& pctx, arg_type i)
+            {
+                return scan_static_nth<0>(ctx, pctx, i, args,
+                                          std::false_type{});
+            }
+
+            std::tuple<Args&...> args;
+        };
+    }  // namespace detail
+
+    /**
+     * Like \ref visit, but with the arguments not type-erased, so that the
+     * scanners can be inlined
+     */
+    template <typename Context, typename ParseCtx, typename... Args>
+    scan_result_for_t<Context> visit_static(Context& ctx,
+                                            ParseCtx& pctx,
+                                            Args&... args)
+    {
+        static_assert(sizeof...(Args) > 0,
+                      "Have to scan at least a single argument");
+        auto source =
+            detail::static_arg_source<Context, Args...>{std::tie(args...)};
+        return detail::visit_with(ctx, pctx, source);
     }
 
     SCN_END_NAMESPACE
@@ -236,6 +236,45 @@
  * // word == "world!"
  * \endcode
  *
+ * Strings with other allocators, like `std::pmr::string`, can be read, too.
+ * The scanned string is allocated with the allocator of the destination.
+ * To read a lot of short strings from a file without allocating every one of
+ * them, `scn::arena_string_view` from `<scn/arena.h>` copies them into a
+ * `scn::monotonic_arena` (see \ref arena).
+ *
+ * \code{.cpp}
+ * scn::monotonic_arena arena;
+ * scn::arena_string_view word{arena};
+ * scn::scan(scn::cstdin(), "{}", word);
+ * // word.view() points into arena
+ * \endcode
+ *
+ * Fields with only a few different values, like status codes or host names,
+ * can be scanned into a `scn::interned` from `<scn/intern.h>`. Every
+ * different string is stored once in an intern pool, and the scanned value
+ * is its id (see \ref intern).
+ *
+ * \code{.cpp}
+ * scn::intern_pool pool;
+ * scn::interned<scn::intern_pool> method{pool};
+ * scn::scan(line, "{}", method);
+ * // method.id() is the same for every "GET"
+ * \endcode
+ *
+ * Enumerations can be scanned by their enumerator names, after registering
+ * the names with `scn::enum_names` from `<scn/enum.h>` (see \ref enum).
+ *
+ * Comma-, tab- or otherwise delimited records can be scanned with a single
+ * format string by passing a delimiter set to `scn::scan`. The values then
+ * end at a delimiter, and strings may contain whitespace.
+ *
+ * \code{.cpp}
+ * std::string name;
+ * int age;
+ * scn::scan("John Doe,42", scn::with_delimiters(",;\t"), "{} {}", name, age);
+ * // name == "John Doe", age == 42
+ * \endcode
+ *
  * If reading word-by-word isn't what you're looking for, you can use
  * `scn::getline`. It works pretty much the same way as `std::getline` does for
  * `std::string`s.
@@ -250,6 +289,56 @@
  * // The delimeter is not included in the output
  * \endcode
  *
+ * To go through every line of a contiguous range, `scn::lines` from
+ * `<scn/lines.h>` is faster than calling `scn::getline` in a loop.
+ * It gives the lines as `string_view`s into the range, and doesn't allocate.
+ *
+ * \code{.cpp}
+ * scn::mapped_file file{"data.txt"};
+ * for (auto line : scn::lines(file, scn::line_ending::crlf)) {
+ *     // ...
+ * }
+ * \endcode
+ *
+ * When the same file is read many times, jumping to specific lines,
+ * `scn::indexed_file` from `<scn/line_index.h>` keeps an index of the line
+ * offsets next to the file, so that every run after the first one can go
+ * straight to a line (see \ref line_index).
+ *
+ * \code{.cpp}
+ * scn::indexed_file file{"data.txt"};
+ * int value;
+ * file.scan_record(123456, "{}", value);
+ * \endcode
+ *
+ * Files that are being appended to, like logs, can be followed with
+ * `scn::file_follower` from `<scn/follow.h>`. Every poll reads only the bytes
+ * appended since the previous one, and its position can be checkpointed,
+ * so that a restarted process doesn't read the file again
+ * (see \ref follow).
+ *
+ * \code{.cpp}
+ * scn::file_follower log{"app.log", checkpoint};
+ * for (;;) {
+ *     log.wait(1000);
+ *     log.poll([](scn::string_view line) {
+ *         // ...
+ *     });
+ *     checkpoint = log.checkpoint();
+ * }
+ * \endcode
+ *
+ * Files that are scanned in full on every run, with the same format, can be
+ * scanned into columns with `scn::scan_columns` from `<scn/columns.h>`.
+ * The columns are cached in a binary file next to the source, which later
+ * runs map into memory instead of parsing the source again
+ * (see \ref columns).
+ *
+ * \code{.cpp}
+ * auto cols = scn::scan_columns<int, double>("data.txt", "{} {}");
+ * scn::span<const double> values = cols.column<1>();
+ * \endcode
+ *
  * \section error Error handling
  *
  * `scnlib` does not use exceptions for error handling.
@@ -463,7 +552,47 @@
  * After that, an optional `b` can be given, which has no effect.
  *
  * \par Strings
- * Only supported option is `s`, which has no effect
+ * Either `s`, which has no effect, or a scanset: a set of characters in
+ * brackets, like `[a-zA-Z0-9_]`. With a scanset, the longest run of characters
+ * in the set is read, instead of a word. At least one character has to match.
+ *  - `^` right after the opening `[` inverts the set: `[^,]` reads until the
+ *    next comma, including any whitespace
+ *  - `a-z` is a range of characters
+ *  - `]` right after the opening `[` (or `[^`), and `-` right before the
+ *    closing `]`, are literal
+ *
+ * \par
+ * Scansets can be used with `std::string`s, `string_view`s, and the string
+ * types in `<scn/arena.h>` and `<scn/intern.h>`. The set is compiled into a
+ * bitmap when the format string is parsed, and matched many characters at a
+ * time (see \ref simd) on contiguous ranges.
+ *
+ * \par
+ * \code{.cpp}
+ * std::string key, value;
+ * scn::scan("user name=John Doe", "{:[^=]}={:[^\n]}", key, value);
+ * // key == "user name", value == "John Doe"
+ * \endcode
+ *
+ * \par
+ * `q` and `Q` read a string quoted with `"`, without the quotes, which may
+ * contain whitespace. With `q`, a quote is escaped by doubling it, as in CSV:
+ * `"say ""hi"""`. With `Q`, C and JSON backslash escapes are decoded:
+ * `\"`, `\\`, `\n`, `\t`, `\xHH`, `\uXXXX` (with surrogate pairs), and so on,
+ * with `\u` written as UTF-8 into `char` strings.
+ * A value that doesn't begin with a quote is read like without `q` or `Q`.
+ * On contiguous ranges, a `string_view` points into the source without
+ * copying, but only if the string contains no escapes: otherwise, reading it
+ * fails.
+ *
+ * \par
+ * \code{.cpp}
+ * std::string name;
+ * int age;
+ * scn::scan("\"Doe, John\",42", scn::with_delimiters(","), "{:q},{}",
+ *           name, age);
+ * // name == "Doe, John"
+ * \endcode
  *
  * \par Characters
  * Only supported option is `c`, which has no effect
@@ -475,7 +604,7 @@
  *
  * \par Literal characters
  * To scan literal characters and immediately discard them, just write the
- * characters in the format string. `scanf`-like `[]`-wildcard is not supported.
+ * characters in the format string.
  * To read literal `{` or `}`, write `{{` or `}}`, respectively.
  *
  * \par
@@ -497,6 +626,17 @@
  * // scn::scan(range, "{}", value);
  * \endcode
  *
+ * \par Static scanning
+ * `scn::scan` type-erases its arguments, so that the scanning loop is compiled
+ * only once per range type. In a hot loop, `scn::scan_static` can be used
+ * instead: it takes the same arguments, but calls the scanners of the
+ * argument types directly, so that they can be inlined.
+ *
+ * \par
+ * \code{.cpp}
+ * scn::scan_static(range, scn::default_tag, value);
+ * \endcode
+ *
  * \section locale Localization
  *
  * To scan localized input, a `std::locale` can be passed as the first argument
@@ -667,6 +807,8 @@
  * compatible with C `scanf`: "%f != %lf", `scanf` doesn't support
  * dynamic-length strings.
  *
+ * Scansets work the same way: `%[a-z]` is `{:[a-z]}`.
+ *
  * To read literal a `%`-character and immediately discard it, write `%%` (`{{`
  * and `}}` with default format string syntax).
  */
@@ -708,6 +850,15 @@
  *  * `SCN_COVERAGE`: Generate code coverage report
  *  * `SCN_BLOAT`: Generate bloat test target
  *  * `SCN_BUILD_FUZZING`: Build fuzzer
+ *
+ * \section cmake-simd Runtime CPU dispatch
+ *
+ * Vectorized (SSE4.2, AVX2, AVX-512BW or NEON) implementations of the hot
+ * loops of the library are compiled in regardless of `SCN_USE_NATIVE_ARCH`,
+ * and the best one supported by the running CPU is picked on first use.
+ * Setting the environment variable `SCN_SIMD` to `scalar`, `sse4.2`, `avx2`,
+ * `avx512bw` or `neon` forces a level, if it's supported.
+ * See \ref simd for querying the selection.
  */
 
 /**
@@ -0,0 +1,69 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY
+#define SCN_ARENA_CPP
+#endif
+
+#include <scn/detail/arena.h>
+
+#include <new>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    SCN_FUNC void monotonic_arena::release() noexcept
+    {
+        while (m_chunks) {
+            auto next = m_chunks->next;
+            ::operator delete(static_cast<void*>(m_chunks));
+            m_chunks = next;
+        }
+        m_cur = m_initial;
+        m_end = m_initial ? m_initial + m_initial_size : nullptr;
+        m_chunk_bytes = 0;
+    }
+
+    SCN_FUNC void* monotonic_arena::_allocate_slow(std::size_t n,
+                                                   std::size_t align)
+    {
+        // Chunks grow geometrically, so that the number of chunks stays
+        // logarithmic in the amount of memory allocated
+        auto size = m_chunk_size;
+        if (m_chunks) {
+            size = m_chunks->size * 2;
+        }
+        if (size < sizeof(chunk_header) + n + align) {
+            size = sizeof(chunk_header) + n + align;
+        }
+
+        auto c = static_cast<chunk_header*>(::operator new(size));
+        c->next = m_chunks;
+        c->size = size;
+        m_chunks = c;
+        m_chunk_bytes += size;
+
+        m_cur = reinterpret_cast<unsigned char*>(c) + sizeof(chunk_header);
+        m_end = reinterpret_cast<unsigned char*>(c) + size;
+
+        const auto p = m_cur + _padding(m_cur, align);
+        m_cur = p + n;
+        return p;
+    }
+
+    SCN_END_NAMESPACE
+}  // namespace scn
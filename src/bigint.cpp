@@ -0,0 +1,254 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY
+#define SCN_BIGINT_CPP
+#endif
+
+#include <scn/detail/bigint.h>
+
+#include <algorithm>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    namespace detail {
+        struct big_uint_ops {
+            using limb = uint64_t;
+
+            // Below this many limbs, schoolbook multiplication is faster
+            static constexpr std::size_t karatsuba_threshold = 32;
+            // Below this many chunks, they're combined one at a time
+            static constexpr std::size_t chunk_threshold = 32;
+
+            // a * b + c + d, the high limb into `hi`
+            static limb mul_add(limb a, limb b, limb c, limb d, limb& hi)
+            {
+#if SCN_HAS_INT128
+                const auto p = static_cast<uint128>(a) * b + c + d;
+                hi = static_cast<limb>(p >> 64);
+                return static_cast<limb>(p);
+#else
+                const auto mask = UINT64_C(0xffffffff);
+                const auto a0 = a & mask, a1 = a >> 32;
+                const auto b0 = b & mask, b1 = b >> 32;
+                const auto p00 = a0 * b0, p01 = a0 * b1;
+                const auto p10 = a1 * b0, p11 = a1 * b1;
+                const auto mid = (p00 >> 32) + (p01 & mask) + (p10 & mask);
+                limb lo = (mid << 32) | (p00 & mask);
+                hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+                lo += c;
+                hi += lo < c ? 1 : 0;
+                lo += d;
+                hi += lo < d ? 1 : 0;
+                return lo;
+#endif
+            }
+
+            // out[0, n) += x[0, nx), nx <= n
+            static void add_to(limb* out,
+                               std::size_t n,
+                               const limb* x,
+                               std::size_t nx)
+            {
+                limb carry = 0;
+                std::size_t i = 0;
+                for (; i < nx; ++i) {
+                    const auto s = out[i] + carry;
+                    carry = s < carry ? 1 : 0;
+                    out[i] = s + x[i];
+                    carry += out[i] < s ? 1 : 0;
+                }
+                for (; carry != 0 && i < n; ++i) {
+                    carry = ++out[i] == 0 ? 1 : 0;
+                }
+            }
+            // out[0, n) -= x[0, nx), the result isn't negative
+            static void sub_from(limb* out,
+                                 std::size_t n,
+                                 const limb* x,
+                                 std::size_t nx)
+            {
+                limb borrow = 0;
+                std::size_t i = 0;
+                for (; i < nx; ++i) {
+                    const auto d = out[i] - x[i];
+                    const auto b = out[i] < x[i] ? 1 : 0;
+                    out[i] = d - borrow;
+                    borrow = static_cast<limb>(b) + (d < borrow ? 1 : 0);
+                }
+                for (; borrow != 0 && i < n; ++i) {
+                    borrow = out[i]-- == 0 ? 1 : 0;
+                }
+            }
+
+            static std::vector<limb> sum(const limb* x,
+                                         std::size_t nx,
+                                         const limb* y,
+                                         std::size_t ny)
+            {
+                if (nx < ny) {
+                    std::swap(x, y);
+                    std::swap(nx, ny);
+                }
+                std::vector<limb> r(x, x + nx);
+                r.push_back(0);
+                add_to(r.data(), r.size(), y, ny);
+                return r;
+            }
+
+            static std::size_t trimmed(const limb* x, std::size_t n)
+            {
+                while (n != 0 && x[n - 1] == 0) {
+                    --n;
+                }
+                return n;
+            }
+
+            // out[0, na + nb) = a * b, `out` is zeroed
+            static void mul(const limb* a,
+                            std::size_t na,
+                            const limb* b,
+                            std::size_t nb,
+                            limb* out)
+            {
+                if (na < nb) {
+                    std::swap(a, b);
+                    std::swap(na, nb);
+                }
+                if (nb < karatsuba_threshold) {
+                    for (std::size_t j = 0; j < nb; ++j) {
+                        limb carry = 0;
+                        for (std::size_t i = 0; i < na; ++i) {
+                            out[i + j] =
+                                mul_add(a[i], b[j], out[i + j], carry, carry);
+                        }
+                        out[na + j] = carry;
+                    }
+                    return;
+                }
+                if (2 * nb <= na) {
+                    // unbalanced: `nb` limbs of `a` at a time
+                    std::vector<limb> tmp(2 * nb);
+                    for (std::size_t i = 0; i < na; i += nb) {
+                        const auto len = std::min(nb, na - i);
+                        std::fill(tmp.begin(), tmp.end(), limb{0});
+                        mul(a + i, len, b, nb, tmp.data());
+                        add_to(out + i, na + nb - i, tmp.data(), len + nb);
+                    }
+                    return;
+                }
+
+                // Karatsuba: a = a1 * B^m + a0, b = b1 * B^m + b0,
+                // a * b = z2 * B^2m + z1 * B^m + z0, where
+                // z1 = (a0 + a1) * (b0 + b1) - z0 - z2
+                const auto m = na / 2;
+                mul(a, m, b, m, out);
+                mul(a + m, na - m, b + m, nb - m, out + 2 * m);
+
+                const auto sa = sum(a, m, a + m, na - m);
+                const auto sb = sum(b, m, b + m, nb - m);
+                const auto nsa = trimmed(sa.data(), sa.size());
+                const auto nsb = trimmed(sb.data(), sb.size());
+                std::vector<limb> z1(nsa + nsb);
+                mul(sa.data(), nsa, sb.data(), nsb, z1.data());
+                sub_from(z1.data(), z1.size(), out, trimmed(out, 2 * m));
+                sub_from(z1.data(), z1.size(), out + 2 * m,
+                         trimmed(out + 2 * m, na + nb - 2 * m));
+                add_to(out + m, na + nb - m, z1.data(),
+                       trimmed(z1.data(), z1.size()));
+            }
+
+            static big_uint mul(const big_uint& a, const big_uint& b)
+            {
+                const auto& la = a.limbs();
+                const auto& lb = b.limbs();
+                if (la.empty() || lb.empty()) {
+                    return {};
+                }
+                std::vector<limb> out(la.size() + lb.size());
+                mul(la.data(), la.size(), lb.data(), lb.size(), out.data());
+                return big_uint::from_limbs(std::move(out));
+            }
+
+            // chunks[0, n), the most significant first, in base
+            // `powers[0]`; `powers[t]` is `powers[0]^(2^t)`
+            static big_uint combine(const limb* chunks,
+                                    std::size_t n,
+                                    const std::vector<big_uint>& powers)
+            {
+                if (n <= chunk_threshold) {
+                    const auto base = powers[0].limbs()[0];
+                    std::vector<limb> v;
+                    v.reserve(n);
+                    for (std::size_t i = 0; i < n; ++i) {
+                        limb carry = chunks[i];
+                        for (auto& l : v) {
+                            l = mul_add(l, base, carry, 0, carry);
+                        }
+                        if (carry != 0) {
+                            v.push_back(carry);
+                        }
+                    }
+                    return big_uint::from_limbs(std::move(v));
+                }
+                // the low part is the largest power of two of chunks
+                std::size_t t = 0;
+                while ((std::size_t{2} << t) < n) {
+                    ++t;
+                }
+                const auto low = std::size_t{1} << t;
+                return mul(combine(chunks, n - low, powers), powers[t]) +
+                       combine(chunks + n - low, low, powers);
+            }
+        };
+    }  // namespace detail
+
+    SCN_FUNC big_uint operator+(const big_uint& a, const big_uint& b)
+    {
+        const auto& longer = a.m_limbs.size() >= b.m_limbs.size() ? a : b;
+        const auto& shorter = &longer == &a ? b : a;
+        auto r = longer;
+        r.m_limbs.push_back(0);
+        detail::big_uint_ops::add_to(r.m_limbs.data(), r.m_limbs.size(),
+                                     shorter.m_limbs.data(),
+                                     shorter.m_limbs.size());
+        r._trim();
+        return r;
+    }
+    SCN_FUNC big_uint operator*(const big_uint& a, const big_uint& b)
+    {
+        return detail::big_uint_ops::mul(a, b);
+    }
+
+    SCN_FUNC big_uint big_uint_from_chunks(const uint64_t* chunks,
+                                           std::size_t n,
+                                           uint64_t chunk_base)
+    {
+        using ops = detail::big_uint_ops;
+
+        std::vector<big_uint> powers{big_uint{chunk_base}};
+        if (n > ops::chunk_threshold) {
+            while ((std::size_t{2} << (powers.size() - 1)) < n) {
+                powers.push_back(ops::mul(powers.back(), powers.back()));
+            }
+        }
+        return ops::combine(chunks, n, powers);
+    }
+
+    SCN_END_NAMESPACE
+}  // namespace scn
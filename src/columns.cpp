@@ -0,0 +1,211 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY
+#define SCN_COLUMNS_CPP
+#endif
+
+#include <scn/detail/columns.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    namespace detail {
+        /*
+         * Layout of a cache file, in native byte order:
+         *
+         * header:
+         *   char[8]  magic "SCNCOL01"
+         *   uint32   0x01020304, to detect a different byte order
+         *   uint32   number of columns
+         *   uint64   source size
+         *   int64    source modification time
+         *   uint64   hash of the format string and the column types
+         *   uint64   number of rows
+         *   char[16] reserved, zero
+         * columns, one entry per column:
+         *   uint64   offset of the values of the column
+         *   uint64   size of a value
+         * values:
+         *   the values of each column, as an array, starting at an offset
+         *   aligned to 64 bytes
+         */
+        struct columns_layout {
+            static constexpr std::size_t header_size = 64;
+            static constexpr std::size_t entry_size = 16;
+            static constexpr std::size_t alignment = 64;
+            static constexpr uint32_t byte_order_mark = 0x01020304;
+
+            static const char* magic()
+            {
+                return "SCNCOL01";
+            }
+
+            template <typename T>
+            static T read(const unsigned char* p)
+            {
+                T val{};
+                std::memcpy(&val, p, sizeof(T));
+                return val;
+            }
+            template <typename T>
+            static void write(unsigned char* p, T val)
+            {
+                std::memcpy(p, &val, sizeof(T));
+            }
+        };
+
+        SCN_FUNC uint64_t
+        columns_access::format_hash(string_view format,
+                                    const std::string& signature,
+                                    line_ending ending)
+        {
+            // FNV-1a
+            uint64_t h = 0xcbf29ce484222325;
+            auto feed = [&](const char* b, std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    h ^= static_cast<unsigned char>(b[i]);
+                    h *= 0x100000001b3;
+                }
+            };
+            feed(format.data(), format.size());
+            feed("", 1);
+            feed(signature.data(), signature.size());
+            // The same rows split differently depending on the line ending
+            const char e = ending == line_ending::crlf ? 1 : 0;
+            feed(&e, 1);
+            return h;
+        }
+
+        SCN_FUNC std::string columns_access::default_cache_path(
+            const char* filename)
+        {
+            return std::string{filename} + ".scncol";
+        }
+
+        SCN_FUNC void columns_access::encode(std::vector<unsigned char>& out,
+                                             source_stamp stamp,
+                                             uint64_t hash,
+                                             uint64_t rows,
+                                             std::size_t ncols,
+                                             const void* const* cols,
+                                             const std::size_t* elem_sizes)
+        {
+            using layout = columns_layout;
+
+            auto align = [](std::size_t n) {
+                return (n + layout::alignment - 1) / layout::alignment *
+                       layout::alignment;
+            };
+            const auto nrows = static_cast<std::size_t>(rows);
+
+            auto size =
+                align(layout::header_size + ncols * layout::entry_size);
+            std::vector<std::size_t> offsets(ncols);
+            for (std::size_t i = 0; i < ncols; ++i) {
+                offsets[i] = size;
+                size = align(size + nrows * elem_sizes[i]);
+            }
+
+            out.assign(size, 0);
+            auto p = out.data();
+            std::memcpy(p, layout::magic(), 8);
+            layout::write(p + 8, layout::byte_order_mark);
+            layout::write(p + 12, static_cast<uint32_t>(ncols));
+            layout::write(p + 16, stamp.size);
+            layout::write(p + 24, stamp.mtime);
+            layout::write(p + 32, hash);
+            layout::write(p + 40, rows);
+            for (std::size_t i = 0; i < ncols; ++i) {
+                const auto entry =
+                    p + layout::header_size + i * layout::entry_size;
+                layout::write(entry, static_cast<uint64_t>(offsets[i]));
+                layout::write(entry + 8,
+                              static_cast<uint64_t>(elem_sizes[i]));
+                if (nrows != 0) {
+                    std::memcpy(p + offsets[i], cols[i],
+                                nrows * elem_sizes[i]);
+                }
+            }
+        }
+
+        SCN_FUNC bool columns_access::decode(const unsigned char* data,
+                                             std::size_t size,
+                                             source_stamp stamp,
+                                             uint64_t hash,
+                                             std::size_t ncols,
+                                             const std::size_t* elem_sizes,
+                                             const unsigned char** cols,
+                                             uint64_t& rows)
+        {
+            using layout = columns_layout;
+
+            if (size < layout::header_size + ncols * layout::entry_size ||
+                std::memcmp(data, layout::magic(), 8) != 0 ||
+                layout::read<uint32_t>(data + 8) !=
+                    layout::byte_order_mark ||
+                layout::read<uint32_t>(data + 12) != ncols ||
+                layout::read<uint64_t>(data + 16) != stamp.size ||
+                layout::read<int64_t>(data + 24) != stamp.mtime ||
+                layout::read<uint64_t>(data + 32) != hash) {
+                return false;
+            }
+            const auto r = layout::read<uint64_t>(data + 40);
+            for (std::size_t i = 0; i < ncols; ++i) {
+                const auto entry =
+                    data + layout::header_size + i * layout::entry_size;
+                const auto offset = layout::read<uint64_t>(entry);
+                const auto elem_size = layout::read<uint64_t>(entry + 8);
+                if (elem_size != elem_sizes[i] ||
+                    offset % layout::alignment != 0 || offset > size ||
+                    r > (size - offset) / elem_size) {
+                    return false;
+                }
+                cols[i] = data + static_cast<std::size_t>(offset);
+            }
+            rows = r;
+            return true;
+        }
+
+        SCN_FUNC error columns_access::save(
+            const std::vector<unsigned char>& data,
+            const char* filename)
+        {
+            // Other processes may have the old cache file mapped
+            return replace_file(filename, data.data(), data.size());
+        }
+
+        SCN_FUNC bool columns_access::is_empty_file(const char* filename)
+        {
+            SCN_MSVC_PUSH
+            SCN_MSVC_IGNORE(4996)  // fopen may be unsafe
+            auto f = std::fopen(filename, "rb");
+            SCN_MSVC_POP
+            if (!f) {
+                return false;
+            }
+            const auto empty = std::fgetc(f) == EOF && !std::ferror(f);
+            std::fclose(f);
+            return empty;
+        }
+    }  // namespace detail
+
+    SCN_END_NAMESPACE
+}  // namespace scn
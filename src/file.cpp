@@ -105,7 +105,9 @@ namespace scn {
             CloseHandle(m_begin);
             CloseHandle(m_file.handle);
 #endif
-            *this = mapped_file{};
+            m_file = file_handle::invalid();
+            m_begin = nullptr;
+            m_end = nullptr;
             SCN_ENSURE(!valid());
         }
 
@@ -0,0 +1,430 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY
+#define SCN_FOLLOW_CPP
+#endif
+
+#include <scn/detail/follow.h>
+#include <scn/detail/line_index.h>
+#include <scn/detail/scan.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#if SCN_POSIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#elif SCN_WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#undef NOMINMAX
+#undef WIN32_LEAN_AND_MEAN
+#endif
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#define SCN_HAS_INOTIFY 1
+#else
+#define SCN_HAS_INOTIFY 0
+#endif
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    namespace detail {
+        struct follow_io {
+            // Largest amount of bytes read with a single call
+            static constexpr std::size_t chunk_size = std::size_t{1} << 20;
+
+            struct file_info {
+                uint64_t size{0};
+                uint64_t id{0};
+                bool ok{false};
+            };
+
+#if SCN_WINDOWS
+            // The file index plays the part of an inode number
+            static file_info handle_info(HANDLE h)
+            {
+                file_info i{};
+                BY_HANDLE_FILE_INFORMATION fi{};
+                if (GetFileInformationByHandle(h, &fi)) {
+                    i.size = (static_cast<uint64_t>(fi.nFileSizeHigh) << 32) |
+                             fi.nFileSizeLow;
+                    i.id = (static_cast<uint64_t>(fi.nFileIndexHigh) << 32) |
+                           fi.nFileIndexLow;
+                    i.ok = true;
+                }
+                return i;
+            }
+#endif
+
+            static int open(const char* filename)
+            {
+#if SCN_POSIX
+                return ::open(filename, O_RDONLY | O_CLOEXEC);
+#elif SCN_WINDOWS
+                return ::_open(filename, _O_RDONLY | _O_BINARY);
+#else
+                SCN_UNUSED(filename);
+                return -1;
+#endif
+            }
+            static void close(int fd)
+            {
+#if SCN_POSIX
+                ::close(fd);
+#elif SCN_WINDOWS
+                ::_close(fd);
+#else
+                SCN_UNUSED(fd);
+#endif
+            }
+
+            static file_info info(int fd)
+            {
+                file_info i{};
+#if SCN_POSIX
+                struct stat st {};
+                if (fstat(fd, &st) == 0) {
+                    i.size = static_cast<uint64_t>(st.st_size);
+                    i.id = st.st_ino;
+                    i.ok = true;
+                }
+#elif SCN_WINDOWS
+                const auto h = reinterpret_cast<HANDLE>(::_get_osfhandle(fd));
+                if (h != INVALID_HANDLE_VALUE) {
+                    i = handle_info(h);
+                }
+#else
+                SCN_UNUSED(fd);
+#endif
+                return i;
+            }
+            static file_info info(const char* filename)
+            {
+                file_info i{};
+#if SCN_POSIX
+                struct stat st {};
+                if (stat(filename, &st) == 0) {
+                    i.size = static_cast<uint64_t>(st.st_size);
+                    i.id = st.st_ino;
+                    i.ok = true;
+                }
+#elif SCN_WINDOWS
+                // Opened with every sharing mode, to not get in the way of
+                // the writer, or of rotating the file
+                const auto h = CreateFileA(
+                    filename, 0,
+                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                    NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+                if (h != INVALID_HANDLE_VALUE) {
+                    i = handle_info(h);
+                    CloseHandle(h);
+                }
+#else
+                SCN_UNUSED(filename);
+#endif
+                return i;
+            }
+
+            // Reads [offset, offset + n) of fd into dest,
+            // returns the number of bytes read, or -1 on error
+            static long long read_at(int fd,
+                                     char* dest,
+                                     std::size_t n,
+                                     uint64_t offset)
+            {
+#if SCN_POSIX
+                return static_cast<long long>(
+                    ::pread(fd, dest, n, static_cast<off_t>(offset)));
+#elif SCN_WINDOWS
+                if (::_lseeki64(fd, static_cast<long long>(offset),
+                                SEEK_SET) == -1) {
+                    return -1;
+                }
+                return ::_read(fd, dest, static_cast<unsigned>(n));
+#else
+                SCN_UNUSED(fd);
+                SCN_UNUSED(dest);
+                SCN_UNUSED(n);
+                SCN_UNUSED(offset);
+                return -1;
+#endif
+            }
+
+            static int watch(const char* filename)
+            {
+#if SCN_HAS_INOTIFY
+                int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+                if (fd == -1) {
+                    return -1;
+                }
+                if (inotify_add_watch(fd, filename,
+                                      IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF |
+                                          IN_DELETE_SELF) == -1) {
+                    ::close(fd);
+                    return -1;
+                }
+                return fd;
+#else
+                SCN_UNUSED(filename);
+                return -1;
+#endif
+            }
+            // true, if there was an event
+            static bool wait_for_event(int fd, int timeout_ms)
+            {
+#if SCN_HAS_INOTIFY
+                pollfd p{};
+                p.fd = fd;
+                p.events = POLLIN;
+                if (::poll(&p, 1, timeout_ms) <= 0) {
+                    return false;
+                }
+                // drain the queued events
+                char buf[4096];
+                while (::read(fd, buf, sizeof(buf)) > 0) {
+                }
+                return true;
+#else
+                SCN_UNUSED(fd);
+                SCN_UNUSED(timeout_ms);
+                return false;
+#endif
+            }
+        };
+    }  // namespace detail
+
+    SCN_FUNC error save_follow_checkpoint(const follow_checkpoint& cp,
+                                          const char* filename)
+    {
+        char buf[64];
+        const auto n =
+            std::snprintf(buf, sizeof(buf), "scnfollow1 %llu %llu\n",
+                          static_cast<unsigned long long>(cp.offset),
+                          static_cast<unsigned long long>(cp.file_id));
+        if (n < 0 || static_cast<std::size_t>(n) >= sizeof(buf)) {
+            return error(error::source_error,
+                         "Failed to format checkpoint file");
+        }
+        // Replaced atomically, so that a crash never leaves a partially
+        // written checkpoint
+        return detail::replace_file(filename, buf,
+                                    static_cast<std::size_t>(n));
+    }
+
+    SCN_FUNC expected<follow_checkpoint> load_follow_checkpoint(
+        const char* filename)
+    {
+        mapped_file source{filename};
+        if (!source.valid()) {
+            return error(error::source_error,
+                         "Failed to open checkpoint file");
+        }
+        unsigned long long offset{}, id{};
+        auto ret = scan(source.make_view(), "scnfollow1 {} {}", offset, id);
+        if (!ret) {
+            return error(error::invalid_argument, "Invalid checkpoint file");
+        }
+        follow_checkpoint cp{};
+        cp.offset = static_cast<uint64_t>(offset);
+        cp.file_id = static_cast<uint64_t>(id);
+        return cp;
+    }
+
+    SCN_FUNC file_follower::file_follower(const char* filename,
+                                          follow_checkpoint cp)
+        : m_filename(filename)
+    {
+        _open(cp);
+    }
+
+    SCN_FUNC file_follower::file_follower(file_follower&& o) noexcept
+        : m_filename(std::move(o.m_filename)),
+          m_buffer(std::move(o.m_buffer)),
+          m_checkpoint(o.m_checkpoint),
+          m_read_end(o.m_read_end),
+          m_fd(o.m_fd),
+          m_notify(o.m_notify)
+    {
+        o.m_fd = -1;
+        o.m_notify = -1;
+    }
+    SCN_FUNC file_follower& file_follower::operator=(
+        file_follower&& o) noexcept
+    {
+        if (this != &o) {
+            _close();
+            m_filename = std::move(o.m_filename);
+            m_buffer = std::move(o.m_buffer);
+            m_checkpoint = o.m_checkpoint;
+            m_read_end = o.m_read_end;
+            m_fd = o.m_fd;
+            m_notify = o.m_notify;
+            o.m_fd = -1;
+            o.m_notify = -1;
+        }
+        return *this;
+    }
+
+    SCN_FUNC file_follower::~file_follower()
+    {
+        _close();
+    }
+
+    SCN_FUNC error file_follower::_open(follow_checkpoint cp)
+    {
+        using io = detail::follow_io;
+
+        m_buffer.clear();
+        m_fd = io::open(m_filename.c_str());
+        if (m_fd == -1) {
+            return error(error::source_error, "Failed to open file");
+        }
+        const auto info = io::info(m_fd);
+        if (!info.ok) {
+            _close();
+            return error(error::source_error, "Failed to query file");
+        }
+        if ((cp.file_id != 0 && cp.file_id != info.id) ||
+            cp.offset > info.size) {
+            // a different file, or the checkpointed one truncated
+            cp.offset = 0;
+        }
+        m_checkpoint.offset = cp.offset;
+        m_checkpoint.file_id = info.id;
+        m_read_end = cp.offset;
+        m_notify = io::watch(m_filename.c_str());
+        return {};
+    }
+
+    SCN_FUNC void file_follower::_close() noexcept
+    {
+        if (m_fd != -1) {
+            detail::follow_io::close(m_fd);
+            m_fd = -1;
+        }
+        if (m_notify != -1) {
+            detail::follow_io::close(m_notify);
+            m_notify = -1;
+        }
+    }
+
+    SCN_FUNC expected<std::size_t> file_follower::_read_appended()
+    {
+        using io = detail::follow_io;
+
+        if (!valid()) {
+            return error(error::invalid_operation, "File is not open");
+        }
+        auto info = io::info(m_fd);
+        if (!info.ok) {
+            return error(error::source_error, "Failed to query file");
+        }
+        if (info.size < m_read_end) {
+            // truncated: start over
+            m_buffer.clear();
+            m_checkpoint.offset = 0;
+            m_read_end = 0;
+        }
+        else if (info.size == m_read_end) {
+            const auto path_info = io::info(m_filename.c_str());
+            if (path_info.ok && path_info.id != info.id) {
+                // rotated, and the old file has been read through:
+                // drop its incomplete final line, and switch over
+                _close();
+                auto e = _open(follow_checkpoint{});
+                if (!e) {
+                    return e;
+                }
+                info = io::info(m_fd);
+                if (!info.ok) {
+                    return error(error::source_error, "Failed to query file");
+                }
+            }
+        }
+        if (m_read_end == info.size) {
+            return std::size_t{0};
+        }
+
+        const auto n = static_cast<std::size_t>(
+            std::min(static_cast<uint64_t>(io::chunk_size),
+                     info.size - m_read_end));
+        const auto old_size = m_buffer.size();
+        m_buffer.resize(old_size + n);
+        const auto ret =
+            io::read_at(m_fd, &m_buffer[old_size], n, m_read_end);
+        if (ret <= 0) {
+            m_buffer.resize(old_size);
+            if (ret == 0) {
+                // truncated while reading, noticed on the next poll
+                return std::size_t{0};
+            }
+            return error(error::source_error, "Failed to read file");
+        }
+        m_buffer.resize(old_size + static_cast<std::size_t>(ret));
+        m_read_end += static_cast<uint64_t>(ret);
+        return static_cast<std::size_t>(ret);
+    }
+
+    SCN_FUNC bool file_follower::wait(int timeout_ms)
+    {
+        using io = detail::follow_io;
+
+        auto changed = [&]() {
+            const auto info = io::info(m_fd);
+            if (info.ok && info.size != m_read_end) {
+                return true;
+            }
+            const auto path_info = io::info(m_filename.c_str());
+            return path_info.ok && path_info.id != m_checkpoint.file_id;
+        };
+
+        if (!valid()) {
+            return false;
+        }
+        if (changed()) {
+            return true;
+        }
+        if (m_notify != -1) {
+            return io::wait_for_event(m_notify, timeout_ms);
+        }
+
+        using clock = std::chrono::steady_clock;
+        const auto deadline =
+            clock::now() + std::chrono::milliseconds(timeout_ms);
+        while (clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (changed()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    SCN_END_NAMESPACE
+}  // namespace scn
@@ -0,0 +1,522 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY
+#define SCN_LINE_INDEX_CPP
+#endif
+
+#include <scn/detail/line_index.h>
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#if SCN_POSIX || SCN_WINDOWS
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    namespace detail {
+        /*
+         * Layout of an encoded index, in native byte order:
+         *
+         * header:
+         *   char[8]  magic "SCNLIDX1"
+         *   uint32   0x01020304, to detect a different byte order
+         *   uint32   lines per block (256)
+         *   uint64   source size
+         *   int64    source modification time
+         *   uint64   number of lines
+         *   uint64   number of blocks
+         *   uint64   size of the delta area, in bytes
+         * blocks, one per 256 lines:
+         *   uint64   offset of the first line of the block
+         *   uint64   position of the deltas of the block in the delta area
+         *   uint64   width of a delta of the block: 1, 2, 4 or 8
+         * delta area:
+         *   for each line, the difference of its offset and the offset of the
+         *   first line of its block
+         *
+         * All reads go through memcpy, so nothing has to be aligned.
+         */
+        struct line_index_access {
+            static constexpr std::size_t header_size = 56;
+            static constexpr std::size_t block_entry_size = 24;
+            static constexpr std::size_t block_lines = 256;
+            static constexpr uint32_t byte_order_mark = 0x01020304;
+
+            static const char* magic()
+            {
+                return "SCNLIDX1";
+            }
+
+            template <typename T>
+            static T read(const unsigned char* p)
+            {
+                T val{};
+                std::memcpy(&val, p, sizeof(T));
+                return val;
+            }
+            template <typename T>
+            static unsigned char* write(unsigned char* p, T val)
+            {
+                std::memcpy(p, &val, sizeof(T));
+                return p + sizeof(T);
+            }
+
+            static uint64_t read_delta(const unsigned char* p, uint64_t width)
+            {
+                switch (width) {
+                    case 1:
+                        return *p;
+                    case 2:
+                        return read<uint16_t>(p);
+                    case 4:
+                        return read<uint32_t>(p);
+                    default:
+                        return read<uint64_t>(p);
+                }
+            }
+            static void write_delta(unsigned char* p,
+                                    uint64_t width,
+                                    uint64_t delta)
+            {
+                switch (width) {
+                    case 1:
+                        write(p, static_cast<uint8_t>(delta));
+                        break;
+                    case 2:
+                        write(p, static_cast<uint16_t>(delta));
+                        break;
+                    case 4:
+                        write(p, static_cast<uint32_t>(delta));
+                        break;
+                    default:
+                        write(p, delta);
+                        break;
+                }
+            }
+            static uint64_t delta_width(uint64_t max_delta)
+            {
+                if (max_delta <= 0xff) {
+                    return 1;
+                }
+                if (max_delta <= 0xffff) {
+                    return 2;
+                }
+                if (max_delta <= 0xffffffff) {
+                    return 4;
+                }
+                return 8;
+            }
+
+            // Checks that `[data, data + size)` contains a whole, consistent
+            // index
+            static bool validate(const unsigned char* data, std::size_t size)
+            {
+                if (size < header_size ||
+                    std::memcmp(data, magic(), 8) != 0 ||
+                    read<uint32_t>(data + 8) != byte_order_mark ||
+                    read<uint32_t>(data + 12) != block_lines) {
+                    return false;
+                }
+                const auto lines = read<uint64_t>(data + 32);
+                const auto blocks = read<uint64_t>(data + 40);
+                const auto deltas = read<uint64_t>(data + 48);
+                if (blocks != (lines + block_lines - 1) / block_lines ||
+                    blocks > (size - header_size) / block_entry_size ||
+                    deltas > size) {
+                    return false;
+                }
+                const auto expected_size =
+                    header_size + blocks * block_entry_size + deltas;
+                if (expected_size != size) {
+                    return false;
+                }
+                // the deltas of every block have to fit in the area, and
+                // the first line of every block has to be in the source
+                const auto source_size = read<uint64_t>(data + 16);
+                for (uint64_t blk = 0; blk < blocks; ++blk) {
+                    const auto entry = data + header_size +
+                                       static_cast<std::size_t>(blk) *
+                                           block_entry_size;
+                    const auto base = read<uint64_t>(entry);
+                    const auto pos = read<uint64_t>(entry + 8);
+                    const auto width = read<uint64_t>(entry + 16);
+                    const auto n = blk + 1 == blocks
+                                       ? lines - blk * block_lines
+                                       : uint64_t{block_lines};
+                    if ((width != 1 && width != 2 && width != 4 &&
+                         width != 8) ||
+                        pos > deltas || n * width > deltas - pos ||
+                        base > source_size) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            // Offsets of the beginnings of the lines in
+            // `[chunk_begin, chunk_end)`, except the first line of `source`,
+            // are written into `out`
+            static void find_lines(string_view source,
+                                   std::size_t chunk_begin,
+                                   std::size_t chunk_end,
+                                   uint64_t* out) noexcept
+            {
+                const auto b = source.data();
+                auto it = b + chunk_begin;
+                const auto end = b + chunk_end;
+                while (true) {
+                    it = find_char(it, end, '\n');
+                    if (it == end) {
+                        break;
+                    }
+                    ++it;
+                    *out++ = static_cast<uint64_t>(it - b);
+                }
+            }
+
+            static std::vector<uint64_t> find_offsets(string_view source,
+                                                      unsigned threads)
+            {
+                // Not worth starting a thread for less than this
+                constexpr std::size_t min_chunk = std::size_t{4} << 20;
+
+                const auto size = source.size();
+                if (threads == 0) {
+                    threads = std::thread::hardware_concurrency();
+                }
+                auto chunks = static_cast<std::size_t>(threads);
+                chunks = min(chunks, size / min_chunk);
+                chunks = max(chunks, std::size_t{1});
+
+                const auto chunk_size = size / chunks;
+                std::vector<std::size_t> bounds(chunks + 1);
+                for (std::size_t i = 0; i < chunks; ++i) {
+                    bounds[i] = i * chunk_size;
+                }
+                bounds[chunks] = size;
+
+                // First pass: count the lines beginning in every chunk,
+                // second pass: write down their offsets
+                std::vector<std::size_t> counts(chunks + 1);
+                auto count = [&](std::size_t i) noexcept {
+                    counts[i + 1] = count_char(source.data() + bounds[i],
+                                               source.data() + bounds[i + 1],
+                                               '\n');
+                };
+                run(chunks, count);
+                for (std::size_t i = 0; i < chunks; ++i) {
+                    counts[i + 1] += counts[i];
+                }
+
+                std::vector<uint64_t> offsets(counts[chunks] + 1);
+                offsets[0] = 0;
+                auto find = [&](std::size_t i) noexcept {
+                    find_lines(source, bounds[i], bounds[i + 1],
+                               offsets.data() + counts[i] + 1);
+                };
+                run(chunks, find);
+
+                // No empty line after a final newline
+                if (offsets.back() == size) {
+                    offsets.pop_back();
+                }
+                return offsets;
+            }
+
+            template <typename F>
+            static void run(std::size_t n, F& fn)
+            {
+                std::vector<std::thread> threads;
+                threads.reserve(n - 1);
+                for (std::size_t i = 1; i < n; ++i) {
+                    threads.emplace_back([&fn, i]() noexcept { fn(i); });
+                }
+                fn(std::size_t{0});
+                for (auto& t : threads) {
+                    t.join();
+                }
+            }
+
+            static std::vector<unsigned char> encode(
+                const std::vector<uint64_t>& offsets,
+                source_stamp stamp)
+            {
+                const auto lines = offsets.size();
+                const auto blocks = (lines + block_lines - 1) / block_lines;
+
+                // block table: base, position, width
+                std::vector<uint64_t> table(blocks * 3);
+                uint64_t deltas = 0;
+                for (std::size_t blk = 0; blk < blocks; ++blk) {
+                    const auto first = blk * block_lines;
+                    const auto last = min(first + block_lines, lines) - 1;
+                    const auto width =
+                        delta_width(offsets[last] - offsets[first]);
+                    table[blk * 3] = offsets[first];
+                    table[blk * 3 + 1] = deltas;
+                    table[blk * 3 + 2] = width;
+                    deltas += (last - first + 1) * width;
+                }
+
+                std::vector<unsigned char> buf(
+                    header_size + blocks * block_entry_size +
+                    static_cast<std::size_t>(deltas));
+                auto p = buf.data();
+                std::memcpy(p, magic(), 8);
+                p = write(p + 8, byte_order_mark);
+                p = write(p, static_cast<uint32_t>(block_lines));
+                p = write(p, stamp.size);
+                p = write(p, stamp.mtime);
+                p = write(p, static_cast<uint64_t>(lines));
+                p = write(p, static_cast<uint64_t>(blocks));
+                p = write(p, deltas);
+                for (auto v : table) {
+                    p = write(p, v);
+                }
+
+                for (std::size_t blk = 0; blk < blocks; ++blk) {
+                    const auto base = table[blk * 3];
+                    const auto width = table[blk * 3 + 2];
+                    auto out = p + table[blk * 3 + 1];
+                    const auto first = blk * block_lines;
+                    const auto last = min(first + block_lines, lines);
+                    for (auto i = first; i != last; ++i) {
+                        write_delta(out, width, offsets[i] - base);
+                        out += width;
+                    }
+                }
+                return buf;
+            }
+
+            static void set_buffer(line_index& index,
+                                   std::vector<unsigned char> buf)
+            {
+                index.m_buffer = std::move(buf);
+                index._init();
+            }
+            static void set_map(line_index& index, byte_mapped_file map)
+            {
+                index.m_map = std::move(map);
+                index._init();
+            }
+        };
+    }  // namespace detail
+
+    namespace detail {
+        SCN_FUNC error replace_file(const char* filename,
+                                    const void* data,
+                                    std::size_t size)
+        {
+            // Overwriting the file in place could pull the contents from
+            // under the processes that have it mapped
+            const auto tmp = std::string{filename} + ".tmp";
+            SCN_MSVC_PUSH
+            SCN_MSVC_IGNORE(4996)  // fopen may be unsafe
+            auto f = std::fopen(tmp.c_str(), "wb");
+            SCN_MSVC_POP
+            if (!f) {
+                return error(error::source_error,
+                             "Failed to open file for writing");
+            }
+            const auto written = std::fwrite(data, 1, size, f);
+            if (std::fclose(f) != 0 || written != size) {
+                std::remove(tmp.c_str());
+                return error(error::source_error, "Failed to write file");
+            }
+            if (std::rename(tmp.c_str(), filename) != 0) {
+                // rename doesn't replace an existing file everywhere
+                std::remove(filename);
+                if (std::rename(tmp.c_str(), filename) != 0) {
+                    std::remove(tmp.c_str());
+                    return error(error::source_error,
+                                 "Failed to replace file");
+                }
+            }
+            return {};
+        }
+    }  // namespace detail
+
+    SCN_FUNC source_stamp get_source_stamp(const char* filename)
+    {
+        source_stamp s{};
+#if SCN_WINDOWS
+        struct _stat64 st {};
+        if (_stat64(filename, &st) == 0) {
+            s.size = static_cast<uint64_t>(st.st_size);
+            s.mtime = static_cast<int64_t>(st.st_mtime);
+        }
+#elif SCN_POSIX
+        struct stat st {};
+        if (stat(filename, &st) == 0) {
+            s.size = static_cast<uint64_t>(st.st_size);
+            // a file rewritten within the same second is a different version
+#if defined(__APPLE__)
+            const auto& t = st.st_mtimespec;
+#else
+            const auto& t = st.st_mtim;
+#endif
+            s.mtime = static_cast<int64_t>(t.tv_sec) * 1000000000 +
+                      static_cast<int64_t>(t.tv_nsec);
+        }
+#else
+        SCN_UNUSED(filename);
+#endif
+        return s;
+    }
+
+    SCN_FUNC void line_index::_init() noexcept
+    {
+        using access = detail::line_index_access;
+
+        if (m_map.valid()) {
+            m_data = static_cast<const unsigned char*>(
+                static_cast<const void*>(m_map.begin()));
+            m_size = static_cast<std::size_t>(m_map.end() - m_map.begin());
+        }
+        else if (!m_buffer.empty()) {
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+        }
+        else {
+            _reset();
+            return;
+        }
+
+        m_stamp.size = access::read<uint64_t>(m_data + 16);
+        m_stamp.mtime = access::read<int64_t>(m_data + 24);
+        m_lines = access::read<uint64_t>(m_data + 32);
+        const auto blocks = access::read<uint64_t>(m_data + 40);
+        m_blocks = m_data + access::header_size;
+        m_deltas = m_blocks + blocks * access::block_entry_size;
+    }
+
+    SCN_FUNC std::size_t line_index::offset(std::size_t i) const noexcept
+    {
+        using access = detail::line_index_access;
+
+        SCN_EXPECT(i < size());
+        const auto block =
+            m_blocks + (i / access::block_lines) * access::block_entry_size;
+        const auto base = access::read<uint64_t>(block);
+        const auto pos = access::read<uint64_t>(block + 8);
+        const auto width = access::read<uint64_t>(block + 16);
+        const auto delta = access::read_delta(
+            m_deltas + pos + (i % access::block_lines) * width, width);
+        // base is in the source (see validate), a delta may not be
+        if (delta > m_stamp.size - base) {
+            return static_cast<std::size_t>(m_stamp.size);
+        }
+        return static_cast<std::size_t>(base + delta);
+    }
+
+    SCN_FUNC line_index make_line_index(string_view source,
+                                        unsigned threads,
+                                        source_stamp stamp)
+    {
+        using access = detail::line_index_access;
+
+        if (stamp.size == 0) {
+            stamp.size = source.size();
+        }
+        std::vector<uint64_t> offsets;
+        if (source.size() != 0) {
+            offsets = access::find_offsets(source, threads);
+        }
+
+        line_index index;
+        access::set_buffer(index, access::encode(offsets, stamp));
+        return index;
+    }
+
+    SCN_FUNC error save_line_index(const line_index& index,
+                                   const char* filename)
+    {
+        if (!index.valid()) {
+            return error(error::invalid_argument, "Invalid line_index");
+        }
+
+        return detail::replace_file(filename, index.data(),
+                                    index.size_in_bytes());
+    }
+
+    SCN_FUNC line_index load_line_index(const char* filename)
+    {
+        using access = detail::line_index_access;
+
+        detail::byte_mapped_file map{filename};
+        if (!map.valid() ||
+            !access::validate(static_cast<const unsigned char*>(
+                                  static_cast<const void*>(map.begin())),
+                              static_cast<std::size_t>(map.end() -
+                                                       map.begin()))) {
+            return {};
+        }
+
+        line_index index;
+        access::set_map(index, std::move(map));
+        return index;
+    }
+
+    SCN_FUNC std::string indexed_file::sidecar_path(const char* filename)
+    {
+        return std::string{filename} + ".lidx";
+    }
+
+    SCN_FUNC indexed_file::indexed_file(const char* filename,
+                                        line_index_options options)
+        : m_file(filename)
+    {
+        if (!m_file.valid()) {
+            return;
+        }
+
+        const auto stamp = get_source_stamp(filename);
+        const auto sidecar = sidecar_path(filename);
+        m_index = load_line_index(sidecar.c_str());
+        if (m_index.valid() && m_index.stamp().size == stamp.size &&
+            m_index.stamp().mtime == stamp.mtime) {
+            return;
+        }
+
+        m_index = make_line_index(m_file.make_view(), options.threads, stamp);
+        if (options.save) {
+            save_line_index(m_index, sidecar.c_str());
+        }
+    }
+
+    SCN_FUNC string_view indexed_file::line(std::size_t i) const noexcept
+    {
+        SCN_EXPECT(i < size());
+        const auto source = m_file.make_view();
+        // The file may have changed after it was stamped
+        const auto b = detail::min(m_index.offset(i), source.size());
+        auto e = i + 1 < size() ? m_index.offset(i + 1) : source.size();
+        e = detail::max(detail::min(e, source.size()), b);
+        if (e != b && source[e - 1] == '\n') {
+            --e;
+        }
+        return {source.data() + b, e - b};
+    }
+
+    SCN_END_NAMESPACE
+}  // namespace scn
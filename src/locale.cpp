@@ -126,13 +126,31 @@ namespace scn {
                          "Localized number read failed");
         }
 
+        // Read-only stream buffer over a string_view, so that the characters
+        // don't need to be copied into a stringstream
+        template <typename CharT>
+        class string_view_streambuf : public std::basic_streambuf<CharT> {
+        public:
+            string_view_streambuf(basic_string_view<CharT> s)
+            {
+                auto p = const_cast<CharT*>(s.data());
+                this->setg(p, p, p + s.size());
+            }
+
+            std::ptrdiff_t position() const
+            {
+                return this->gptr() - this->eback();
+            }
+        };
+
         template <typename T, typename CharT>
         expected<std::ptrdiff_t> read_num(T& val,
                                           const std::locale& loc,
-                                          const std::basic_string<CharT>& buf)
+                                          basic_string_view<CharT> buf)
         {
 #if SCN_HAS_EXCEPTIONS
-            std::basic_istringstream<CharT> ss(buf);
+            string_view_streambuf<CharT> sb(buf);
+            std::basic_istream<CharT> ss(&sb);
             ss.imbue(loc);
 
             try {
@@ -151,7 +169,7 @@ namespace scn {
                 return error(error::invalid_scanned_value, f.what());
             }
             return ss.eof() ? static_cast<std::ptrdiff_t>(buf.size())
-                            : static_cast<std::ptrdiff_t>(ss.tellg());
+                            : sb.position();
 #else
             SCN_UNUSED(val);
             SCN_UNUSED(loc);
@@ -167,7 +185,7 @@ namespace scn {
     template <typename T>
     expected<std::ptrdiff_t> basic_locale_ref<CharT>::read_num(
         T& val,
-        const string_type& buf)
+        string_view_type buf)
     {
         return detail::read_num<T, CharT>(val, detail::get_locale(*this), buf);
     }
@@ -180,67 +198,67 @@ namespace scn {
 
     template expected<std::ptrdiff_t> basic_locale_ref<char>::read_num<short>(
         short&,
-        const string_type&);
+        string_view_type);
     template expected<std::ptrdiff_t> basic_locale_ref<char>::read_num<int>(
         int&,
-        const string_type&);
+        string_view_type);
     template expected<std::ptrdiff_t> basic_locale_ref<char>::read_num<long>(
         long&,
-        const string_type&);
+        string_view_type);
     template expected<std::ptrdiff_t>
-    basic_locale_ref<char>::read_num<long long>(long long&, const string_type&);
+    basic_locale_ref<char>::read_num<long long>(long long&, string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<char>::read_num<unsigned short>(unsigned short&,
-                                                     const string_type&);
+                                                     string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<char>::read_num<unsigned int>(unsigned int&,
-                                                   const string_type&);
+                                                   string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<char>::read_num<unsigned long>(unsigned long&,
-                                                    const string_type&);
+                                                    string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<char>::read_num<unsigned long long>(unsigned long long&,
-                                                         const string_type&);
+                                                         string_view_type);
     template expected<std::ptrdiff_t> basic_locale_ref<char>::read_num<float>(
         float&,
-        const string_type&);
+        string_view_type);
     template expected<std::ptrdiff_t> basic_locale_ref<char>::read_num<double>(
         double&,
-        const string_type&);
+        string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<char>::read_num<long double>(long double&,
-                                                  const string_type&);
+                                                  string_view_type);
 
     template expected<std::ptrdiff_t>
-    basic_locale_ref<wchar_t>::read_num<short>(short&, const string_type&);
+    basic_locale_ref<wchar_t>::read_num<short>(short&, string_view_type);
     template expected<std::ptrdiff_t> basic_locale_ref<wchar_t>::read_num<int>(
         int&,
-        const string_type&);
+        string_view_type);
     template expected<std::ptrdiff_t> basic_locale_ref<wchar_t>::read_num<long>(
         long&,
-        const string_type&);
+        string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<wchar_t>::read_num<long long>(long long&,
-                                                   const string_type&);
+                                                   string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<wchar_t>::read_num<unsigned short>(unsigned short&,
-                                                        const string_type&);
+                                                        string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<wchar_t>::read_num<unsigned int>(unsigned int&,
-                                                      const string_type&);
+                                                      string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<wchar_t>::read_num<unsigned long>(unsigned long&,
-                                                       const string_type&);
+                                                       string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<wchar_t>::read_num<unsigned long long>(unsigned long long&,
-                                                            const string_type&);
+                                                            string_view_type);
     template expected<std::ptrdiff_t>
-    basic_locale_ref<wchar_t>::read_num<float>(float&, const string_type&);
+    basic_locale_ref<wchar_t>::read_num<float>(float&, string_view_type);
     template expected<std::ptrdiff_t>
-    basic_locale_ref<wchar_t>::read_num<double>(double&, const string_type&);
+    basic_locale_ref<wchar_t>::read_num<double>(double&, string_view_type);
     template expected<std::ptrdiff_t>
     basic_locale_ref<wchar_t>::read_num<long double>(long double&,
-                                                     const string_type&);
+                                                     string_view_type);
 
     SCN_END_NAMESPACE
 }  // namespace scn
@@ -0,0 +1,968 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#if defined(SCN_HEADER_ONLY) && SCN_HEADER_ONLY
+#define SCN_SIMD_CPP
+#endif
+
+#include <scn/detail/simd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#if SCN_HAS_X86_SIMD
+#include <immintrin.h>
+#if !SCN_MSVC
+#include <cpuid.h>
+#endif
+#endif
+
+#if SCN_HAS_NEON
+#include <arm_neon.h>
+#if SCN_ARM32 && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#endif
+
+namespace scn {
+    SCN_BEGIN_NAMESPACE
+
+    namespace detail {
+        struct scalar_kernels {
+            static bool is_space(char ch) noexcept
+            {
+                return ch == ' ' || (ch >= '\t' && ch <= '\r');
+            }
+
+            static const char* find_char(const char* begin,
+                                         const char* end,
+                                         char ch) noexcept
+            {
+                if (begin == end) {
+                    return end;
+                }
+                auto p = std::memchr(begin, static_cast<unsigned char>(ch),
+                                     static_cast<size_t>(end - begin));
+                return p ? static_cast<const char*>(p) : end;
+            }
+            static const char* find_non_space(const char* begin,
+                                              const char* end) noexcept
+            {
+                for (; begin != end; ++begin) {
+                    if (!is_space(*begin)) {
+                        return begin;
+                    }
+                }
+                return end;
+            }
+            static const char* find_non_digit(const char* begin,
+                                              const char* end) noexcept
+            {
+                for (; begin != end; ++begin) {
+                    if (*begin < '0' || *begin > '9') {
+                        return begin;
+                    }
+                }
+                return end;
+            }
+
+            static std::size_t count_char(const char* begin,
+                                          const char* end,
+                                          char ch) noexcept
+            {
+                std::size_t n = 0;
+                for (; begin != end; ++begin) {
+                    n += *begin == ch ? 1 : 0;
+                }
+                return n;
+            }
+
+            static const char* find_not_in_set(const char* begin,
+                                               const char* end,
+                                               const byte_set& set) noexcept
+            {
+                for (; begin != end; ++begin) {
+                    if (!set.contains(static_cast<unsigned char>(*begin))) {
+                        return begin;
+                    }
+                }
+                return end;
+            }
+
+            // Mask of the bits of the first `n` characters of a block
+            static uint64_t block_mask(std::ptrdiff_t n) noexcept
+            {
+                return n >= 64 ? ~uint64_t{0}
+                               : (uint64_t{1} << static_cast<unsigned>(n)) -
+                                     1;
+            }
+            // Returns a pointer to 64 readable characters, beginning with
+            // the ones of `[begin, end)`: `begin` itself, or `buf`
+            static const char* pad_block(const char* begin,
+                                         const char* end,
+                                         char (&buf)[64]) noexcept
+            {
+                if (end - begin >= 64) {
+                    return begin;
+                }
+                std::memset(buf, 0, sizeof(buf));
+                std::memcpy(buf, begin, static_cast<size_t>(end - begin));
+                return buf;
+            }
+
+            static void match_masks(const char* begin,
+                                    const char* end,
+                                    const char* chars,
+                                    uint64_t* masks) noexcept
+            {
+                masks[0] = masks[1] = masks[2] = 0;
+                const auto n = end - begin >= 64 ? 64 : end - begin;
+                for (std::ptrdiff_t i = 0; i < n; ++i) {
+                    const auto bit = uint64_t{1} << static_cast<unsigned>(i);
+                    for (int j = 0; j < 3; ++j) {
+                        if (begin[i] == chars[j]) {
+                            masks[j] |= bit;
+                        }
+                    }
+                }
+            }
+        };
+
+#if SCN_HAS_X86_SIMD
+        struct x86_cpuid {
+            static void cpuid(uint32_t leaf,
+                              uint32_t subleaf,
+                              uint32_t* regs) noexcept
+            {
+#if SCN_MSVC
+                int tmp[4]{};
+                __cpuidex(tmp, static_cast<int>(leaf),
+                          static_cast<int>(subleaf));
+                for (int i = 0; i < 4; ++i) {
+                    regs[i] = static_cast<uint32_t>(tmp[i]);
+                }
+#else
+                __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2],
+                              regs[3]);
+#endif
+            }
+
+            static uint64_t xgetbv() noexcept
+            {
+#if SCN_MSVC
+                return _xgetbv(0);
+#else
+                uint32_t eax{}, edx{};
+                __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+                return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+            }
+
+            static cpu_features detect() noexcept
+            {
+                cpu_features f{};
+                uint32_t regs[4]{};
+
+                cpuid(0, 0, regs);
+                const auto max_leaf = regs[0];
+                if (max_leaf < 1) {
+                    return f;
+                }
+
+                cpuid(1, 0, regs);
+                const auto ecx1 = regs[2];
+                // count_char uses popcnt alongside SSE4.2, require both
+                f.sse42 = ((ecx1 >> 20) & 1) != 0 && ((ecx1 >> 23) & 1) != 0;
+
+                const bool osxsave = ((ecx1 >> 27) & 1) != 0;
+                const bool avx = ((ecx1 >> 28) & 1) != 0;
+                if (!osxsave || !avx || max_leaf < 7) {
+                    return f;
+                }
+
+                // The OS has to save the state of the wider registers
+                const auto xcr0 = xgetbv();
+                const bool ymm_state = (xcr0 & 0x6) == 0x6;
+                const bool zmm_state = (xcr0 & 0xe6) == 0xe6;
+
+                cpuid(7, 0, regs);
+                const auto ebx7 = regs[1];
+                f.avx2 = ymm_state && ((ebx7 >> 5) & 1) != 0;
+                f.avx512bw = zmm_state && ((ebx7 >> 16) & 1) != 0 &&
+                             ((ebx7 >> 30) & 1) != 0;
+                return f;
+            }
+        };
+
+        template <typename T>
+        const T* simd_ptr(const void* p) noexcept
+        {
+            return static_cast<const T*>(p);
+        }
+
+        // popcnt instruction, only for the kernels of the levels that
+        // require it (detail::popcount is for everything else)
+        SCN_SIMD_TARGET("popcnt")
+        inline int hw_popcount(uint64_t v) noexcept
+        {
+#if defined(__x86_64__) || defined(_M_X64)
+            return static_cast<int>(_mm_popcnt_u64(v));
+#else
+            return _mm_popcnt_u32(static_cast<unsigned>(v)) +
+                   _mm_popcnt_u32(static_cast<unsigned>(v >> 32));
+#endif
+        }
+
+        struct sse42_kernels {
+            SCN_SIMD_TARGET("sse4.2")
+            static const char* find_char(const char* begin,
+                                         const char* end,
+                                         char ch) noexcept
+            {
+                const auto needle = _mm_set1_epi8(ch);
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = _mm_loadu_si128(simd_ptr<__m128i>(begin));
+                    const auto mask = static_cast<uint32_t>(
+                        _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                }
+                return scalar_kernels::find_char(begin, end, ch);
+            }
+
+            SCN_SIMD_TARGET("sse4.2,popcnt")
+            static std::size_t count_char(const char* begin,
+                                          const char* end,
+                                          char ch) noexcept
+            {
+                const auto needle = _mm_set1_epi8(ch);
+                std::size_t n = 0;
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = _mm_loadu_si128(simd_ptr<__m128i>(begin));
+                    const auto mask = static_cast<uint32_t>(
+                        _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)));
+                    n += static_cast<std::size_t>(hw_popcount(mask));
+                }
+                return n + scalar_kernels::count_char(begin, end, ch);
+            }
+
+            SCN_SIMD_TARGET("sse4.2")
+            static const char* find_non_space(const char* begin,
+                                              const char* end) noexcept
+            {
+                const auto space = _mm_set1_epi8(' ');
+                const auto tab = _mm_set1_epi8('\t');
+                const auto four = _mm_set1_epi8(4);
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = _mm_loadu_si128(simd_ptr<__m128i>(begin));
+                    // '\t' <= ch <= '\r' <=> (unsigned)(ch - '\t') <= 4
+                    const auto t = _mm_sub_epi8(v, tab);
+                    const auto ws =
+                        _mm_or_si128(_mm_cmpeq_epi8(v, space),
+                                     _mm_cmpeq_epi8(_mm_min_epu8(t, four), t));
+                    const auto mask =
+                        ~static_cast<uint32_t>(_mm_movemask_epi8(ws)) &
+                        0xffffu;
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                }
+                return scalar_kernels::find_non_space(begin, end);
+            }
+
+            SCN_SIMD_TARGET("sse4.2")
+            static const char* find_non_digit(const char* begin,
+                                              const char* end) noexcept
+            {
+                const auto zero = _mm_set1_epi8('0');
+                const auto nine = _mm_set1_epi8(9);
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = _mm_loadu_si128(simd_ptr<__m128i>(begin));
+                    const auto t = _mm_sub_epi8(v, zero);
+                    const auto digit = _mm_cmpeq_epi8(_mm_min_epu8(t, nine), t);
+                    const auto mask =
+                        ~static_cast<uint32_t>(_mm_movemask_epi8(digit)) &
+                        0xffffu;
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                }
+                return scalar_kernels::find_non_digit(begin, end);
+            }
+
+            SCN_SIMD_TARGET("sse4.2")
+            static const char* find_not_in_set(const char* begin,
+                                               const char* end,
+                                               const byte_set& set) noexcept
+            {
+                // The table entry is selected by the low nibble, and the
+                // half of the table (and then, the bit) by the high one
+                const auto lo_table =
+                    _mm_loadu_si128(simd_ptr<__m128i>(set.bits));
+                const auto hi_table = _mm_loadu_si128(
+                    simd_ptr<__m128i>(set.bits + 16));
+                const auto bit_table = _mm_setr_epi8(
+                    1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+                const auto nibble = _mm_set1_epi8(0x0f);
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = _mm_loadu_si128(simd_ptr<__m128i>(begin));
+                    const auto lo = _mm_and_si128(v, nibble);
+                    const auto hi =
+                        _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+                    // blendv picks by the top bit of v, i.e. hi >= 8
+                    const auto row =
+                        _mm_blendv_epi8(_mm_shuffle_epi8(lo_table, lo),
+                                        _mm_shuffle_epi8(hi_table, lo), v);
+                    const auto bit = _mm_shuffle_epi8(bit_table, hi);
+                    const auto in_set =
+                        _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+                    const auto mask =
+                        ~static_cast<uint32_t>(_mm_movemask_epi8(in_set)) &
+                        0xffffu;
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                }
+                return scalar_kernels::find_not_in_set(begin, end, set);
+            }
+
+            SCN_SIMD_TARGET("sse4.2")
+            static void match_masks(const char* begin,
+                                    const char* end,
+                                    const char* chars,
+                                    uint64_t* masks) noexcept
+            {
+                char buf[64];
+                const auto tail = scalar_kernels::block_mask(end - begin);
+                const auto p = scalar_kernels::pad_block(begin, end, buf);
+                __m128i v[4];
+                for (int i = 0; i < 4; ++i) {
+                    v[i] = _mm_loadu_si128(simd_ptr<__m128i>(p + i * 16));
+                }
+                for (int j = 0; j < 3; ++j) {
+                    const auto needle = _mm_set1_epi8(chars[j]);
+                    uint64_t mask = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        mask |= uint64_t{static_cast<uint32_t>(
+                                    _mm_movemask_epi8(
+                                        _mm_cmpeq_epi8(v[i], needle)))}
+                                << (i * 16);
+                    }
+                    masks[j] = mask & tail;
+                }
+            }
+        };
+
+        struct avx2_kernels {
+            SCN_SIMD_TARGET("avx2")
+            static const char* find_char(const char* begin,
+                                         const char* end,
+                                         char ch) noexcept
+            {
+                const auto needle = _mm256_set1_epi8(ch);
+                for (; end - begin >= 32; begin += 32) {
+                    const auto v =
+                        _mm256_loadu_si256(simd_ptr<__m256i>(begin));
+                    const auto mask = static_cast<uint32_t>(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                }
+                return sse42_kernels::find_char(begin, end, ch);
+            }
+
+            SCN_SIMD_TARGET("avx2,popcnt")
+            static std::size_t count_char(const char* begin,
+                                          const char* end,
+                                          char ch) noexcept
+            {
+                const auto needle = _mm256_set1_epi8(ch);
+                std::size_t n = 0;
+                for (; end - begin >= 32; begin += 32) {
+                    const auto v =
+                        _mm256_loadu_si256(simd_ptr<__m256i>(begin));
+                    const auto mask = static_cast<uint32_t>(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+                    n += static_cast<std::size_t>(hw_popcount(mask));
+                }
+                return n + sse42_kernels::count_char(begin, end, ch);
+            }
+
+            SCN_SIMD_TARGET("avx2")
+            static const char* find_non_space(const char* begin,
+                                              const char* end) noexcept
+            {
+                const auto space = _mm256_set1_epi8(' ');
+                const auto tab = _mm256_set1_epi8('\t');
+                const auto four = _mm256_set1_epi8(4);
+                for (; end - begin >= 32; begin += 32) {
+                    const auto v =
+                        _mm256_loadu_si256(simd_ptr<__m256i>(begin));
+                    const auto t = _mm256_sub_epi8(v, tab);
+                    const auto ws = _mm256_or_si256(
+                        _mm256_cmpeq_epi8(v, space),
+                        _mm256_cmpeq_epi8(_mm256_min_epu8(t, four), t));
+                    const auto mask =
+                        ~static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                }
+                return sse42_kernels::find_non_space(begin, end);
+            }
+
+            SCN_SIMD_TARGET("avx2")
+            static const char* find_non_digit(const char* begin,
+                                              const char* end) noexcept
+            {
+                const auto zero = _mm256_set1_epi8('0');
+                const auto nine = _mm256_set1_epi8(9);
+                for (; end - begin >= 32; begin += 32) {
+                    const auto v =
+                        _mm256_loadu_si256(simd_ptr<__m256i>(begin));
+                    const auto t = _mm256_sub_epi8(v, zero);
+                    const auto digit =
+                        _mm256_cmpeq_epi8(_mm256_min_epu8(t, nine), t);
+                    const auto mask =
+                        ~static_cast<uint32_t>(_mm256_movemask_epi8(digit));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                }
+                return sse42_kernels::find_non_digit(begin, end);
+            }
+
+            SCN_SIMD_TARGET("avx2")
+            static const char* find_not_in_set(const char* begin,
+                                               const char* end,
+                                               const byte_set& set) noexcept
+            {
+                const auto lo_table = _mm256_broadcastsi128_si256(
+                    _mm_loadu_si128(simd_ptr<__m128i>(set.bits)));
+                const auto hi_table = _mm256_broadcastsi128_si256(
+                    _mm_loadu_si128(simd_ptr<__m128i>(set.bits + 16)));
+                const auto bit_table = _mm256_setr_epi8(
+                    1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                    1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+                const auto nibble = _mm256_set1_epi8(0x0f);
+                for (; end - begin >= 32; begin += 32) {
+                    const auto v =
+                        _mm256_loadu_si256(simd_ptr<__m256i>(begin));
+                    const auto lo = _mm256_and_si256(v, nibble);
+                    const auto hi =
+                        _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+                    const auto row = _mm256_blendv_epi8(
+                        _mm256_shuffle_epi8(lo_table, lo),
+                        _mm256_shuffle_epi8(hi_table, lo), v);
+                    const auto bit = _mm256_shuffle_epi8(bit_table, hi);
+                    const auto in_set =
+                        _mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit);
+                    const auto mask =
+                        ~static_cast<uint32_t>(_mm256_movemask_epi8(in_set));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                }
+                return sse42_kernels::find_not_in_set(begin, end, set);
+            }
+
+            SCN_SIMD_TARGET("avx2")
+            static void match_masks(const char* begin,
+                                    const char* end,
+                                    const char* chars,
+                                    uint64_t* masks) noexcept
+            {
+                char buf[64];
+                const auto tail = scalar_kernels::block_mask(end - begin);
+                const auto p = scalar_kernels::pad_block(begin, end, buf);
+                const auto lo = _mm256_loadu_si256(simd_ptr<__m256i>(p));
+                const auto hi = _mm256_loadu_si256(simd_ptr<__m256i>(p + 32));
+                for (int j = 0; j < 3; ++j) {
+                    const auto needle = _mm256_set1_epi8(chars[j]);
+                    const auto mask_lo = static_cast<uint32_t>(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+                    const auto mask_hi = static_cast<uint32_t>(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+                    masks[j] = ((uint64_t{mask_hi} << 32) | mask_lo) & tail;
+                }
+            }
+        };
+
+        struct avx512bw_kernels {
+            // Mask of the first `n` lanes, used for reading the tail of the
+            // input with a masked (non-faulting) load
+            static __mmask64 tail_mask(std::ptrdiff_t n) noexcept
+            {
+                return n >= 64 ? ~__mmask64{0}
+                               : (__mmask64{1} << static_cast<unsigned>(n)) -
+                                     1;
+            }
+
+            SCN_SIMD_TARGET("avx512f,avx512bw")
+            static const char* find_char(const char* begin,
+                                         const char* end,
+                                         char ch) noexcept
+            {
+                const auto needle = _mm512_set1_epi8(ch);
+                while (begin != end) {
+                    const auto k = tail_mask(end - begin);
+                    const auto v = _mm512_maskz_loadu_epi8(k, begin);
+                    const auto mask = static_cast<uint64_t>(
+                        _mm512_mask_cmpeq_epi8_mask(k, v, needle));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                    begin += (end - begin) >= 64 ? 64 : (end - begin);
+                }
+                return end;
+            }
+
+            SCN_SIMD_TARGET("avx512f,avx512bw,popcnt")
+            static std::size_t count_char(const char* begin,
+                                          const char* end,
+                                          char ch) noexcept
+            {
+                const auto needle = _mm512_set1_epi8(ch);
+                std::size_t n = 0;
+                while (begin != end) {
+                    const auto k = tail_mask(end - begin);
+                    const auto v = _mm512_maskz_loadu_epi8(k, begin);
+                    const auto mask = static_cast<uint64_t>(
+                        _mm512_mask_cmpeq_epi8_mask(k, v, needle));
+                    n += static_cast<std::size_t>(hw_popcount(mask));
+                    begin += (end - begin) >= 64 ? 64 : (end - begin);
+                }
+                return n;
+            }
+
+            SCN_SIMD_TARGET("avx512f,avx512bw")
+            static const char* find_non_space(const char* begin,
+                                              const char* end) noexcept
+            {
+                const auto space = _mm512_set1_epi8(' ');
+                const auto tab = _mm512_set1_epi8('\t');
+                const auto four = _mm512_set1_epi8(4);
+                while (begin != end) {
+                    const auto k = tail_mask(end - begin);
+                    const auto v = _mm512_maskz_loadu_epi8(k, begin);
+                    const auto ws =
+                        _mm512_cmpeq_epi8_mask(v, space) |
+                        _mm512_cmple_epu8_mask(_mm512_sub_epi8(v, tab), four);
+                    const auto mask = static_cast<uint64_t>(~ws & k);
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                    begin += (end - begin) >= 64 ? 64 : (end - begin);
+                }
+                return end;
+            }
+
+            SCN_SIMD_TARGET("avx512f,avx512bw")
+            static const char* find_non_digit(const char* begin,
+                                              const char* end) noexcept
+            {
+                const auto zero = _mm512_set1_epi8('0');
+                const auto nine = _mm512_set1_epi8(9);
+                while (begin != end) {
+                    const auto k = tail_mask(end - begin);
+                    const auto v = _mm512_maskz_loadu_epi8(k, begin);
+                    const auto digit =
+                        _mm512_cmple_epu8_mask(_mm512_sub_epi8(v, zero), nine);
+                    const auto mask = static_cast<uint64_t>(~digit & k);
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                    begin += (end - begin) >= 64 ? 64 : (end - begin);
+                }
+                return end;
+            }
+
+            SCN_SIMD_TARGET("avx512f,avx512bw")
+            static const char* find_not_in_set(const char* begin,
+                                               const char* end,
+                                               const byte_set& set) noexcept
+            {
+                const auto lo_table = _mm512_broadcast_i32x4(
+                    _mm_loadu_si128(simd_ptr<__m128i>(set.bits)));
+                const auto hi_table = _mm512_broadcast_i32x4(
+                    _mm_loadu_si128(simd_ptr<__m128i>(set.bits + 16)));
+                const auto bit_table = _mm512_set1_epi64(
+                    static_cast<long long>(UINT64_C(0x8040201008040201)));
+                const auto nibble = _mm512_set1_epi8(0x0f);
+                while (begin != end) {
+                    const auto k = tail_mask(end - begin);
+                    const auto v = _mm512_maskz_loadu_epi8(k, begin);
+                    const auto lo = _mm512_and_si512(v, nibble);
+                    const auto hi =
+                        _mm512_and_si512(_mm512_srli_epi16(v, 4), nibble);
+                    const auto row = _mm512_mask_blend_epi8(
+                        _mm512_movepi8_mask(v),
+                        _mm512_shuffle_epi8(lo_table, lo),
+                        _mm512_shuffle_epi8(hi_table, lo));
+                    const auto bit = _mm512_shuffle_epi8(bit_table, hi);
+                    const auto in_set = _mm512_test_epi8_mask(row, bit);
+                    const auto mask = static_cast<uint64_t>(~in_set & k);
+                    if (mask != 0) {
+                        return begin + countr_zero(mask);
+                    }
+                    begin += (end - begin) >= 64 ? 64 : (end - begin);
+                }
+                return end;
+            }
+
+            SCN_SIMD_TARGET("avx512f,avx512bw")
+            static void match_masks(const char* begin,
+                                    const char* end,
+                                    const char* chars,
+                                    uint64_t* masks) noexcept
+            {
+                const auto k = tail_mask(end - begin);
+                const auto v = _mm512_maskz_loadu_epi8(k, begin);
+                for (int j = 0; j < 3; ++j) {
+                    const auto needle = _mm512_set1_epi8(chars[j]);
+                    masks[j] = static_cast<uint64_t>(
+                        _mm512_mask_cmpeq_epi8_mask(k, v, needle));
+                }
+            }
+        };
+#endif  // SCN_HAS_X86_SIMD
+
+#if SCN_HAS_NEON
+        struct neon_kernels {
+            // Narrows a comparison result into a 64-bit mask,
+            // with four bits per lane
+            static uint64_t to_mask(uint8x16_t cmp) noexcept
+            {
+                const auto narrowed =
+                    vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+                return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+            }
+            static const uint8_t* ptr(const char* p) noexcept
+            {
+                return static_cast<const uint8_t*>(
+                    static_cast<const void*>(p));
+            }
+
+            static const char* find_char(const char* begin,
+                                         const char* end,
+                                         char ch) noexcept
+            {
+                const auto needle = vdupq_n_u8(static_cast<uint8_t>(ch));
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = vld1q_u8(ptr(begin));
+                    const auto mask = to_mask(vceqq_u8(v, needle));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask) / 4;
+                    }
+                }
+                return scalar_kernels::find_char(begin, end, ch);
+            }
+
+            static std::size_t count_char(const char* begin,
+                                          const char* end,
+                                          char ch) noexcept
+            {
+                const auto needle = vdupq_n_u8(static_cast<uint8_t>(ch));
+                std::size_t n = 0;
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = vld1q_u8(ptr(begin));
+                    n += static_cast<std::size_t>(
+                        popcount(to_mask(vceqq_u8(v, needle))) / 4);
+                }
+                return n + scalar_kernels::count_char(begin, end, ch);
+            }
+
+            static const char* find_non_space(const char* begin,
+                                              const char* end) noexcept
+            {
+                const auto space = vdupq_n_u8(' ');
+                const auto tab = vdupq_n_u8('\t');
+                const auto four = vdupq_n_u8(4);
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = vld1q_u8(ptr(begin));
+                    const auto ws =
+                        vorrq_u8(vceqq_u8(v, space),
+                                 vcleq_u8(vsubq_u8(v, tab), four));
+                    const auto mask = to_mask(vmvnq_u8(ws));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask) / 4;
+                    }
+                }
+                return scalar_kernels::find_non_space(begin, end);
+            }
+
+            static const char* find_non_digit(const char* begin,
+                                              const char* end) noexcept
+            {
+                const auto zero = vdupq_n_u8('0');
+                const auto nine = vdupq_n_u8(9);
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = vld1q_u8(ptr(begin));
+                    const auto digit = vcleq_u8(vsubq_u8(v, zero), nine);
+                    const auto mask = to_mask(vmvnq_u8(digit));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask) / 4;
+                    }
+                }
+                return scalar_kernels::find_non_digit(begin, end);
+            }
+
+            static const char* find_not_in_set(const char* begin,
+                                               const char* end,
+                                               const byte_set& set) noexcept
+            {
+#if SCN_ARM64
+                const auto lo_table = vld1q_u8(set.bits);
+                const auto hi_table = vld1q_u8(set.bits + 16);
+                const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                          1, 2, 4, 8, 16, 32, 64, 128};
+                const auto bit_table = vld1q_u8(bits);
+                const auto nibble = vdupq_n_u8(0x0f);
+                const auto high = vdupq_n_u8(0x80);
+                for (; end - begin >= 16; begin += 16) {
+                    const auto v = vld1q_u8(ptr(begin));
+                    const auto lo = vandq_u8(v, nibble);
+                    const auto row = vbslq_u8(vcgeq_u8(v, high),
+                                              vqtbl1q_u8(hi_table, lo),
+                                              vqtbl1q_u8(lo_table, lo));
+                    const auto bit = vqtbl1q_u8(bit_table, vshrq_n_u8(v, 4));
+                    const auto mask = to_mask(vceqq_u8(
+                        vtstq_u8(row, bit), vdupq_n_u8(0)));
+                    if (mask != 0) {
+                        return begin + countr_zero(mask) / 4;
+                    }
+                }
+#endif
+                // 32-bit ARM has no 16-byte table lookup
+                return scalar_kernels::find_not_in_set(begin, end, set);
+            }
+
+            static void match_masks(const char* begin,
+                                    const char* end,
+                                    const char* chars,
+                                    uint64_t* masks) noexcept
+            {
+#if SCN_ARM64
+                char buf[64];
+                const auto tail = scalar_kernels::block_mask(end - begin);
+                const auto p = scalar_kernels::pad_block(begin, end, buf);
+                const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                          1, 2, 4, 8, 16, 32, 64, 128};
+                const auto weights = vld1q_u8(bits);
+                uint8x16_t v[4];
+                for (int i = 0; i < 4; ++i) {
+                    v[i] = vld1q_u8(ptr(p + i * 16));
+                }
+                for (int j = 0; j < 3; ++j) {
+                    const auto needle =
+                        vdupq_n_u8(static_cast<uint8_t>(chars[j]));
+                    uint8x16_t m[4];
+                    for (int i = 0; i < 4; ++i) {
+                        m[i] = vandq_u8(vceqq_u8(v[i], needle), weights);
+                    }
+                    // Pairwise sums of the weighted lanes gather a bit per
+                    // lane into the bytes of the mask
+                    auto sum = vpaddq_u8(vpaddq_u8(m[0], m[1]),
+                                         vpaddq_u8(m[2], m[3]));
+                    sum = vpaddq_u8(sum, sum);
+                    masks[j] =
+                        vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0) & tail;
+                }
+#else
+                // 32-bit ARM has no pairwise addition of full vectors
+                scalar_kernels::match_masks(begin, end, chars, masks);
+#endif
+            }
+
+            static bool detect() noexcept
+            {
+#if SCN_ARM64
+                // Advanced SIMD is mandatory on AArch64
+                return true;
+#elif defined(__linux__)
+                // HWCAP_NEON
+                return (getauxval(AT_HWCAP) & (1 << 12)) != 0;
+#else
+                // Compiled with NEON enabled, assume it's there
+                return true;
+#endif
+            }
+        };
+#endif  // SCN_HAS_NEON
+
+        struct simd_levels {
+            static bool supports(cpu_features f, simd_level l) noexcept
+            {
+                switch (l) {
+                    case simd_level::sse42:
+                        return f.sse42;
+                    case simd_level::avx2:
+                        return f.avx2;
+                    case simd_level::avx512bw:
+                        return f.avx512bw;
+                    case simd_level::neon:
+                        return f.neon;
+                    case simd_level::scalar:
+                        SCN_CLANG_PUSH
+                        SCN_CLANG_IGNORE("-Wcovered-switch-default")
+                    default:
+                        return true;
+                        SCN_CLANG_POP
+                }
+            }
+        };
+
+        template <typename Kernels>
+        constexpr simd_kernels make_simd_kernels(simd_level l) noexcept
+        {
+            return {l,
+                    &Kernels::find_char,
+                    &Kernels::find_non_space,
+                    &Kernels::find_non_digit,
+                    &Kernels::find_not_in_set,
+                    &Kernels::count_char,
+                    &Kernels::match_masks};
+        }
+
+        SCN_FUNC simd_level select_simd_level(cpu_features f,
+                                              const char* override_name) noexcept
+        {
+            if (override_name != nullptr) {
+                const simd_level levels[] = {
+                    simd_level::scalar, simd_level::sse42, simd_level::avx2,
+                    simd_level::avx512bw, simd_level::neon};
+                for (auto l : levels) {
+                    if (std::strcmp(override_name, simd_level_name(l)) == 0 &&
+                        simd_levels::supports(f, l)) {
+                        return l;
+                    }
+                }
+            }
+
+            if (f.avx512bw) {
+                return simd_level::avx512bw;
+            }
+            if (f.avx2) {
+                return simd_level::avx2;
+            }
+            if (f.sse42) {
+                return simd_level::sse42;
+            }
+            if (f.neon) {
+                return simd_level::neon;
+            }
+            return simd_level::scalar;
+        }
+
+        SCN_FUNC const simd_kernels& get_simd_kernels_for(
+            simd_level l) noexcept
+        {
+            static constexpr simd_kernels scalar =
+                make_simd_kernels<scalar_kernels>(simd_level::scalar);
+#if SCN_HAS_X86_SIMD
+            static constexpr simd_kernels sse42 =
+                make_simd_kernels<sse42_kernels>(simd_level::sse42);
+            static constexpr simd_kernels avx2 =
+                make_simd_kernels<avx2_kernels>(simd_level::avx2);
+            static constexpr simd_kernels avx512bw =
+                make_simd_kernels<avx512bw_kernels>(simd_level::avx512bw);
+#endif
+#if SCN_HAS_NEON
+            static constexpr simd_kernels neon =
+                make_simd_kernels<neon_kernels>(simd_level::neon);
+#endif
+
+            SCN_EXPECT(is_simd_level_supported(l));
+#if SCN_HAS_X86_SIMD
+            if (l == simd_level::avx512bw) {
+                return avx512bw;
+            }
+            if (l == simd_level::avx2) {
+                return avx2;
+            }
+            if (l == simd_level::sse42) {
+                return sse42;
+            }
+#endif
+#if SCN_HAS_NEON
+            if (l == simd_level::neon) {
+                return neon;
+            }
+#endif
+            SCN_UNUSED(l);
+            return scalar;
+        }
+
+        SCN_FUNC const simd_kernels& get_simd_kernels() noexcept
+        {
+            SCN_MSVC_PUSH
+            SCN_MSVC_IGNORE(4996)  // getenv may be unsafe
+            static const simd_kernels& kernels = get_simd_kernels_for(
+                select_simd_level(detect_cpu_features(), std::getenv("SCN_SIMD")));
+            SCN_MSVC_POP
+            return kernels;
+        }
+    }  // namespace detail
+
+    SCN_FUNC cpu_features detect_cpu_features() noexcept
+    {
+#if SCN_HAS_X86_SIMD
+        return detail::x86_cpuid::detect();
+#elif SCN_HAS_NEON
+        cpu_features f{};
+        f.neon = detail::neon_kernels::detect();
+        return f;
+#else
+        return {};
+#endif
+    }
+
+    SCN_FUNC bool is_simd_level_supported(simd_level l) noexcept
+    {
+        return detail::simd_levels::supports(detect_cpu_features(), l);
+    }
+
+    SCN_FUNC simd_level get_simd_level() noexcept
+    {
+        return detail::get_simd_kernels().level;
+    }
+
+    SCN_FUNC const char* simd_level_name(simd_level l) noexcept
+    {
+        switch (l) {
+            case simd_level::scalar:
+                return "scalar";
+            case simd_level::sse42:
+                return "sse4.2";
+            case simd_level::avx2:
+                return "avx2";
+            case simd_level::avx512bw:
+                return "avx512bw";
+            case simd_level::neon:
+                return "neon";
+                SCN_CLANG_PUSH
+                SCN_CLANG_IGNORE("-Wcovered-switch-default")
+            default:
+                return "unknown";
+                SCN_CLANG_POP
+        }
+    }
+
+    SCN_END_NAMESPACE
+}  // namespace scn
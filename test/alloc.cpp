@@ -0,0 +1,280 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Every allocation made by the program is counted,
+// so that scanning can be checked to not allocate
+static std::size_t allocation_count = 0;
+
+void* operator new(std::size_t n)
+{
+    ++allocation_count;
+    if (auto p = std::malloc(n == 0 ? 1 : n)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+void* operator new[](std::size_t n)
+{
+    return operator new(n);
+}
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// Number of allocations made while calling f
+template <typename F>
+static std::size_t allocations(F&& f)
+{
+    const auto before = allocation_count;
+    f();
+    return allocation_count - before;
+}
+
+TEST_CASE("builtin types")
+{
+    int i{};
+    long long ll{};
+    unsigned u{};
+    double d{};
+    float f{};
+    bool b{};
+    char c{};
+
+    CHECK(allocations([&]() {
+              auto ret = scn::scan("42 -123456789012 4000000000",
+                                   "{} {} {}", i, ll, u);
+              CHECK(ret);
+          }) == 0);
+    CHECK(i == 42);
+    CHECK(ll == -123456789012);
+    CHECK(u == 4000000000);
+
+    CHECK(allocations([&]() {
+              auto ret = scn::scan("3.14 -1e10", "{} {}", d, f);
+              CHECK(ret);
+          }) == 0);
+    CHECK(d == doctest::Approx(3.14));
+    CHECK(f == doctest::Approx(-1e10f));
+
+    CHECK(allocations([&]() {
+              auto ret = scn::scan("true 0 x", "{:a} {:n} {}", b, i, c);
+              CHECK(ret);
+          }) == 0);
+    CHECK(b);
+    CHECK(i == 0);
+    CHECK(c == 'x');
+
+    CHECK(allocations([&]() {
+              auto ret = scn::scan("1 2.5", scn::default_tag, i, d);
+              CHECK(ret);
+          }) == 0);
+    CHECK(i == 1);
+    CHECK(d == doctest::Approx(2.5));
+
+    CHECK(allocations([&]() {
+              auto ret = scn::scan_static("7 false", "{} {}", i, b);
+              CHECK(ret);
+          }) == 0);
+    CHECK(i == 7);
+    CHECK(!b);
+
+    CHECK(allocations([&]() {
+              auto ret = scn::scan_value<int>("123");
+              CHECK(ret);
+              CHECK(ret.value() == 123);
+          }) == 0);
+}
+
+TEST_CASE("views")
+{
+    char buf[4]{};
+    auto s = scn::make_span(buf, 4).as_const();
+    scn::string_view sv{};
+    scn::string_view line{};
+    CHECK(allocations([&]() {
+              auto span = scn::make_span(buf, 4);
+              auto ret = scn::scan("abcd word", "{}", span);
+              CHECK(ret);
+              ret = scn::scan(ret.range(), "{}", sv);
+              CHECK(ret);
+          }) == 0);
+    CHECK(std::string{s.data(), s.size()} == "abcd");
+    CHECK(std::string{sv.data(), sv.size()} == "word");
+
+    CHECK(allocations([&]() {
+              auto ret = scn::getline("first\nsecond", line);
+              CHECK(ret);
+          }) == 0);
+    CHECK(std::string{line.data(), line.size()} == "first");
+}
+
+TEST_CASE("file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    // leading whitespace to grow the cache of the file on the first scan
+    std::fputs(std::string(64, ' ').c_str(), f);
+    std::fputs("123 456 789 1.5 2.5 true\nfirst line\nsecond line\n", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        int i{};
+        // the file caches what it has read, allocated on the first scan
+        auto ret = scn::scan(file, "{}", i);
+        CHECK(ret);
+        CHECK(i == 123);
+        // syncing clears the cache of the file, keeping its capacity
+        CHECK(file.sync());
+
+        CHECK(allocations([&]() {
+                  ret = scn::scan(file, "{}", i);
+                  CHECK(ret);
+              }) == 0);
+        CHECK(i == 456);
+        CHECK(allocations([&]() {
+                  ret = scn::scan(file, "{}", i);
+                  CHECK(ret);
+              }) == 0);
+        CHECK(i == 789);
+
+        double d{};
+        CHECK(allocations([&]() {
+                  ret = scn::scan(file, "{}", d);
+                  CHECK(ret);
+                  ret = scn::scan(file, "{}", d);
+                  CHECK(ret);
+              }) == 0);
+        CHECK(d == doctest::Approx(2.5));
+
+        bool b{};
+        CHECK(allocations([&]() {
+                  ret = scn::scan(file, "{:a}", b);
+                  CHECK(ret);
+              }) == 0);
+        CHECK(b);
+
+        std::string s;
+        s.reserve(64);
+        // rest of the first line
+        auto e = scn::getline(file, s);
+        CHECK(e);
+        CHECK(s.empty());
+        CHECK(allocations([&]() {
+                  auto r = scn::getline(file, s);
+                  CHECK(r);
+                  r = scn::getline(file, s);
+                  CHECK(r);
+              }) == 0);
+        CHECK(s == "second line");
+    }
+    std::fclose(f);
+}
+
+TEST_CASE("std::string")
+{
+    // longer than the small string buffer of a std::string
+    const scn::string_view words =
+        "the-first-word-is-alpha the-second-word-is-beta "
+        "the-third-word-is-gamma the-fourth-word-is-delta "
+        "the-fifth-word-is-epsilon the-sixth-word-is-zeta";
+    const std::size_t longest = std::strlen("the-fifth-word-is-epsilon");
+
+    // Room for the longest word, but not for two words at once
+    std::string s;
+    s.reserve(longest);
+    REQUIRE(s.capacity() < 2 * longest);
+
+    SUBCASE("view")
+    {
+        CHECK(allocations([&]() {
+                  auto ret = scn::scan(words, "{}", s);
+                  CHECK(ret);
+                  for (int i = 0; i < 5; ++i) {
+                      ret = scn::scan(ret.range(), "{}", s);
+                      CHECK(ret);
+                  }
+              }) == 0);
+        CHECK(s == "the-sixth-word-is-zeta");
+    }
+    SUBCASE("file")
+    {
+        auto f = std::tmpfile();
+        REQUIRE(f);
+        // leading whitespace to grow the cache of the file on the first scan
+        std::fputs(std::string(256, ' ').c_str(), f);
+        std::fputs(words.data(), f);
+        std::rewind(f);
+
+        {
+            scn::file file{f};
+            // warm-up: the file allocates its cache
+            std::string first;
+            auto ret = scn::scan(file, "{}", first);
+            CHECK(ret);
+            CHECK(first == "the-first-word-is-alpha");
+            // syncing clears the cache of the file, keeping its capacity
+            CHECK(file.sync());
+
+            CHECK(allocations([&]() {
+                      for (int i = 0; i < 5; ++i) {
+                          ret = scn::scan(file, "{}", s);
+                          CHECK(ret);
+                      }
+                  }) == 0);
+            CHECK(s == "the-sixth-word-is-zeta");
+
+            // failure at the end of the file
+            ret = scn::scan(file, "{}", s);
+            CHECK(!ret);
+            CHECK(s == "the-sixth-word-is-zeta");
+        }
+        std::fclose(f);
+    }
+    SUBCASE("failure")
+    {
+        s = "unchanged";
+        auto ret = scn::scan("   ", "{}", s);
+        CHECK(!ret);
+        CHECK(s == "unchanged");
+
+        ret = scn::scan("", "{}", s);
+        CHECK(!ret);
+        CHECK(s == "unchanged");
+    }
+}
@@ -0,0 +1,118 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/arena.h>
+
+#include <cstdio>
+
+TEST_CASE("monotonic_arena")
+{
+    alignas(8) unsigned char buf[64];
+    scn::monotonic_arena arena{buf, sizeof(buf)};
+
+    auto a = arena.allocate(10, 1);
+    auto b = arena.allocate(8, 8);
+    CHECK(a == buf);
+    CHECK(static_cast<unsigned char*>(b) == buf + 16);
+    CHECK(arena.chunk_bytes() == 0);
+
+    // doesn't fit into buf anymore
+    auto c = arena.allocate_array<double>(8);
+    CHECK(arena.chunk_bytes() != 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(c) % alignof(double) == 0);
+
+    // larger than a chunk
+    auto d = static_cast<unsigned char*>(arena.allocate(10000, 1));
+    std::fill(d, d + 10000, 0);
+    CHECK(arena.chunk_bytes() >= 10000);
+
+    arena.release();
+    CHECK(arena.chunk_bytes() == 0);
+    CHECK(arena.allocate(1, 1) == buf);
+}
+
+TEST_CASE("monotonic_arena alignment past the end of the buffer")
+{
+    alignas(8) unsigned char storage[16];
+
+    // 3 bytes at an odd address: aligning to 8 goes past the end
+    unsigned char* buf = storage + 1;
+    scn::monotonic_arena arena{buf, 3};
+    auto p = static_cast<unsigned char*>(arena.allocate(1, 8));
+    CHECK((p < buf || p >= buf + 3));
+    CHECK(reinterpret_cast<std::uintptr_t>(p) % 8 == 0);
+    CHECK(arena.chunk_bytes() != 0);
+
+    // strings, then an int array near the end of the buffer
+    scn::monotonic_arena arena2{buf, 14};
+    auto s = static_cast<unsigned char*>(arena2.allocate(5, 1));
+    CHECK(s == buf);
+    auto ints = arena2.allocate_array<int>(2);
+    const auto i = reinterpret_cast<unsigned char*>(ints);
+    CHECK((i + 2 * sizeof(int) <= buf + 14 || i >= buf + 14 || i < buf));
+    CHECK(reinterpret_cast<std::uintptr_t>(ints) % alignof(int) == 0);
+    ints[0] = 1;
+    ints[1] = 2;
+    auto more = arena2.allocate_array<int>(1);
+    const auto m = reinterpret_cast<unsigned char*>(more);
+    CHECK((m + sizeof(int) <= buf + 14 || m >= buf + 14 || m < buf));
+    *more = 3;
+    CHECK(ints[0] == 1);
+    CHECK(ints[1] == 2);
+}
+
+TEST_CASE_TEMPLATE("arena_string_view", CharT, char, wchar_t)
+{
+    scn::monotonic_arena arena{};
+    scn::basic_arena_string_view<CharT> a{arena}, b{arena};
+
+    auto e = do_scan<CharT>("first second", "{} {}", a, b);
+    CHECK(e);
+    CHECK(std::basic_string<CharT>{a.data(), a.size()} ==
+          widen<CharT>("first"));
+    CHECK(std::basic_string<CharT>{b.data(), b.size()} ==
+          widen<CharT>("second"));
+    CHECK(&b.arena() == &arena);
+}
+
+TEST_CASE("arena_string_view from file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("alpha beta\ngamma", f);
+    std::rewind(f);
+
+    scn::monotonic_arena arena{};
+    std::vector<scn::string_view> words;
+    {
+        scn::file file{f};
+        scn::arena_string_view s{arena};
+        while (scn::scan(file, "{}", s)) {
+            words.push_back(s.view());
+        }
+    }
+    std::fclose(f);
+
+    // the strings live in the arena, not in s
+    REQUIRE(words.size() == 3);
+    CHECK(std::string{words[0].data(), words[0].size()} == "alpha");
+    CHECK(std::string{words[1].data(), words[1].size()} == "beta");
+    CHECK(std::string{words[2].data(), words[2].size()} == "gamma");
+}
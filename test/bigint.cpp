@@ -0,0 +1,140 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/bigint.h>
+
+#include <cstdio>
+#include <string>
+
+using limbs = std::vector<uint64_t>;
+
+static scn::big_uint scan_big(const std::string& str, const char* f = "{}")
+{
+    scn::big_uint v;
+    auto ret = scn::scan(scn::make_view(str), f, v);
+    REQUIRE(ret);
+    return v;
+}
+
+TEST_CASE("big_uint")
+{
+    CHECK(scan_big("0").is_zero());
+    CHECK(scan_big("0000").is_zero());
+    CHECK(scan_big("42").limbs() == limbs{42});
+    CHECK(scan_big("+18446744073709551616").limbs() == limbs{0, 1});
+    CHECK(scan_big("340282366920938463463374607431768211455").limbs() ==
+          limbs{UINT64_MAX, UINT64_MAX});
+    CHECK(scan_big("0x1ffffffffffffffffffffffffffffffff").limbs() ==
+          limbs{UINT64_MAX, UINT64_MAX, 1});
+    CHECK(scan_big("0X00000000000000000000ABCDEF", "{:x}").limbs() ==
+          limbs{0xabcdef});
+    CHECK(scan_big("ffffffffffffffff0000000000000000", "{:x}").limbs() ==
+          limbs{0, UINT64_MAX});
+    CHECK(scan_big("0755").limbs() == limbs{0755});
+    CHECK(scan_big("1777777777777777777777", "{:o}").limbs() ==
+          limbs{UINT64_MAX});
+    CHECK(scan_big("2000000000000000000000", "{:o}").limbs() ==
+          limbs{0, 1});
+    CHECK(scan_big("1010", "{:b2}").limbs() == limbs{10});
+    CHECK(scan_big("zz", "{:b36}").limbs() == limbs{1295});
+    CHECK(scan_big("1", "{:d}").bit_width() == 1);
+
+    scn::big_uint a, b;
+    auto ret = scn::scan("123 0x 456", "{} {} {}", a, b, b);
+    REQUIRE(!ret);
+    ret = scn::scan("123 0xg", "{} {}", a, b);
+    REQUIRE(ret);
+    CHECK(b.is_zero());
+    CHECK(ret.range().size() == 2);
+
+    ret = scn::scan("-1", "{}", a);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("xyz", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("1", "{:n}", a);
+    CHECK(ret.error() == scn::error::invalid_format_string);
+    ret = scn::scan("1", "{:b1}", a);
+    CHECK(ret.error() == scn::error::invalid_format_string);
+    CHECK(a.limbs() == limbs{123});
+}
+
+TEST_CASE("big_uint long")
+{
+    // 2^2203 - 1, in decimal and in hexadecimal
+    const std::string mersenne =
+    "1475979915214180235084898622737381736312066145333169775147771216478570"
+    "2978780789493774073370493892893827485075314964804772812648387602591918"
+    "1446336533026954049696120111343015690239609398909022625932693502528140"
+    "9614983499388222831448598601834318536230923772641390209490231836446899"
+    "6082107954829637630942366309454108327937699053999824571863229447296364"
+    "1889062337217172374210563644036821845964963294853869690587265048691443"
+    "4637457507280441823676813517852099348660847172579408422316678097670224"
+    "0119902801704748944874269247421088235368084850725022405194525875428753"
+    "4997655857267022963396257521263747789778550155264652260998886991401354"
+    "0483809865681250419497686697771007";
+    const auto dec = scan_big(mersenne);
+    const auto hex = scan_big("0x7" + std::string(550, 'f'));
+    CHECK(dec.bit_width() == 2203);
+    CHECK(dec == hex);
+    CHECK(dec.limbs().back() == 0x7ffffff);
+
+    // 10^5000 - 1 and 10^5000, with Karatsuba multiplication
+    const auto nines = scan_big(std::string(5000, '9'));
+    const auto power = scan_big("1" + std::string(5000, '0'));
+    CHECK(nines + scn::big_uint{1} == power);
+    CHECK(nines < power);
+    CHECK(power.bit_width() == 16610);
+    CHECK(power.limbs()[0] == 0);
+}
+
+TEST_CASE("big_uint multiplication")
+{
+    // (B^n - 1) * (B^m - 1) + (B^n - 1) + (B^m - 1) == B^(n + m) - 1
+    for (std::size_t n : {1u, 31u, 40u, 100u, 257u}) {
+        for (std::size_t m : {1u, 32u, 70u, 129u}) {
+            const auto x = scn::big_uint::from_limbs(limbs(n, UINT64_MAX));
+            const auto y = scn::big_uint::from_limbs(limbs(m, UINT64_MAX));
+            CHECK(((x * y) + x + y).limbs() == limbs(n + m, UINT64_MAX));
+        }
+    }
+    CHECK((scn::big_uint{} * scn::big_uint{5}).is_zero());
+}
+
+TEST_CASE("big_uint wide and file")
+{
+    scn::big_uint a, b;
+    auto wret = scn::scan(L"18446744073709551617 0xff", L"{} {}", a, b);
+    REQUIRE(wret);
+    CHECK(a.limbs() == limbs{1, 1});
+    CHECK(b.limbs() == limbs{255});
+
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("36893488147419103232,0x10000000000000000\n", f);
+    std::rewind(f);
+    {
+        scn::file file{f};
+        auto e = scn::scan(file, "{},{}", a, b);
+        REQUIRE(e);
+        CHECK(a.limbs() == limbs{0, 2});
+        CHECK(b.limbs() == limbs{0, 1});
+    }
+    std::fclose(f);
+}
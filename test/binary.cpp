@@ -0,0 +1,204 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/binary.h>
+
+#include <array>
+#include <cstdio>
+#include <string>
+
+using bytes4 = std::array<unsigned char, 4>;
+using bytes16 = std::array<unsigned char, 16>;
+
+static std::string to_string(scn::span<unsigned char> s)
+{
+    return std::string(s.begin(), s.end());
+}
+
+TEST_CASE("hex")
+{
+    bytes4 a{}, b{};
+    auto ret = scn::scan("deadBEEF 00ff10a0", "{} {:x}", a, b);
+    REQUIRE(ret);
+    CHECK(a == bytes4{{0xde, 0xad, 0xbe, 0xef}});
+    CHECK(b == bytes4{{0x00, 0xff, 0x10, 0xa0}});
+    CHECK(ret.range().size() == 0);
+
+    // longer than 8 digits, and not a multiple of 8
+    unsigned char buf[16];
+    auto s = scn::make_span(buf, 16);
+    ret = scn::scan("0123456789abcdef0123456789!", "{}", s);
+    REQUIRE(ret);
+    REQUIRE(s.size() == 13);
+    CHECK(s[0] == 0x01);
+    CHECK(s[7] == 0xef);
+    CHECK(s[12] == 0x89);
+    CHECK(ret.range().size() == 1);
+
+    a = bytes4{};
+    ret = scn::scan("deadbee", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("deadbe", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("deadbeef00", "{}", a);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("xyz", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    CHECK(a == bytes4{});
+
+    s = scn::make_span(buf, 2);
+    ret = scn::scan("0102030405060708", "{}", s);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    CHECK(s.size() == 2);
+
+    ret = scn::scan("deadbeef", "{:y}", a);
+    CHECK(ret.error() == scn::error::invalid_format_string);
+}
+
+TEST_CASE("base64")
+{
+    unsigned char buf[64];
+    auto s = scn::make_span(buf, 64);
+    auto ret = scn::scan("SGVsbG8sIFdvcmxkIQ==", "{:b64}", s);
+    REQUIRE(ret);
+    CHECK(to_string(s) == "Hello, World!");
+    CHECK(ret.range().size() == 0);
+
+    const char* encoded[] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==",
+                             "Zm9vYmE=", "Zm9vYmFy"};
+    const std::string decoded = "foobar";
+    for (std::size_t i = 1; i < 7; ++i) {
+        s = scn::make_span(buf, 64);
+        auto r = scn::scan(scn::string_view{encoded[i]}, "{:b64}", s);
+        REQUIRE(r);
+        CHECK(to_string(s) == decoded.substr(0, i));
+    }
+
+    // decoded 8 characters at a time, and with the 62 and 63 characters
+    s = scn::make_span(buf, 64);
+    ret = scn::scan("AAECAwQFBgcICQoLDA0OD/v/vw== rest", "{:b64}", s);
+    REQUIRE(ret);
+    REQUIRE(s.size() == 19);
+    for (unsigned char i = 0; i < 16; ++i) {
+        CHECK(s[i] == i);
+    }
+    CHECK(s[16] == 0xfb);
+    CHECK(s[17] == 0xff);
+    CHECK(s[18] == 0xbf);
+    CHECK(ret.range().size() == 5);
+
+    // padding required
+    ret = scn::scan("Zm9vYg", "{:b64}", s);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("Zm9vYg=", "{:b64}", s);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    // a lone character, and bits after the last byte
+    ret = scn::scan("Zm9vY", "{:b64}", s);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("Zm9=", "{:b64}", s);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    // not the url-safe alphabet
+    ret = scn::scan("-_8=", "{:b64}", s);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+
+    std::array<unsigned char, 3> a{};
+    ret = scn::scan("Zm9vYmFy", "{:b64}", a);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("Zm8=", "{:b64}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("Zm9v", "{:b64}", a);
+    REQUIRE(ret);
+    CHECK(std::string(a.begin(), a.end()) == "foo");
+}
+
+TEST_CASE("base64url")
+{
+    unsigned char buf[16];
+    auto s = scn::make_span(buf, 16);
+    auto ret = scn::scan("-_8", "{:b64url}", s);
+    REQUIRE(ret);
+    REQUIRE(s.size() == 2);
+    CHECK(s[0] == 0xfb);
+    CHECK(s[1] == 0xff);
+
+    s = scn::make_span(buf, 16);
+    ret = scn::scan("-_8= +/8=", "{:b64url} {:b64}", s, s);
+    REQUIRE(ret);
+    REQUIRE(s.size() == 2);
+    CHECK(s[0] == 0xfb);
+
+    // a partial padding
+    s = scn::make_span(buf, 16);
+    ret = scn::scan("Zg=", "{:b64url}", s);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("uuid")
+{
+    bytes16 u{};
+    auto ret = scn::scan("123e4567-E89B-12d3-a456-426614174000}", "{:uuid}", u);
+    REQUIRE(ret);
+    CHECK(u == bytes16{{0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3, 0xa4,
+                        0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00}});
+    CHECK(ret.range().size() == 1);
+
+    unsigned char buf[32];
+    auto s = scn::make_span(buf, 32);
+    ret = scn::scan("00000000-0000-0000-0000-000000000001", "{:uuid}", s);
+    REQUIRE(ret);
+    REQUIRE(s.size() == 16);
+    CHECK(s[15] == 1);
+
+    ret = scn::scan("123e4567e89b12d3a456426614174000", "{:uuid}", u);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("123e4567-e89b-12d3-a456-42661417400", "{:uuid}", u);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("123e4567-e89b-12d3-a456-42661417400g", "{:uuid}", u);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+
+    std::array<unsigned char, 8> small{};
+    ret = scn::scan("123e4567-e89b-12d3-a456-426614174000", "{:uuid}", small);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+}
+
+TEST_CASE("binary wide and file")
+{
+    bytes4 a{};
+    auto wret = scn::scan(L"Zm9vYg== cafe0001", L"{:b64} {}", a, a);
+    REQUIRE(wret);
+    CHECK(a == bytes4{{0xca, 0xfe, 0x00, 0x01}});
+    auto wret2 = scn::scan(L"Zm9vYmE=", L"{:b64}", a);
+    CHECK(wret2.error() == scn::error::value_out_of_range);
+
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("c0ffee00 123e4567-e89b-12d3-a456-426614174000\n", f);
+    std::rewind(f);
+    {
+        scn::file file{f};
+        bytes16 u{};
+        auto e = scn::scan(file, "{} {:uuid}", a, u);
+        REQUIRE(e);
+        CHECK(a == bytes4{{0xc0, 0xff, 0xee, 0x00}});
+        CHECK(u[0] == 0x12);
+        CHECK(u[15] == 0x00);
+    }
+    std::fclose(f);
+}
@@ -18,6 +18,8 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "test.h"
 
+#include <cstdio>
+
 TEST_CASE("buffer")
 {
     std::string data{"data moredata"};
@@ -28,3 +30,26 @@ TEST_CASE("buffer")
     CHECK(ret);
     CHECK(data.substr(0, 4) == s);
 }
+
+TEST_CASE("buffer from file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("abcdef ghi", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        std::string s(4, '\0');
+        auto span = scn::make_span(s);
+        auto ret = scn::scan(file, "{}", span);
+        CHECK(ret);
+        CHECK(s == "abcd");
+
+        std::string rest{};
+        ret = scn::scan(file, "{}", rest);
+        CHECK(ret);
+        CHECK(rest == "ef");
+    }
+    std::fclose(f);
+}
@@ -0,0 +1,259 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/chrono.h>
+
+#include <cstdio>
+
+using sys_seconds = std::chrono::time_point<std::chrono::system_clock,
+                                            std::chrono::seconds>;
+using sys_nanoseconds =
+    std::chrono::time_point<std::chrono::system_clock,
+                            std::chrono::nanoseconds>;
+
+template <typename Result>
+static std::string rest(const Result& ret)
+{
+    return {ret.range().data(), ret.range().size()};
+}
+
+static int64_t seconds_since_epoch(sys_seconds tp)
+{
+    return static_cast<int64_t>(tp.time_since_epoch().count());
+}
+
+TEST_CASE("days_from_civil")
+{
+    CHECK(scn::days_from_civil(1970, 1, 1) == 0);
+    CHECK(scn::days_from_civil(2000, 3, 1) == 11017);
+    CHECK(scn::days_from_civil(1969, 12, 31) == -1);
+    CHECK(scn::days_from_civil(2024, 2, 29) == 19782);
+    CHECK(scn::days_from_civil(1600, 1, 1) == -135140);
+
+    // round trip
+    for (int64_t d = -800000; d < 800000; d += 997) {
+        scn::date_time dt{};
+        scn::detail::civil::from_days(d, dt);
+        CHECK(scn::days_from_civil(dt.year, static_cast<unsigned>(dt.month),
+                                   static_cast<unsigned>(dt.day)) == d);
+    }
+}
+
+TEST_CASE("iso 8601 date_time")
+{
+    scn::date_time dt{};
+    auto ret = scn::scan("2024-03-01T12:30:15.123456789Z rest", "{}", dt);
+    REQUIRE(ret);
+    CHECK(rest(ret) == " rest");
+    CHECK(dt.year == 2024);
+    CHECK(dt.month == 3);
+    CHECK(dt.day == 1);
+    CHECK(dt.hour == 12);
+    CHECK(dt.minute == 30);
+    CHECK(dt.second == 15);
+    CHECK(dt.nanosecond == 123456789);
+    CHECK(dt.has_utc_offset);
+    CHECK(dt.utc_offset == 0);
+
+    ret = scn::scan("2024-03-01 12:30:15,5+05:30", "{}", dt);
+    REQUIRE(ret);
+    CHECK(dt.second == 15);
+    CHECK(dt.nanosecond == 500000000);
+    CHECK(dt.utc_offset == 5 * 3600 + 30 * 60);
+
+    ret = scn::scan("1999-12-31t23:59-0800", "{}", dt);
+    REQUIRE(ret);
+    CHECK(dt.minute == 59);
+    CHECK(dt.second == 0);
+    CHECK(dt.utc_offset == -8 * 3600);
+
+    // a date, followed by something other than a time
+    ret = scn::scan("2024-03-01 foo", "{}", dt);
+    REQUIRE(ret);
+    CHECK(rest(ret) == " foo");
+    CHECK(dt.day == 1);
+    CHECK(dt.hour == 0);
+    CHECK(!dt.has_utc_offset);
+
+    ret = scn::scan("2023-02-29", "{}", dt);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("2024-03-01T24:00:00", "{}", dt);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("2024-3-01", "{}", dt);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("2024-03-01T1:00", "{}", dt);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("iso 8601 time_point")
+{
+    sys_seconds tp{};
+    auto ret = scn::scan("1970-01-01T00:00:00Z", "{}", tp);
+    REQUIRE(ret);
+    CHECK(seconds_since_epoch(tp) == 0);
+
+    ret = scn::scan("2001-09-09T01:46:40Z", "{}", tp);
+    REQUIRE(ret);
+    CHECK(seconds_since_epoch(tp) == 1000000000);
+
+    ret = scn::scan("2001-09-09T03:46:40+02:00", "{}", tp);
+    REQUIRE(ret);
+    CHECK(seconds_since_epoch(tp) == 1000000000);
+
+    // rounded down
+    ret = scn::scan("1969-12-31T23:59:59.5Z", "{}", tp);
+    REQUIRE(ret);
+    CHECK(seconds_since_epoch(tp) == -1);
+
+    sys_nanoseconds ns{};
+    ret = scn::scan("2024-03-01T12:30:15.000000042Z", "{}", ns);
+    REQUIRE(ret);
+    CHECK(ns.time_since_epoch().count() % 1000000000 == 42);
+
+    ret = scn::scan("2300-01-01T00:00:00Z", "{}", ns);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+
+    std::chrono::system_clock::time_point sys{};
+    ret = scn::scan("2024-03-01", "{}", sys);
+    REQUIRE(ret);
+    CHECK(std::chrono::duration_cast<std::chrono::hours>(
+              sys.time_since_epoch())
+              .count() == scn::days_from_civil(2024, 3, 1) * 24);
+}
+
+TEST_CASE("date_time pattern")
+{
+    scn::date_time dt{};
+    auto ret = scn::scan("[10/Oct/2000:13:55:36 -0700] GET",
+                         "[{:%d/%b/%Y:%H:%M:%S %z}]", dt);
+    REQUIRE(ret);
+    CHECK(rest(ret) == " GET");
+    CHECK(dt.year == 2000);
+    CHECK(dt.month == 10);
+    CHECK(dt.day == 10);
+    CHECK(dt.hour == 13);
+    CHECK(dt.second == 36);
+    CHECK(dt.utc_offset == -7 * 3600);
+
+    ret = scn::scan("Mon January  2 15:04:05 06", "{:%a %B %e %T %y}", dt);
+    REQUIRE(ret);
+    CHECK(dt.year == 2006);
+    CHECK(dt.month == 1);
+    CHECK(dt.day == 2);
+    CHECK(dt.minute == 4);
+
+    ret = scn::scan("2024-03-01 12:00:00.250", "{:%F %T.%f}", dt);
+    REQUIRE(ret);
+    CHECK(dt.nanosecond == 250000000);
+
+    sys_seconds tp{};
+    ret = scn::scan("@1000000000", "@{:%s}", tp);
+    REQUIRE(ret);
+    CHECK(seconds_since_epoch(tp) == 1000000000);
+    ret = scn::scan("-1", "{:%s}", dt);
+    REQUIRE(ret);
+    CHECK(dt.year == 1969);
+    CHECK(dt.second == 59);
+
+    ret = scn::scan("2024/03/01", "{:%Y-%m-%d}", dt);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("2024", "{:%Q}", dt);
+    CHECK(ret.error() == scn::error::invalid_format_string);
+}
+
+TEST_CASE("duration")
+{
+    std::chrono::milliseconds ms{};
+    auto ret = scn::scan("1500", "{}", ms);
+    REQUIRE(ret);
+    CHECK(ms.count() == 1500);
+
+    ret = scn::scan("1.5s", "{}", ms);
+    REQUIRE(ret);
+    CHECK(ms.count() == 1500);
+
+    ret = scn::scan("1h30m15s rest", "{}", ms);
+    REQUIRE(ret);
+    CHECK(rest(ret) == " rest");
+    CHECK(ms.count() == (3600 + 1800 + 15) * 1000);
+
+    ret = scn::scan("-01:30:15.5", "{}", ms);
+    REQUIRE(ret);
+    CHECK(ms.count() == -(5415 * 1000 + 500));
+
+    ret = scn::scan("250us", "{}", ms);
+    REQUIRE(ret);
+    CHECK(ms.count() == 0);
+
+    ret = scn::scan("2min", "{}", ms);
+    REQUIRE(ret);
+    CHECK(ms.count() == 120000);
+
+    std::chrono::duration<double> secs{};
+    ret = scn::scan("2.25", "{}", secs);
+    REQUIRE(ret);
+    CHECK(secs.count() == doctest::Approx(2.25));
+
+    std::chrono::duration<signed char> small{};
+    ret = scn::scan("200", "{}", small);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+
+    std::chrono::hours h{};
+    ret = scn::scan("99999999999999d", "{}", h);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("x", "{}", h);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("chrono non-contiguous and wide")
+{
+    scn::date_time dt{};
+    std::chrono::seconds s{};
+    auto src = std::string{"2024-03-01T12:30:15Z 90s\nnext"};
+    auto ret = scn::scan(scn::make_view(src), "{} {}", dt, s);
+    REQUIRE(ret);
+    CHECK(dt.minute == 30);
+    CHECK(s.count() == 90);
+
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("2024-03-01 12:30:15+01:00 2h\n13:00", f);
+    std::rewind(f);
+    {
+        scn::file file{f};
+        sys_seconds tp{};
+        std::chrono::minutes m{};
+        auto e = scn::scan(file, "{} {}", tp, m);
+        REQUIRE(e);
+        CHECK(seconds_since_epoch(tp) % 86400 == 11 * 3600 + 30 * 60 + 15);
+        CHECK(m.count() == 120);
+        e = scn::scan(file, "{:%R}", dt);
+        REQUIRE(e);
+        CHECK(dt.hour == 13);
+    }
+    std::fclose(f);
+
+    auto wret = scn::scan(L"2024-03-01T12:30:15.25Z", L"{}", dt);
+    REQUIRE(wret);
+    CHECK(dt.nanosecond == 250000000);
+    wret = scn::scan(L"01/Mar/2024", L"{:%d/%b/%Y}", dt);
+    REQUIRE(wret);
+    CHECK(dt.month == 3);
+}
@@ -0,0 +1,216 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/columns.h>
+
+#include <cstdio>
+
+TEST_CASE("scan_columns")
+{
+    const auto path = scratch_file("columns-source.txt");
+    const char* name = path.c_str();
+    {
+        auto f = std::fopen(name, "w");
+        REQUIRE(f);
+        for (int i = 0; i < 1000; ++i) {
+            std::fprintf(f, "%d %d.5\n", i, -i);
+        }
+        std::fputs("\n", f);
+        std::fclose(f);
+    }
+    const auto cache = std::string{name} + ".scncol";
+
+    auto check = [](const scn::columns<int, double>& cols) {
+        REQUIRE(cols.valid());
+        REQUIRE(cols.size() == 1000);
+        auto ints = cols.column<0>();
+        auto doubles = cols.column<1>();
+        REQUIRE(ints.size() == 1000);
+        REQUIRE(doubles.size() == 1000);
+        CHECK(ints[0] == 0);
+        CHECK(ints[999] == 999);
+        CHECK(doubles[0] == doctest::Approx(0.5));
+        CHECK(doubles[999] == doctest::Approx(-999.5));
+    };
+
+    {
+        auto cols = scn::scan_columns<int, double>(name, "{} {}");
+        CHECK(!cols.from_cache());
+        check(cols);
+    }
+    {
+        auto cols = scn::scan_columns<int, double>(name, "{} {}");
+        CHECK(cols.from_cache());
+        check(cols);
+    }
+    {
+        // different types: not from the cache
+        auto cols = scn::scan_columns<long, double>(name, "{} {}");
+        CHECK(!cols.from_cache());
+        REQUIRE(cols.valid());
+        CHECK(cols.column<0>()[10] == 10);
+    }
+    {
+        auto cols = scn::scan_columns<int>(name, "{} {}");
+        CHECK(!cols.valid());
+        CHECK(cols.error().code() == scn::error::invalid_format_string);
+    }
+
+    std::remove(cache.c_str());
+    std::remove(name);
+}
+
+TEST_CASE("scan_columns error")
+{
+    const auto path = scratch_file("columns-error.txt");
+    const char* name = path.c_str();
+    {
+        auto f = std::fopen(name, "w");
+        REQUIRE(f);
+        std::fputs("1\nfoo\n", f);
+        std::fclose(f);
+    }
+
+    scn::column_cache_options opt;
+    opt.save = false;
+    auto cols = scn::scan_columns<int>(name, "{}", opt);
+    CHECK(!cols.valid());
+    CHECK(cols.error().code() == scn::error::invalid_scanned_value);
+
+    std::remove(name);
+}
+
+TEST_CASE("scan_columns bool")
+{
+    const auto path = scratch_file("columns-bool.txt");
+    const char* name = path.c_str();
+    {
+        auto f = std::fopen(name, "w");
+        REQUIRE(f);
+        std::fputs("1 true\n2 false\n3 true\n", f);
+        std::fclose(f);
+    }
+    const auto cache = path + ".scncol";
+
+    for (int i = 0; i < 2; ++i) {
+        auto cols = scn::scan_columns<int, bool>(name, "{} {}");
+        REQUIRE(cols.valid());
+        CHECK(cols.from_cache() == (i == 1));
+        REQUIRE(cols.size() == 3);
+        auto b = cols.column<1>();
+        CHECK(b[0]);
+        CHECK(!b[1]);
+        CHECK(b[2]);
+        CHECK(cols.column<0>()[2] == 3);
+    }
+
+    std::remove(cache.c_str());
+    std::remove(name);
+}
+
+TEST_CASE("scan_columns empty file")
+{
+    const auto path = scratch_file("columns-empty.txt");
+    const char* name = path.c_str();
+    {
+        auto f = std::fopen(name, "w");
+        REQUIRE(f);
+        std::fclose(f);
+    }
+    const auto cache = path + ".scncol";
+
+    for (int i = 0; i < 2; ++i) {
+        auto cols = scn::scan_columns<int, double>(name, "{} {}");
+        REQUIRE(cols.valid());
+        CHECK(cols.from_cache() == (i == 1));
+        CHECK(cols.size() == 0);
+        CHECK(cols.column<0>().size() == 0);
+    }
+
+    std::remove(cache.c_str());
+    std::remove(name);
+
+    auto cols = scn::scan_columns<int>(name, "{}");
+    CHECK(!cols.valid());
+    CHECK(cols.error().code() == scn::error::source_error);
+}
+
+TEST_CASE("scan_columns rewrites the cache without touching mappings")
+{
+    const auto path = scratch_file("columns-rewrite.txt");
+    const char* name = path.c_str();
+    auto write = [&](const char* contents) {
+        auto f = std::fopen(name, "w");
+        REQUIRE(f);
+        std::fputs(contents, f);
+        std::fclose(f);
+    };
+    const auto cache = path + ".scncol";
+
+    write("1\n2\n3\n");
+    scn::scan_columns<int>(name, "{}");
+    auto old = scn::scan_columns<int>(name, "{}");
+    REQUIRE(old.valid());
+    REQUIRE(old.from_cache());
+
+    // Same size: only the modification time tells the versions apart
+    write("4\n5\n6\n");
+    auto cols = scn::scan_columns<int>(name, "{}");
+    REQUIRE(cols.valid());
+    CHECK(!cols.from_cache());
+    CHECK(cols.column<0>()[0] == 4);
+
+    REQUIRE(old.size() == 3);
+    CHECK(old.column<0>()[0] == 1);
+    CHECK(old.column<0>()[2] == 3);
+
+    std::remove(cache.c_str());
+    std::remove(name);
+}
+
+TEST_CASE("scan_columns cache depends on the line ending")
+{
+    const auto path = scratch_file("columns-crlf.txt");
+    const char* name = path.c_str();
+    {
+        auto f = std::fopen(name, "wb");
+        REQUIRE(f);
+        std::fputs("1\r\n\r\n2\r\n", f);
+        std::fclose(f);
+    }
+    const auto cache = path + ".scncol";
+
+    scn::column_cache_options crlf{};
+    crlf.ending = scn::line_ending::crlf;
+    for (int i = 0; i < 2; ++i) {
+        auto cols = scn::scan_columns<int>(name, "{}", crlf);
+        REQUIRE(cols.valid());
+        CHECK(cols.from_cache() == (i == 1));
+        CHECK(cols.size() == 2);
+    }
+
+    // With lf, the second line is a lone '\r', and not a blank line
+    auto cols = scn::scan_columns<int>(name, "{}");
+    CHECK(!cols.from_cache());
+    CHECK(!cols.valid());
+
+    std::remove(cache.c_str());
+    std::remove(name);
+}
@@ -0,0 +1,177 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/csv.h>
+
+#include <cstdio>
+
+template <typename Records>
+static std::vector<std::vector<std::string>> collect(Records&& records)
+{
+    std::vector<std::vector<std::string>> out;
+    for (const auto& rec : records) {
+        out.emplace_back();
+        for (auto f : rec) {
+            out.back().emplace_back(f.data(), f.size());
+        }
+    }
+    return out;
+}
+
+using rows = std::vector<std::vector<std::string>>;
+
+TEST_CASE("csv basic")
+{
+    auto records = scn::csv("a,b,c\n1,,3\r\n\nlast,row");
+    CHECK(collect(records) ==
+          rows{{"a", "b", "c"}, {"1", "", "3"}, {"last", "row"}});
+    CHECK(records.error());
+}
+
+TEST_CASE("csv quoted fields")
+{
+    std::string source =
+        "\"x, y\",\"say \"\"hi\"\"\",\"multi\nline\"\n"
+        "\"\",plain,\"\"\"\"\n";
+    auto records = scn::csv(scn::make_view(source));
+    CHECK(collect(records) == rows{{"x, y", "say \"hi\"", "multi\nline"},
+                                   {"", "plain", "\""}});
+    CHECK(records.error());
+}
+
+TEST_CASE("csv zero copy")
+{
+    std::string source = "abc,\"quoted\"\n";
+    for (const auto& rec : scn::csv(scn::make_view(source))) {
+        REQUIRE(rec.size() == 2);
+        CHECK(rec[0].data() == source.data());
+        CHECK(rec[1].data() == source.data() + 5);
+    }
+}
+
+TEST_CASE("csv long records")
+{
+    // Quotes, separators and newlines across 64-character blocks
+    std::string expected_field(100, 'x');
+    expected_field[63] = '\n';
+    expected_field[64] = ',';
+    expected_field[70] = '"';
+    std::string quoted = expected_field;
+    quoted.insert(71, "\"");
+    const auto long_plain = std::string(130, 'p');
+
+    std::string source;
+    for (int i = 0; i < 3; ++i) {
+        source += long_plain + ",\"" + quoted + "\"," + std::to_string(i) +
+                  "\n";
+    }
+    auto records = scn::csv(scn::make_view(source));
+    auto r = collect(records);
+    CHECK(records.error());
+    REQUIRE(r.size() == 3);
+    for (size_t i = 0; i < 3; ++i) {
+        CHECK(r[i] == std::vector<std::string>{long_plain, expected_field,
+                                               std::to_string(i)});
+    }
+}
+
+TEST_CASE("csv options")
+{
+    scn::csv_options opt{};
+    opt.separator = ';';
+    opt.quote = '\'';
+    auto records = scn::csv("a;'b;c';'it''s'\n", opt);
+    CHECK(collect(records) == rows{{"a", "b;c", "it's"}});
+}
+
+TEST_CASE("csv errors")
+{
+    auto unterminated = scn::csv("a,b\n\"c,d\n");
+    CHECK(collect(unterminated) == rows{{"a", "b"}});
+    CHECK(!unterminated.error());
+    CHECK(unterminated.error() == scn::error::invalid_scanned_value);
+
+    auto trailing = scn::csv("\"a\"b,c\n");
+    CHECK(collect(trailing).empty());
+    CHECK(!trailing.error());
+
+    auto stray = scn::csv("a\"b,c\n");
+    CHECK(collect(stray).empty());
+    CHECK(!stray.error());
+}
+
+TEST_CASE("csv typed fields")
+{
+    std::string source = "name,age,score\nJohn Doe, 42 ,3.5\nx,y,1\n";
+    auto records = scn::csv(scn::make_view(source));
+    auto it = records.begin();
+    REQUIRE(it != records.end());
+    ++it;
+    REQUIRE(it != records.end());
+
+    std::string name;
+    int age{};
+    double score{};
+    auto e = it->scan(name, age, score);
+    CHECK(e);
+    CHECK(name == "John Doe");
+    CHECK(age == 42);
+    CHECK(score == doctest::Approx(3.5));
+
+    scn::string_view v;
+    CHECK(it->scan_field(0, v));
+    CHECK(std::string{v.data(), v.size()} == "John Doe");
+    CHECK(it->scan_field(3, v).code() == scn::error::end_of_range);
+
+    ++it;
+    REQUIRE(it != records.end());
+    e = it->scan(name, age);
+    CHECK(!e);
+    CHECK(e.code() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("csv wide")
+{
+    auto records = scn::csv(L"a,\"b\"\"c\"\n");
+    std::vector<std::wstring> fields;
+    for (const auto& rec : records) {
+        for (auto f : rec) {
+            fields.emplace_back(f.data(), f.size());
+        }
+    }
+    CHECK(fields == std::vector<std::wstring>{L"a", L"b\"c"});
+}
+
+TEST_CASE("csv file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("id,text\n1,\"a, \"\"b\"\"\nc\"\n2,d", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        auto records = scn::csv(file);
+        CHECK(collect(records) ==
+              rows{{"id", "text"}, {"1", "a, \"b\"\nc"}, {"2", "d"}});
+        CHECK(records.error());
+    }
+    std::fclose(f);
+}
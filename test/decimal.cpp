@@ -0,0 +1,139 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/decimal.h>
+#include <scn/fixed.h>
+
+#include <cstdio>
+
+using money = scn::decimal<12, 4>;
+
+TEST_CASE("decimal")
+{
+    money a{}, b{};
+    auto ret = scn::scan("-12345.6789 42", "{} {}", a, b);
+    REQUIRE(ret);
+    CHECK(a.scaled() == -123456789);
+    CHECK(a.integer_part() == -12345);
+    CHECK(a.fractional_part() == -6789);
+    CHECK(b.scaled() == 420000);
+    CHECK(b == money::from_scaled(420000));
+    CHECK(a < b);
+
+    // fewer fractional digits, leading zeros, signs, a missing part
+    ret = scn::scan("0001.5 +.25 7. -0.0", "{} {} {} {}", a, b, a, b);
+    REQUIRE(ret);
+    CHECK(a.scaled() == 70000);
+    CHECK(b.scaled() == 0);
+    ret = scn::scan("0001.5", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.scaled() == 15000);
+
+    // longer than 8 digits on both sides of the point
+    scn::decimal<18, 9> c{};
+    ret = scn::scan("123456789.123456789x", "{}", c);
+    REQUIRE(ret);
+    CHECK(c.scaled() == 123456789123456789);
+    CHECK(ret.range().size() == 1);
+
+    // trailing zeros are exact
+    ret = scn::scan("1.2500000000000000000", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.scaled() == 12500);
+
+    a = money::from_scaled(1);
+    ret = scn::scan("1.23456", "{}", a);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("12345678901.5", "{}", a);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("-", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan(".", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("abc", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    CHECK(a.scaled() == 1);
+
+    ret = scn::scan("1", "{:q}", a);
+    CHECK(ret.error() == scn::error::invalid_format_string);
+}
+
+TEST_CASE("decimal rounding")
+{
+    scn::decimal<6, 2> a{};
+    struct test_case {
+        const char* str;
+        int64_t truncated, half_up, half_even;
+    };
+    const test_case cases[] = {
+        {"1.234", 123, 123, 123},     {"1.235", 123, 124, 124},
+        {"1.245", 124, 125, 124},     {"1.2450001", 124, 125, 125},
+        {"1.236", 123, 124, 124},     {"-1.235", -123, -124, -124},
+        {"-1.245", -124, -125, -124}, {"0.00500000000", 0, 1, 0},
+        {"0.015", 1, 2, 2},
+    };
+    for (const auto& c : cases) {
+        auto ret = scn::scan(scn::string_view{c.str}, "{:t}", a);
+        REQUIRE(ret);
+        CHECK(a.scaled() == c.truncated);
+        ret = scn::scan(scn::string_view{c.str}, "{:r}", a);
+        REQUIRE(ret);
+        CHECK(a.scaled() == c.half_up);
+        ret = scn::scan(scn::string_view{c.str}, "{:e}", a);
+        REQUIRE(ret);
+        CHECK(a.scaled() == c.half_even);
+    }
+
+    // rounding up past the number of digits
+    auto ret = scn::scan("9999.995", "{:r}", a);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("9999.995", "{:t}", a);
+    REQUIRE(ret);
+    CHECK(a.scaled() == 999999);
+}
+
+TEST_CASE("decimal wide, file and fixed")
+{
+    money a{};
+    auto wret = scn::scan(L"-0.5", L"{}", a);
+    REQUIRE(wret);
+    CHECK(a.scaled() == -5000);
+
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("price=19.99\n", f);
+    std::rewind(f);
+    {
+        scn::file file{f};
+        auto e = scn::scan(file, "price={}", a);
+        REQUIRE(e);
+        CHECK(a.scaled() == 199900);
+    }
+    std::fclose(f);
+
+    scn::decimal<8, 2> price{};
+    int qty{};
+    const scn::fixed_layout layout{{0, 10}, {10, 4}};
+    auto e =
+        scn::scan_fixed(scn::string_view{"  1234.50   3"}, layout, price, qty);
+    REQUIRE(e);
+    CHECK(price.scaled() == 123450);
+    CHECK(qty == 3);
+}
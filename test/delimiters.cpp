@@ -0,0 +1,204 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+TEST_CASE_TEMPLATE("delimiters", CharT, char, wchar_t)
+{
+    using string_type = std::basic_string<CharT>;
+    const auto delims = widen<CharT>(",;\t");
+    const auto d = scn::with_delimiters(
+        scn::basic_string_view<CharT>{delims.data(), delims.size()});
+
+    SUBCASE("mixed")
+    {
+        const auto source = widen<CharT>("John Doe,42;0.5\ttrue");
+        string_type name{};
+        int age{};
+        double score{};
+        bool b{};
+        auto ret = scn::scan(scn::make_view(source), d,
+                             widen<CharT>("{} {} {} {}").c_str(), name, age,
+                             score, b);
+        CHECK(ret);
+        CHECK(name == widen<CharT>("John Doe"));
+        CHECK(age == 42);
+        CHECK(score == doctest::Approx(0.5));
+        CHECK(b);
+        CHECK(ret.range().empty());
+    }
+    SUBCASE("literal delimiters")
+    {
+        const auto source = widen<CharT>("a b;12,x");
+        string_type a{}, c{};
+        int b{};
+        auto ret = scn::scan(scn::make_view(source), d,
+                             widen<CharT>("{};{},{}").c_str(), a, b, c);
+        CHECK(ret);
+        CHECK(a == widen<CharT>("a b"));
+        CHECK(b == 12);
+        CHECK(c == widen<CharT>("x"));
+    }
+    SUBCASE("default format")
+    {
+        const auto source = widen<CharT>("first field,  2 \t3");
+        string_type a{};
+        int b{}, c{};
+        auto ret = scn::scan(scn::make_view(source), d, scn::default_tag, a,
+                             b, c);
+        CHECK(ret);
+        CHECK(a == widen<CharT>("first field"));
+        CHECK(b == 2);
+        CHECK(c == 3);
+    }
+    SUBCASE("empty number field")
+    {
+        // An empty field doesn't shift the following ones
+        const auto source = widen<CharT>("first field,,  2\t3");
+        string_type a{};
+        int b{}, c{};
+        auto ret = scn::scan(scn::make_view(source), d, scn::default_tag, a,
+                             b, c);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::invalid_scanned_value);
+    }
+    SUBCASE("string_view")
+    {
+        const auto source =
+            widen<CharT>(std::string(100, 'x') + " y;" + std::string(3, 'z'));
+        scn::basic_string_view<CharT> a{}, b{};
+        auto ret = scn::scan(scn::make_view(source), d,
+                             widen<CharT>("{};{}").c_str(), a, b);
+        CHECK(ret);
+        CHECK(string_type{a.data(), a.size()} ==
+              widen<CharT>(std::string(100, 'x') + " y"));
+        CHECK(string_type{b.data(), b.size()} == widen<CharT>("zzz"));
+    }
+    SUBCASE("empty field")
+    {
+        const auto source = widen<CharT>(",x");
+        string_type a{widen<CharT>("old")};
+        auto ret = scn::scan(scn::make_view(source), d,
+                             widen<CharT>("{}").c_str(), a);
+        CHECK(ret);
+        CHECK(a.empty());
+        CHECK(ret.range().size() == 2);
+    }
+    SUBCASE("empty string fields")
+    {
+        const auto source = widen<CharT>("a,,c; ;e");
+        string_type a{}, b{}, c{}, e{};
+        scn::basic_string_view<CharT> sv{};
+        auto ret = scn::scan(scn::make_view(source), d,
+                             widen<CharT>("{} {} {} {} {}").c_str(), a, b, c,
+                             sv, e);
+        CHECK(ret);
+        CHECK(a == widen<CharT>("a"));
+        CHECK(b.empty());
+        CHECK(c == widen<CharT>("c"));
+        CHECK(sv.size() == 0);
+        CHECK(e == widen<CharT>("e"));
+
+        ret = scn::scan(scn::make_view(source), d,
+                        widen<CharT>("{},{},{}").c_str(), a, b, c);
+        CHECK(ret);
+        CHECK(a == widen<CharT>("a"));
+        CHECK(b.empty());
+        CHECK(c == widen<CharT>("c"));
+    }
+}
+
+TEST_CASE("delimiters don't merge empty fields")
+{
+    int i{}, j{}, k{};
+    auto ret = scn::scan("1,,3,4", scn::with_delimiters(","), "{} {} {}", i,
+                         j, k);
+    CHECK(!ret);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+
+    ret = scn::scan("1,,3,4", scn::with_delimiters(","), "{},{},{}", i, j, k);
+    CHECK(!ret);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+
+    ret = scn::scan("1 , 3,4", scn::with_delimiters(","), "{} {} {}", i, j,
+                    k);
+    CHECK(ret);
+    CHECK(i == 1);
+    CHECK(j == 3);
+    CHECK(k == 4);
+}
+
+TEST_CASE("delimiters with scanset")
+{
+    std::string a{}, b{};
+    auto ret = scn::scan("ab;cd,ef", scn::with_delimiters(";,"),
+                         "{:[a-c]};{}", a, b);
+    CHECK(ret);
+    CHECK(a == "ab");
+    CHECK(b == "cd");
+}
+
+TEST_CASE("delimiters file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("key one|17|2.5|false\n", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        std::string k{};
+        int i{};
+        double x{};
+        bool b{true};
+        auto ret = scn::scan(file, scn::with_delimiters("|\n"), "{} {} {} {}",
+                             k, i, x, b);
+        CHECK(ret);
+        CHECK(k == "key one");
+        CHECK(i == 17);
+        CHECK(x == doctest::Approx(2.5));
+        CHECK(!b);
+    }
+    std::fclose(f);
+}
+
+TEST_CASE("delimiters file with empty fields")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("a||c|1||2", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        std::string a{}, b{"old"}, c{};
+        int i{}, j{};
+        auto ret = scn::scan(file, scn::with_delimiters("|"), "{} {} {} {}",
+                             a, b, c, i);
+        CHECK(ret);
+        CHECK(a == "a");
+        CHECK(b.empty());
+        CHECK(c == "c");
+        CHECK(i == 1);
+
+        ret = scn::scan(file, scn::with_delimiters("|"), "{} {}", i, j);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::invalid_scanned_value);
+    }
+    std::fclose(f);
+}
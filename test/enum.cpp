@@ -0,0 +1,127 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/enum.h>
+
+#include <cstdio>
+
+enum class color { red, green, blue };
+enum level { level_debug, level_info, level_warning, level_error };
+
+namespace scn {
+    template <>
+    struct enum_names<color> {
+        static span<const enum_entry<color>> entries()
+        {
+            static const enum_entry<color> e[] = {{"red", color::red},
+                                                  {"green", color::green},
+                                                  {"blue", color::blue},
+                                                  {"Red", color::red}};
+            return {std::begin(e), std::end(e)};
+        }
+    };
+
+    template <>
+    struct enum_names<level> {
+        static span<const enum_entry<level>> entries()
+        {
+            static const enum_entry<level> e[] = {{"DEBUG", level_debug},
+                                                  {"INFO", level_info},
+                                                  {"WARNING", level_warning},
+                                                  {"WARN", level_warning},
+                                                  {"ERROR", level_error}};
+            return {std::begin(e), std::end(e)};
+        }
+        static constexpr bool case_insensitive = true;
+    };
+}  // namespace scn
+
+TEST_CASE_TEMPLATE("enum", CharT, char, wchar_t)
+{
+    color a{}, b{}, c{};
+    auto e = do_scan<CharT>("blue green Red", "{} {} {}", a, b, c);
+    CHECK(e);
+    CHECK(a == color::blue);
+    CHECK(b == color::green);
+    CHECK(c == color::red);
+
+    e = do_scan<CharT>("purple", "{}", a);
+    CHECK(!e);
+    CHECK(e.error() == scn::error::invalid_scanned_value);
+    CHECK(a == color::blue);
+
+    e = do_scan<CharT>("GREEN", "{}", a);
+    CHECK(!e);
+    e = do_scan<CharT>("GREEN", "{:i}", a);
+    CHECK(e);
+    CHECK(a == color::green);
+}
+
+TEST_CASE("unscoped case-insensitive enum")
+{
+    level l{}, l2{};
+    auto e = scn::scan("warn Error", "{} {}", l, l2);
+    CHECK(e);
+    CHECK(l == level_warning);
+    CHECK(l2 == level_error);
+
+    e = scn::scan("inf", "{}", l);
+    CHECK(!e);
+}
+
+TEST_CASE("enum from file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("red blue", f);
+    std::rewind(f);
+    {
+        scn::file file{f};
+        color a{}, b{};
+        auto e = scn::scan(file, "{} {}", a, b);
+        CHECK(e);
+        CHECK(a == color::red);
+        CHECK(b == color::blue);
+    }
+    std::fclose(f);
+}
+
+TEST_CASE("enum table without a perfect hash")
+{
+    // no tries: the names are looked up one at a time
+    scn::detail::enum_table<level> table{true, 0};
+    auto e = table.find("warn", 4);
+    REQUIRE(e);
+    CHECK(e->value == level_warning);
+    e = table.find(L"Warning", 7);
+    REQUIRE(e);
+    CHECK(e->value == level_warning);
+    e = table.find("ERROR", 5);
+    REQUIRE(e);
+    CHECK(e->value == level_error);
+    CHECK(!table.find("WARNS", 5));
+    CHECK(!table.find("X", 1));
+
+    scn::detail::enum_table<color> colors{false, 0};
+    auto c = colors.find("Red", 3);
+    REQUIRE(c);
+    CHECK(c->value == color::red);
+    CHECK(!colors.find("RED", 3));
+}
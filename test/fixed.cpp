@@ -0,0 +1,126 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/fixed.h>
+#include <scn/lines.h>
+
+TEST_CASE("fixed layout")
+{
+    auto layout = scn::fixed_layout{}.add(4).add(2, 6).add(10);
+    REQUIRE(layout.size() == 3);
+    CHECK(layout[0].offset == 0);
+    CHECK(layout[1].offset == 2);
+    CHECK(layout[2].offset == 8);
+    CHECK(layout[2].width == 10);
+    CHECK(layout.record_width() == 18);
+
+    scn::fixed_layout list{{10, 2}, {0, 5}};
+    CHECK(list.size() == 2);
+    CHECK(list.record_width() == 12);
+}
+
+TEST_CASE("fixed padded numbers")
+{
+    const auto layout = scn::fixed_layout{}.add(8).add(10).add(5).add(6);
+    std::string account;
+    double amount{};
+    int qty{};
+    unsigned code{};
+    const std::string line = "AB12       1234.50   10000789";
+    auto e = scn::scan_fixed(line, layout, account, amount, qty, code);
+    REQUIRE(e);
+    CHECK(account == "AB12");
+    CHECK(amount == doctest::Approx(1234.5));
+    CHECK(qty == 10);
+    CHECK(code == 789);
+
+    // fields without padding, side by side
+    int a{}, b{};
+    e = scn::scan_fixed(scn::string_view{"-0123+456"},
+                        scn::fixed_layout{{0, 5}, {5, 4}}, a, b);
+    REQUIRE(e);
+    CHECK(a == -123);
+    CHECK(b == 456);
+}
+
+TEST_CASE("fixed invalid fields")
+{
+    const auto layout = scn::fixed_layout{}.add(4).add(4);
+    int a{}, b{};
+    auto e = scn::scan_fixed(scn::string_view{"  12 3 4"}, layout, a, b);
+    CHECK(e.code() == scn::error::invalid_scanned_value);
+    CHECK(a == 12);
+
+    e = scn::scan_fixed(scn::string_view{"  12    "}, layout, a, b);
+    CHECK(e.code() == scn::error::invalid_scanned_value);
+
+    e = scn::scan_fixed(scn::string_view{"  12"}, layout, a, b);
+    CHECK(e.code() == scn::error::end_of_range);
+
+    double d{};
+    e = scn::scan_fixed(scn::string_view{"1.5e"}, layout, d);
+    CHECK(!e);
+
+    e = scn::scan_fixed(scn::string_view{"1   2   "}, scn::fixed_layout{{0, 4}},
+                        a, b);
+    CHECK(e.code() == scn::error::invalid_argument);
+}
+
+TEST_CASE("fixed short records")
+{
+    const auto layout = scn::fixed_layout{}.add(3).add(10).add(6);
+    int id{};
+    std::string name;
+    scn::string_view note;
+    auto e = scn::scan_fixed(scn::string_view{" 42Alice     x"}, layout, id,
+                             name, note);
+    REQUIRE(e);
+    CHECK(id == 42);
+    CHECK(name == "Alice");
+    CHECK(std::string(note.data(), note.size()) == "x");
+}
+
+TEST_CASE("fixed lines")
+{
+    const std::string source = "  1 10.25\n 20  -3.5\n300   7  \n";
+    const auto layout = scn::fixed_layout{}.add(3).add(7);
+    std::vector<int> ids;
+    std::vector<double> values;
+    for (auto line : scn::lines(scn::make_view(source))) {
+        int id{};
+        double v{};
+        REQUIRE(scn::scan_fixed(line, layout, id, v));
+        ids.push_back(id);
+        values.push_back(v);
+    }
+    CHECK(ids == std::vector<int>{1, 20, 300});
+    CHECK(values == std::vector<double>{10.25, -3.5, 7});
+}
+
+TEST_CASE("fixed wide")
+{
+    const auto layout = scn::fixed_layout{}.add(5).add(5);
+    std::wstring w;
+    long long n{};
+    auto e = scn::scan_fixed(scn::wstring_view{L"  abc 9000"}, layout, w, n);
+    REQUIRE(e);
+    CHECK(w == L"abc");
+    CHECK(n == 9000);
+}
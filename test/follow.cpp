@@ -0,0 +1,172 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/follow.h>
+
+#include <cstdio>
+
+static void append(const char* name, const char* str)
+{
+    auto f = std::fopen(name, "a");
+    REQUIRE(f);
+    std::fputs(str, f);
+    std::fclose(f);
+}
+
+static std::vector<std::string> poll_lines(scn::file_follower& f)
+{
+    std::vector<std::string> result;
+    auto ret = f.poll([&](scn::string_view line) {
+        result.emplace_back(line.data(), line.size());
+    });
+    CHECK(ret);
+    CHECK(ret.value() == result.size());
+    return result;
+}
+
+TEST_CASE("file_follower")
+{
+    const auto path = scratch_file("follow-log.txt");
+    const char* name = path.c_str();
+    append(name, "first\nsec");
+
+    scn::file_follower f{name};
+    REQUIRE(f.valid());
+
+    auto l = poll_lines(f);
+    REQUIRE(l.size() == 1);
+    CHECK(l[0] == "first");
+    CHECK(std::string{f.pending().data(), f.pending().size()} == "sec");
+    CHECK(f.checkpoint().offset == 6);
+
+    CHECK(poll_lines(f).empty());
+    CHECK(!f.wait(0));
+
+    append(name, "ond\nthird 3\n");
+    CHECK(f.wait(1000));
+    l = poll_lines(f);
+    REQUIRE(l.size() == 2);
+    CHECK(l[0] == "second");
+    CHECK(l[1] == "third 3");
+    CHECK(f.pending().size() == 0);
+
+    SUBCASE("resume")
+    {
+        const auto cp = f.checkpoint();
+        append(name, "fourth\n");
+
+        scn::file_follower g{name, cp};
+        REQUIRE(g.valid());
+        l = poll_lines(g);
+        REQUIRE(l.size() == 1);
+        CHECK(l[0] == "fourth");
+    }
+    SUBCASE("truncate")
+    {
+        {
+            auto file = std::fopen(name, "w");
+            REQUIRE(file);
+            std::fclose(file);
+        }
+        append(name, "new\n");
+        l = poll_lines(f);
+        REQUIRE(l.size() == 1);
+        CHECK(l[0] == "new");
+    }
+
+    std::remove(name);
+}
+
+TEST_CASE("file_follower large append")
+{
+    const auto path = scratch_file("follow-large.txt");
+    const char* name = path.c_str();
+    std::remove(name);
+
+    // 100-byte lines, so that chunks end in the middle of a line
+    const std::size_t line_count = 200000;
+    {
+        auto file = std::fopen(name, "w");
+        REQUIRE(file);
+        for (std::size_t i = 0; i < line_count; ++i) {
+            std::fprintf(file, "%99llu\n",
+                         static_cast<unsigned long long>(i));
+        }
+        std::fclose(file);
+    }
+
+    scn::file_follower f{name};
+    REQUIRE(f.valid());
+
+    std::size_t n = 0;
+    std::size_t max_pending = 0;
+    bool in_order = true;
+    auto on_line = [&](scn::string_view line) {
+        unsigned long long i{};
+        in_order = in_order && line.size() == 99 &&
+                   scn::scan(line, "{}", i) && i == n;
+        ++n;
+        max_pending = std::max(max_pending, f.pending().size());
+    };
+
+    // Only max_chunks_per_poll chunks of 1 MiB are read in one go
+    const std::size_t per_poll = scn::file_follower::max_chunks_per_poll *
+                                 (std::size_t{1} << 20) / 100;
+    auto ret = f.poll(on_line);
+    REQUIRE(ret);
+    CHECK(ret.value() == per_poll);
+    CHECK(f.checkpoint().offset == per_poll * 100);
+    CHECK(f.wait(0));
+
+    ret = f.poll(on_line);
+    REQUIRE(ret);
+    CHECK(ret.value() == line_count - per_poll);
+    CHECK(n == line_count);
+    CHECK(in_order);
+    CHECK(f.checkpoint().offset == line_count * 100);
+    CHECK(f.pending().size() == 0);
+    CHECK(!f.wait(0));
+
+    // the buffer never held more than a chunk
+    CHECK(max_pending <= (std::size_t{1} << 20) + 100);
+
+    std::remove(name);
+}
+
+TEST_CASE("follow_checkpoint")
+{
+    const auto path = scratch_file("follow-checkpoint.txt");
+    const char* name = path.c_str();
+
+    scn::follow_checkpoint cp{};
+    cp.offset = 1234567890123;
+    cp.file_id = 42;
+    CHECK(scn::save_follow_checkpoint(cp, name));
+    cp.offset = 5;
+    CHECK(scn::save_follow_checkpoint(cp, name));
+
+    auto ret = scn::load_follow_checkpoint(name);
+    REQUIRE(ret);
+    CHECK(ret.value().offset == 5);
+    CHECK(ret.value().file_id == 42);
+    std::remove(name);
+
+    CHECK(!scn::load_follow_checkpoint(name));
+}
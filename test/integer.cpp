@@ -18,6 +18,8 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "test.h"
 
+#include <cstdio>
+
 TEST_CASE("simple")
 {
     int i{};
@@ -575,3 +577,276 @@ TEST_CASE("trailing")
     CHECK(ret.range().size() == 1);
     CHECK(ret.range()[0] == ';');
 }
+
+TEST_CASE("integer hex and octal")
+{
+    SUBCASE("hex")
+    {
+        unsigned long long u{};
+        auto ret = scn::scan("ffffffffffffffff", "{:x}", u);
+        CHECK(ret);
+        CHECK(u == 0xffffffffffffffffull);
+        ret = scn::scan("0xDEADbeefCAFEbabe", "{}", u);
+        CHECK(ret);
+        CHECK(u == 0xdeadbeefcafebabeull);
+        ret = scn::scan("00000000000000000000000012345678", "{:x}", u);
+        CHECK(ret);
+        CHECK(u == 0x12345678);
+        ret = scn::scan("10000000000000000", "{:x}", u);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+
+        std::string rest{};
+        ret = scn::scan("deadbeefcafeg", "{:x}{}", u, rest);
+        CHECK(ret);
+        CHECK(u == 0xdeadbeefcafeull);
+        CHECK(rest == "g");
+    }
+    SUBCASE("hex signed")
+    {
+        int i{};
+        auto ret = scn::scan("7fffffff", "{:x}", i);
+        CHECK(ret);
+        CHECK(i == 0x7fffffff);
+        ret = scn::scan("-0x80000000", "{}", i);
+        CHECK(ret);
+        CHECK(i == std::numeric_limits<int>::min());
+        ret = scn::scan("80000000", "{:x}", i);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+        ret = scn::scan("-80000001", "{:x}", i);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+
+        short s{};
+        ret = scn::scan("-7fff", "{:x}", s);
+        CHECK(ret);
+        CHECK(s == -0x7fff);
+    }
+    SUBCASE("octal")
+    {
+        unsigned long long u{};
+        auto ret = scn::scan("1777777777777777777777", "{:o}", u);
+        CHECK(ret);
+        CHECK(u == 0xffffffffffffffffull);
+        ret = scn::scan("2000000000000000000000", "{:o}", u);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+
+        int i{}, j{};
+        ret = scn::scan("0123456701 12345678", "{} {:o}", i, j);
+        CHECK(ret);
+        CHECK(i == 0123456701);
+        CHECK(j == 01234567);
+        CHECK(ret.range().size() == 1);
+    }
+    SUBCASE("wide")
+    {
+        long long i{};
+        auto ret = scn::scan(L"-0x7fffFFFFffffFFFF", L"{}", i);
+        CHECK(ret);
+        CHECK(i == -0x7fffffffffffffffll);
+    }
+    SUBCASE("round trip")
+    {
+        unsigned long long v = 0x9e3779b97f4a7c15ull;
+        char buf[32]{};
+        for (int n = 0; n < 200; ++n) {
+            v ^= v << 13;
+            v ^= v >> 7;
+            v ^= v << 17;
+            const auto x = v >> (n % 64);
+
+            unsigned long long h{}, o{};
+            std::snprintf(buf, sizeof(buf), "%llx", x);
+            CHECK(scn::scan(scn::string_view{buf}, "{:x}", h));
+            std::snprintf(buf, sizeof(buf), "%llo", x);
+            CHECK(scn::scan(scn::string_view{buf}, "{:o}", o));
+            CHECK(h == x);
+            CHECK(o == x);
+        }
+    }
+}
+
+TEST_CASE("integer decimal digit runs")
+{
+    SUBCASE("limits")
+    {
+        int i{};
+        auto ret = scn::scan("2147483647", "{}", i);
+        CHECK(ret);
+        CHECK(i == 2147483647);
+        ret = scn::scan("-2147483648", "{}", i);
+        CHECK(ret);
+        CHECK(i == std::numeric_limits<int>::min());
+        ret = scn::scan("2147483648", "{}", i);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+        ret = scn::scan("99999999999999999999999999999999", "{}", i);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+
+        unsigned long long u{};
+        ret = scn::scan("18446744073709551615", "{}", u);
+        CHECK(ret);
+        CHECK(u == 18446744073709551615ull);
+        ret = scn::scan("18446744073709551616", "{}", u);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+
+        long long ll{};
+        ret = scn::scan("-9223372036854775808", "{}", ll);
+        CHECK(ret);
+        CHECK(ll == std::numeric_limits<long long>::min());
+
+        unsigned short us{};
+        ret = scn::scan("65535", "{}", us);
+        CHECK(ret);
+        CHECK(us == 65535);
+        ret = scn::scan("65536", "{}", us);
+        CHECK(!ret);
+    }
+    SUBCASE("leading zeros")
+    {
+        int i{};
+        auto ret =
+            scn::scan("0000000000000000000000000002147483647", "{:d}", i);
+        CHECK(ret);
+        CHECK(i == 2147483647);
+        ret = scn::scan("00000000000000000000000000000000", "{:d}", i);
+        CHECK(ret);
+        CHECK(i == 0);
+        ret = scn::scan("0000000000000000000000000002147483648", "{:d}", i);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+    }
+    SUBCASE("followed by other characters")
+    {
+        long long a{}, b{};
+        std::string rest{};
+        auto ret = scn::scan("123456789012345678abc 42:x", "{}{} {}{}", a,
+                             rest, b, rest);
+        CHECK(ret);
+        CHECK(a == 123456789012345678);
+        CHECK(b == 42);
+        CHECK(rest == ":x");
+    }
+}
+
+#if SCN_HAS_INT128
+TEST_CASE("int128")
+{
+    using scn::detail::int128;
+    using scn::detail::uint128;
+
+    const auto uint128_max = ~uint128{0};
+    const auto int128_max = static_cast<int128>(uint128_max >> 1);
+    const auto int128_min = -int128_max - 1;
+    // 10^19
+    const auto chunk = uint128{UINT64_C(10000000000000000000)};
+
+    SUBCASE("unsigned")
+    {
+        uint128 a{}, b{}, c{};
+        auto ret = scn::scan("340282366920938463463374607431768211455 "
+                             "12345678901234567890 42",
+                             "{} {} {}", a, b, c);
+        CHECK(ret);
+        CHECK(a == uint128_max);
+        CHECK(b == uint128{1234567890} * chunk / 1000000000 + 1234567890u);
+        CHECK(c == 42);
+
+        ret = scn::scan("340282366920938463463374607431768211456", "{}", a);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+        ret = scn::scan("1000000000000000000000000000000000000000", "{}", a);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+        ret = scn::scan("-1", "{}", a);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+    }
+    SUBCASE("signed")
+    {
+        int128 a{}, b{};
+        int i{};
+        auto ret = scn::scan("170141183460469231731687303715884105727 "
+                             "-170141183460469231731687303715884105728 7",
+                             "{} {} {}", a, b, i);
+        CHECK(ret);
+        CHECK(a == int128_max);
+        CHECK(b == int128_min);
+        CHECK(i == 7);
+
+        ret = scn::scan("-99999999999999999999", "{}", a);
+        CHECK(ret);
+        CHECK(a == -static_cast<int128>(chunk * 10 - 1));
+
+        ret = scn::scan("170141183460469231731687303715884105728", "{}", a);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+        ret = scn::scan("-170141183460469231731687303715884105729", "{}", a);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+    }
+    SUBCASE("leading zeroes and trailing characters")
+    {
+        uint128 a{};
+        auto ret = scn::scan(
+            "0000000000000000000000000000000000000000000000000001", "{:d}",
+            a);
+        CHECK(ret);
+        CHECK(a == 1);
+
+        std::string rest{};
+        ret = scn::scan("12345678901234567890123abc", "{}{}", a, rest);
+        CHECK(ret);
+        CHECK(a == uint128{1234567890123456789u} * 10000 + 123);
+        CHECK(rest == "abc");
+    }
+    SUBCASE("other bases")
+    {
+        uint128 a{};
+        auto ret = scn::scan("ffffffffffffffffffffffffffffffff", "{:x}", a);
+        CHECK(ret);
+        CHECK(a == uint128_max);
+        ret = scn::scan("0x10000000000000000", "{}", a);
+        CHECK(ret);
+        CHECK(a == uint128{1} << 64);
+        ret = scn::scan("100000000000000000000000000000000", "{:x}", a);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+    }
+    SUBCASE("wide")
+    {
+        int128 a{};
+        auto ret = scn::scan(L"-170141183460469231731687303715884105728",
+                             L"{}", a);
+        CHECK(ret);
+        CHECK(a == int128_min);
+    }
+    SUBCASE("file")
+    {
+        auto f = std::tmpfile();
+        REQUIRE(f);
+        std::fputs("98765432109876543210987654321 1", f);
+        std::rewind(f);
+        scn::file file{f};
+
+        uint128 a{};
+        int i{};
+        auto ret = scn::scan(file, "{} {}", a, i);
+        CHECK(ret);
+        CHECK(a == uint128{9876543210u} * chunk + 9876543210987654321u);
+        CHECK(i == 1);
+        std::fclose(f);
+    }
+    SUBCASE("localized digits")
+    {
+        uint128 a{};
+        auto ret = scn::scan("1", "{:l}", a);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::invalid_format_string);
+    }
+}
+#endif
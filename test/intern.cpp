@@ -0,0 +1,99 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/intern.h>
+
+#include <cstdio>
+
+TEST_CASE("intern_pool")
+{
+    scn::intern_pool pool{4};
+    CHECK(pool.size() == 0);
+    CHECK(pool.find("foo") == scn::intern_pool::npos);
+
+    auto foo = pool.intern("foo");
+    auto bar = pool.intern("bar");
+    CHECK(foo == 0);
+    CHECK(bar == 1);
+    CHECK(pool.intern("foo") == foo);
+    CHECK(pool.find("bar") == bar);
+    CHECK(pool.intern("") == 2);
+    CHECK(pool.size() == 3);
+
+    // grows past the initial capacity, keeping the ids
+    std::vector<std::string> strs;
+    for (int i = 0; i < 1000; ++i) {
+        strs.push_back("string number " + std::to_string(i));
+    }
+    for (const auto& s : strs) {
+        pool.intern({s.data(), s.size()});
+    }
+    CHECK(pool.size() == 1003);
+    for (std::size_t i = 0; i < strs.size(); ++i) {
+        const auto id = pool.find({strs[i].data(), strs[i].size()});
+        CHECK(id == i + 3);
+        auto s = pool.str(id);
+        CHECK(std::string{s.data(), s.size()} == strs[i]);
+    }
+    CHECK(pool.find("foo") == foo);
+    auto bar_str = pool.str(bar);
+    CHECK(std::string{bar_str.data(), bar_str.size()} == "bar");
+}
+
+TEST_CASE_TEMPLATE("interned", CharT, char, wchar_t)
+{
+    scn::basic_intern_pool<CharT> pool{};
+    scn::interned<scn::basic_intern_pool<CharT>> a{pool}, b{pool}, c{pool};
+    CHECK(!a.has_value());
+
+    auto e = do_scan<CharT>("GET POST GET", "{} {} {}", a, b, c);
+    CHECK(e);
+    CHECK(a.id() == c.id());
+    CHECK(a.id() != b.id());
+    CHECK(pool.size() == 2);
+    CHECK(std::basic_string<CharT>{b.view().data(), b.view().size()} ==
+          widen<CharT>("POST"));
+}
+
+TEST_CASE("interned from file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("200 404 200 200 500", f);
+    std::rewind(f);
+
+    scn::intern_pool pool{};
+    std::vector<scn::intern_pool::id_type> ids;
+    {
+        scn::file file{f};
+        scn::interned<scn::intern_pool> status{pool};
+        while (scn::scan(file, "{}", status)) {
+            ids.push_back(status.id());
+        }
+    }
+    std::fclose(f);
+
+    CHECK(pool.size() == 3);
+    REQUIRE(ids.size() == 5);
+    CHECK(ids[0] == ids[2]);
+    CHECK(ids[0] == ids[3]);
+    auto last = pool.str(ids[4]);
+    CHECK(std::string{last.data(), last.size()} == "500");
+}
@@ -0,0 +1,161 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/kv.h>
+
+TEST_CASE("kv logfmt")
+{
+    int status{};
+    std::string msg;
+    double took{};
+    bool cached{false};
+    scn::kv_extractor ex{scn::kv_format::logfmt};
+    ex.add("status", status).add("msg", msg).add("took", took).add("cached",
+                                                                    cached);
+    CHECK(ex.size() == 4);
+
+    auto ret = ex.extract(
+        "level=info msg=\"hello \\\"world\\\"\" path=/a=b status=200 "
+        "took=1.5 cached");
+    REQUIRE(ret);
+    CHECK(ret.value() == 4);
+    CHECK(status == 200);
+    CHECK(msg == "hello \"world\"");
+    CHECK(took == doctest::Approx(1.5));
+    CHECK(cached);
+
+    status = 0;
+    ret = ex.extract("level=debug msg=plain status= other=1");
+    REQUIRE(!ret);
+    CHECK(ret.error() == scn::error::end_of_range);
+
+    ret = ex.extract("level=debug msg=plain");
+    REQUIRE(ret);
+    CHECK(ret.value() == 1);
+    CHECK(ex.found(1));
+    CHECK(!ex.found(0));
+    CHECK(msg == "plain");
+}
+
+TEST_CASE("kv logfmt unrelated keys")
+{
+    int id{};
+    scn::kv_extractor ex{};
+    ex.add("id", id);
+
+    // Keys containing the wanted one, and a value looking like it
+    auto ret = ex.extract("idx=1 uid=2 note=\"id=3\" id=4 id=5");
+    REQUIRE(ret);
+    CHECK(ret.value() == 1);
+    CHECK(id == 4);
+
+    ret = ex.extract("nothing to see here");
+    REQUIRE(ret);
+    CHECK(ret.value() == 0);
+
+    // Not looked at without the key
+    ret = ex.extract("a=\"unterminated");
+    REQUIRE(ret);
+    CHECK(ret.value() == 0);
+
+    ret = ex.extract("a=\"unterminated id=1");
+    CHECK(!ret);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("kv key at every position")
+{
+    int value{};
+    scn::kv_extractor ex{};
+    ex.add("some_longer_key", value);
+
+    // Across the blocks searched for the key
+    for (int pad = 0; pad < 140; ++pad) {
+        const auto line = "pad=" + std::string(static_cast<size_t>(pad), 'y') +
+                          " some_longer_key=" + std::to_string(pad);
+        value = -1;
+        auto ret = ex.extract({line.data(), line.size()});
+        REQUIRE(ret);
+        CHECK(ret.value() == 1);
+        CHECK(value == pad);
+    }
+}
+
+TEST_CASE("kv json")
+{
+    int code{};
+    std::string user;
+    scn::string_view host;
+    std::string tags;
+    scn::kv_extractor ex{scn::kv_format::json};
+    ex.add("code", code).add("user", user).add("host", host).add("tags",
+                                                                 tags);
+
+    std::string line =
+        "{\"nested\": {\"code\": 1, \"list\": [1, \"]\", {}]}, "
+        "\"user\": \"J\\u00f6rg \\\"jo\\\"\", \"code\": -7,"
+        "\"host\":\"example.org\", \"tags\" : [\"a\", \"b\"], \"x\": true}";
+    auto ret = ex.extract({line.data(), line.size()});
+    REQUIRE(ret);
+    CHECK(ret.value() == 4);
+    CHECK(code == -7);
+    CHECK(user == "J\xc3\xb6rg \"jo\"");
+    CHECK(std::string{host.data(), host.size()} == "example.org");
+    CHECK(tags == "[\"a\", \"b\"]");
+}
+
+TEST_CASE("kv json null and errors")
+{
+    int code{42};
+    scn::kv_extractor ex{scn::kv_format::json};
+    ex.add("code", code);
+
+    auto ret = ex.extract("{\"code\": null, \"other\": 1}");
+    REQUIRE(ret);
+    CHECK(ret.value() == 0);
+    CHECK(code == 42);
+
+    ret = ex.extract("{}");
+    REQUIRE(ret);
+    CHECK(ret.value() == 0);
+
+    ret = ex.extract("[\"code\", 2]");
+    CHECK(!ret);
+    ret = ex.extract("{\"a\": 1 \"code\": 2}");
+    CHECK(!ret);
+    ret = ex.extract("{\"a\": {\"b\": 1}, \"code\": 1");
+    CHECK(!ret);
+    ret = ex.extract("{\"code\": \"x\"}");
+    CHECK(!ret);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("kv wide")
+{
+    int n{};
+    std::wstring s;
+    scn::wkv_extractor ex{};
+    ex.add(L"n", n).add(L"s", s);
+    auto ret = ex.extract(L"s=\"a b\" n=3");
+    REQUIRE(ret);
+    CHECK(ret.value() == 2);
+    CHECK(n == 3);
+    CHECK(s == L"a b");
+}
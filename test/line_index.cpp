@@ -0,0 +1,212 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/line_index.h>
+
+#include <cstdio>
+#include <cstring>
+
+static std::string make_source(int lines)
+{
+    std::string source;
+    for (int i = 0; i < lines; ++i) {
+        source += "record ";
+        source += std::to_string(i);
+        // a few long lines, to get wider deltas
+        if (i % 1000 == 999) {
+            source += std::string(70000, ' ');
+        }
+        source += '\n';
+    }
+    return source;
+}
+
+TEST_CASE("line_index")
+{
+    SUBCASE("empty")
+    {
+        auto index = scn::make_line_index(scn::string_view{});
+        CHECK(index.valid());
+        CHECK(index.size() == 0);
+    }
+    SUBCASE("final line")
+    {
+        auto index = scn::make_line_index(scn::string_view{"a\n\nbc\nd"});
+        REQUIRE(index.size() == 4);
+        CHECK(index.offset(0) == 0);
+        CHECK(index.offset(1) == 2);
+        CHECK(index.offset(2) == 3);
+        CHECK(index.offset(3) == 6);
+
+        index = scn::make_line_index(scn::string_view{"a\nb\n"});
+        CHECK(index.size() == 2);
+    }
+    SUBCASE("offsets")
+    {
+        const auto source = make_source(3000);
+        auto index = scn::make_line_index(scn::make_view(source));
+        REQUIRE(index.size() == 3000);
+
+        std::size_t expected = 0;
+        for (std::size_t i = 0; i < index.size(); ++i) {
+            CHECK(index.offset(i) == expected);
+            expected = source.find('\n', expected) + 1;
+        }
+        CHECK(index.stamp().size == source.size());
+    }
+    SUBCASE("threads")
+    {
+        // large enough for several threads
+        std::string source;
+        while (source.size() < (std::size_t{12} << 20)) {
+            source += make_source(1000);
+        }
+        auto single = scn::make_line_index(scn::make_view(source), 1);
+        auto parallel = scn::make_line_index(scn::make_view(source), 4);
+        REQUIRE(single.size() == parallel.size());
+        REQUIRE(single.size_in_bytes() == parallel.size_in_bytes());
+        CHECK(std::equal(single.data(), single.data() + single.size_in_bytes(),
+                         parallel.data()));
+    }
+}
+
+TEST_CASE("line_index save and load")
+{
+    const auto source = make_source(1500);
+    auto index = scn::make_line_index(scn::make_view(source));
+
+    const auto path = scratch_file("line-index-save.idx");
+    const char* name = path.c_str();
+    CHECK(scn::save_line_index(index, name));
+
+    auto loaded = scn::load_line_index(name);
+    REQUIRE(loaded.valid());
+    REQUIRE(loaded.size() == index.size());
+    for (std::size_t i = 0; i < index.size(); i += 7) {
+        CHECK(loaded.offset(i) == index.offset(i));
+    }
+
+    // replaced, not overwritten: the mapped index stays intact
+    auto other = scn::make_line_index(scn::make_view(make_source(10)));
+    CHECK(scn::save_line_index(other, name));
+    CHECK(scn::load_line_index(name).size() == 10);
+    for (std::size_t i = 0; i < index.size(); i += 7) {
+        CHECK(loaded.offset(i) == index.offset(i));
+    }
+
+    // not an index
+    {
+        auto f = std::fopen(name, "wb");
+        REQUIRE(f);
+        std::fputs("SCNLIDX1 but not really an index", f);
+        std::fclose(f);
+    }
+    CHECK(!scn::load_line_index(name).valid());
+    std::remove(name);
+}
+
+TEST_CASE("line_index corrupt blocks")
+{
+    const auto source = make_source(1500);
+    auto index = scn::make_line_index(scn::make_view(source));
+    REQUIRE(index.size() > 3 * 256);
+
+    const auto path = scratch_file("line-index-corrupt.idx");
+    const char* name = path.c_str();
+
+    // header: 56 bytes, block entries: base, position, width
+    auto corrupt = [&](std::size_t block, std::size_t field, uint64_t val) {
+        std::vector<unsigned char> buf(index.data(),
+                                       index.data() + index.size_in_bytes());
+        std::memcpy(buf.data() + 56 + block * 24 + field * 8, &val, 8);
+        auto f = std::fopen(name, "wb");
+        REQUIRE(f);
+        std::fwrite(buf.data(), 1, buf.size(), f);
+        std::fclose(f);
+        return scn::load_line_index(name);
+    };
+
+    // a middle block, not only the last one
+    CHECK(!corrupt(1, 2, 3).valid());
+    CHECK(!corrupt(1, 1, ~uint64_t{0}).valid());
+    CHECK(!corrupt(1, 0, source.size() + 1).valid());
+
+    // a base in range, with deltas past the end of the source
+    auto loaded = corrupt(2, 0, source.size());
+    REQUIRE(loaded.valid());
+    for (std::size_t i = 2 * 256; i < 3 * 256; ++i) {
+        CHECK(loaded.offset(i) <= source.size());
+    }
+    std::remove(name);
+}
+
+TEST_CASE("indexed_file")
+{
+    const auto path = scratch_file("line-index-indexed.txt");
+    const char* name = path.c_str();
+    {
+        auto f = std::fopen(name, "w");
+        REQUIRE(f);
+        std::fputs("foo 1\nbar 2\nbaz 3", f);
+        std::fclose(f);
+    }
+    const auto sidecar = scn::indexed_file::sidecar_path(name);
+
+    for (int run = 0; run < 2; ++run) {
+        scn::indexed_file file{name};
+        REQUIRE(file.valid());
+        REQUIRE(file.size() == 3);
+        // the second run loads the index saved by the first one
+        CHECK(scn::load_line_index(sidecar.c_str()).valid());
+
+        std::string word;
+        int i{};
+        auto ret = file.scan_record(2, "{} {}", word, i);
+        CHECK(ret);
+        CHECK(word == "baz");
+        CHECK(i == 3);
+
+        ret = file.scan_record(0, "{} {}", word, i);
+        CHECK(ret);
+        CHECK(word == "foo");
+        CHECK(i == 1);
+
+        ret = file.scan_record(3, "{} {}", word, i);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::value_out_of_range);
+    }
+
+    // rewritten with the same size, right away: the index is rebuilt
+    {
+        auto f = std::fopen(name, "w");
+        REQUIRE(f);
+        std::fputs("foo 1\nbar 2\nbaz\n33", f);
+        std::fclose(f);
+    }
+    {
+        scn::indexed_file file{name};
+        REQUIRE(file.valid());
+        REQUIRE(file.size() == 4);
+        CHECK(std::string{file.line(3).data(), file.line(3).size()} == "33");
+    }
+
+    std::remove(sidecar.c_str());
+    std::remove(name);
+}
@@ -0,0 +1,129 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/lines.h>
+
+#include <cstdio>
+
+TEST_CASE_TEMPLATE("lines", CharT, char, wchar_t)
+{
+    using string_type = std::basic_string<CharT>;
+
+    SUBCASE("lf")
+    {
+        auto data = widen<CharT>("first\n\nthird line\r\nlast");
+        std::vector<string_type> result;
+        for (auto line : scn::lines(scn::make_view(data))) {
+            result.emplace_back(line.data(), line.size());
+        }
+        REQUIRE(result.size() == 4);
+        CHECK(result[0] == widen<CharT>("first"));
+        CHECK(result[1].empty());
+        CHECK(result[2] == widen<CharT>("third line\r"));
+        CHECK(result[3] == widen<CharT>("last"));
+    }
+    SUBCASE("crlf")
+    {
+        auto data = widen<CharT>("first\r\nsecond\n");
+        std::vector<string_type> result;
+        for (auto line :
+             scn::lines(scn::make_view(data), scn::line_ending::crlf)) {
+            result.emplace_back(line.data(), line.size());
+        }
+        REQUIRE(result.size() == 2);
+        CHECK(result[0] == widen<CharT>("first"));
+        CHECK(result[1] == widen<CharT>("second"));
+    }
+    SUBCASE("range")
+    {
+        auto data = widen<CharT>("first\nsecond 123");
+        auto l = scn::lines(scn::make_view(data));
+        auto it = l.begin();
+        CHECK(string_type{it->data(), it->size()} == widen<CharT>("first"));
+
+        int i{};
+        string_type s{};
+        auto ret = scn::scan(l.range(), scn::default_tag, s, i);
+        CHECK(ret);
+        CHECK(s == widen<CharT>("second"));
+        CHECK(i == 123);
+    }
+}
+
+static std::string to_string(scn::string_view sv)
+{
+    return {sv.data(), sv.size()};
+}
+
+TEST_CASE("lines skip")
+{
+    std::string data;
+    for (int i = 0; i < 10000; ++i) {
+        data += std::to_string(i);
+        data += '\n';
+    }
+    data += "last";
+
+    auto l = scn::lines(scn::make_view(data));
+    CHECK(l.skip(0) == 0);
+    CHECK(l.skip(5000) == 5000);
+    CHECK(to_string(*l.begin()) == "5000");
+    CHECK(l.skip(2) == 2);
+    CHECK(to_string(*l.begin()) == "5002");
+
+    auto it = l.begin();
+    ++it;
+    CHECK(to_string(*it) == "5003");
+
+    CHECK(l.skip(4996) == 4996);
+    CHECK(to_string(*l.begin()) == "9999");
+    CHECK(l.skip(10) == 2);
+    CHECK(l.begin() == l.end());
+}
+
+TEST_CASE("lines mapped_file")
+{
+    const auto path = scratch_file("lines-mapped.txt");
+    const char* name = path.c_str();
+    {
+        auto f = std::fopen(name, "w");
+        REQUIRE(f);
+        std::fputs("foo 1\nbar 2\n", f);
+        std::fclose(f);
+    }
+
+    {
+        scn::mapped_file file{name};
+        REQUIRE(file.valid());
+
+        std::vector<int> values;
+        for (auto line : scn::lines(file)) {
+            std::string word;
+            int i{};
+            auto ret = scn::scan(line, "{} {}", word, i);
+            CHECK(ret);
+            values.push_back(i);
+        }
+        REQUIRE(values.size() == 2);
+        CHECK(values[0] == 1);
+        CHECK(values[1] == 2);
+    }
+    std::remove(name);
+}
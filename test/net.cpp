@@ -0,0 +1,193 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/net.h>
+
+#include <array>
+#include <cstdio>
+
+using bytes4 = std::array<unsigned char, 4>;
+using bytes6 = std::array<unsigned char, 6>;
+using bytes16 = std::array<unsigned char, 16>;
+
+TEST_CASE("ipv4")
+{
+    scn::ipv4_address a{}, b{};
+    auto ret = scn::scan("192.168.0.1 10.0.0.255:80", "{} {}", a, b);
+    REQUIRE(ret);
+    CHECK(a.bytes == bytes4{{192, 168, 0, 1}});
+    CHECK(a.to_uint() == 0xc0a80001);
+    CHECK(b.bytes == bytes4{{10, 0, 0, 255}});
+    CHECK(ret.range().size() == 3);
+
+    // shorter than 8 characters, and at the end of the input
+    ret = scn::scan("1.2.3.4", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.bytes == bytes4{{1, 2, 3, 4}});
+
+    // a trailing dot is left unread
+    ret = scn::scan("1.2.3.4.", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.bytes == bytes4{{1, 2, 3, 4}});
+    CHECK(ret.range().size() == 1);
+
+    a = scn::ipv4_address{};
+    ret = scn::scan("256.1.1.1", "{}", a);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    CHECK(a.bytes == bytes4{{0, 0, 0, 0}});
+    ret = scn::scan("01.1.1.1", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("1.2.3", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("1.2.3.4444", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("1..2.3", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("ipv6")
+{
+    scn::ipv6_address a{};
+    auto ret = scn::scan("2001:db8::ff00:42:8329", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.bytes == bytes16{{0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0xff,
+                              0x00, 0x00, 0x42, 0x83, 0x29}});
+
+    ret = scn::scan("2001:0DB8:0000:0000:0000:FF00:0042:8329", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.bytes == bytes16{{0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0xff,
+                              0x00, 0x00, 0x42, 0x83, 0x29}});
+
+    ret = scn::scan("::", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.bytes == bytes16{});
+
+    ret = scn::scan("::1 x", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.bytes[15] == 1);
+    CHECK(ret.range().size() == 2);
+
+    ret = scn::scan("fe80::%eth0", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.bytes[0] == 0xfe);
+    CHECK(a.bytes[1] == 0x80);
+    CHECK(ret.range().size() == 5);
+
+    ret = scn::scan("::ffff:192.0.2.128", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.bytes == bytes16{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 192, 0,
+                              2, 128}});
+
+    ret = scn::scan("1:2:3:4:5:6:7::", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.bytes[13] == 7);
+
+    ret = scn::scan("1::2::3", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("1:2:3:4:5:6:7", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("12345::", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("1:2:3:4:5:6:7:8::", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("ip_address and cidr")
+{
+    scn::ip_address a{}, b{};
+    auto ret = scn::scan("10.1.2.3 fd00::1", "{} {}", a, b);
+    REQUIRE(ret);
+    CHECK(!a.is_v6);
+    CHECK(a.v4.bytes == bytes4{{10, 1, 2, 3}});
+    CHECK(b.is_v6);
+    CHECK(b.v6.bytes[0] == 0xfd);
+
+    // a hex group that looks like a number
+    ret = scn::scan("2001::1", "{}", a);
+    REQUIRE(ret);
+    CHECK(a.is_v6);
+
+    scn::ipv4_cidr net4{};
+    scn::ipv6_cidr net6{};
+    ret = scn::scan("10.0.0.0/8 2001:db8::/32", "{} {}", net4, net6);
+    REQUIRE(ret);
+    CHECK(net4.address.bytes == bytes4{{10, 0, 0, 0}});
+    CHECK(net4.prefix_length == 8);
+    CHECK(net6.address.bytes[1] == 0x01);
+    CHECK(net6.prefix_length == 32);
+
+    scn::cidr<scn::ip_address> net{};
+    ret = scn::scan("::/0", "{}", net);
+    REQUIRE(ret);
+    CHECK(net.address.is_v6);
+    CHECK(net.prefix_length == 0);
+
+    ret = scn::scan("10.0.0.0/33", "{}", net4);
+    CHECK(ret.error() == scn::error::value_out_of_range);
+    ret = scn::scan("10.0.0.0", "{}", net4);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("10.0.0.0/x", "{}", net4);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("mac_address")
+{
+    scn::mac_address a{}, b{}, c{};
+    auto ret = scn::scan("00:1a:2B:3c:4D:5e 00-1A-2B-3C-4D-5F 001a.2b3c.4d60",
+                         "{} {} {}", a, b, c);
+    REQUIRE(ret);
+    CHECK(a.bytes == bytes6{{0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e}});
+    CHECK(b.bytes == bytes6{{0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5f}});
+    CHECK(c.bytes == bytes6{{0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x60}});
+
+    ret = scn::scan("00:1a:2b:3c:4d:5", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("00:1a-2b:3c:4d:5e", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+    ret = scn::scan("00:1a:2b:3c:4d:5g", "{}", a);
+    CHECK(ret.error() == scn::error::invalid_scanned_value);
+}
+
+TEST_CASE("net wide and non-contiguous")
+{
+    scn::ipv4_address a{};
+    scn::ipv6_address b{};
+    scn::mac_address m{};
+    auto ret = scn::scan(L"127.0.0.1 ::1 aa:bb:cc:dd:ee:ff", L"{} {} {}", a,
+                         b, m);
+    REQUIRE(ret);
+    CHECK(a.bytes == bytes4{{127, 0, 0, 1}});
+    CHECK(b.bytes[15] == 1);
+    CHECK(m.bytes[5] == 0xff);
+
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("172.16.0.1 -> 10.0.0.0/24\n", f);
+    std::rewind(f);
+    {
+        scn::file file{f};
+        scn::ipv4_cidr net{};
+        auto e = scn::scan(file, "{} -> {}", a, net);
+        REQUIRE(e);
+        CHECK(a.bytes == bytes4{{172, 16, 0, 1}});
+        CHECK(net.prefix_length == 24);
+    }
+    std::fclose(f);
+}
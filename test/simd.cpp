@@ -0,0 +1,233 @@
+// Copyright 2017-2019 Elias Kosunen
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// This file is a part of scnlib:
+//     https://github.com/eliaskosunen/scnlib
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "test.h"
+
+#include <scn/detail/simd.h>
+
+static std::vector<scn::simd_level> supported_levels()
+{
+    std::vector<scn::simd_level> levels;
+    for (auto l : {scn::simd_level::scalar, scn::simd_level::sse42,
+                   scn::simd_level::avx2, scn::simd_level::avx512bw,
+                   scn::simd_level::neon}) {
+        if (scn::is_simd_level_supported(l)) {
+            levels.push_back(l);
+        }
+    }
+    return levels;
+}
+
+// Compares every kernel of every supported level against the scalar ones,
+// for every prefix of every suffix of `str`
+static void check_kernels(const std::string& str)
+{
+    const auto& scalar =
+        scn::detail::get_simd_kernels_for(scn::simd_level::scalar);
+    const auto data = str.data();
+    const auto size = str.size();
+
+    // [a-z0-9_] and [^,\n]
+    scn::detail::byte_set word{}, field{};
+    for (int c = 0; c < 256; ++c) {
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_') {
+            word.insert(static_cast<unsigned char>(c));
+        }
+        if (c != ',' && c != '\n') {
+            field.insert(static_cast<unsigned char>(c));
+        }
+    }
+
+    for (auto l : supported_levels()) {
+        const auto& k = scn::detail::get_simd_kernels_for(l);
+        CHECK(k.level == l);
+        for (size_t b = 0; b <= size; ++b) {
+            for (size_t e = b; e <= size; ++e) {
+                const auto begin = data + b;
+                const auto end = data + e;
+                CHECK(k.find_char(begin, end, '\n') ==
+                      scalar.find_char(begin, end, '\n'));
+                CHECK(k.find_non_space(begin, end) ==
+                      scalar.find_non_space(begin, end));
+                CHECK(k.find_non_digit(begin, end) ==
+                      scalar.find_non_digit(begin, end));
+                CHECK(k.count_char(begin, end, '\n') ==
+                      scalar.count_char(begin, end, '\n'));
+                CHECK(k.find_not_in_set(begin, end, word) ==
+                      scalar.find_not_in_set(begin, end, word));
+                CHECK(k.find_not_in_set(begin, end, field) ==
+                      scalar.find_not_in_set(begin, end, field));
+
+                const char chars[3] = {'"', ',', '\n'};
+                uint64_t masks[3]{}, expected[3]{};
+                k.match_masks(begin, end, chars, masks);
+                scalar.match_masks(begin, end, chars, expected);
+                CHECK(masks[0] == expected[0]);
+                CHECK(masks[1] == expected[1]);
+                CHECK(masks[2] == expected[2]);
+            }
+        }
+    }
+}
+
+TEST_CASE("simd level selection")
+{
+    scn::cpu_features none{};
+    CHECK(scn::detail::select_simd_level(none, nullptr) ==
+          scn::simd_level::scalar);
+    CHECK(scn::detail::select_simd_level(none, "avx2") ==
+          scn::simd_level::scalar);
+
+    scn::cpu_features x86{};
+    x86.sse42 = true;
+    x86.avx2 = true;
+    CHECK(scn::detail::select_simd_level(x86, nullptr) ==
+          scn::simd_level::avx2);
+    CHECK(scn::detail::select_simd_level(x86, "sse4.2") ==
+          scn::simd_level::sse42);
+    CHECK(scn::detail::select_simd_level(x86, "scalar") ==
+          scn::simd_level::scalar);
+    CHECK(scn::detail::select_simd_level(x86, "avx512bw") ==
+          scn::simd_level::avx2);
+    CHECK(scn::detail::select_simd_level(x86, "foo") ==
+          scn::simd_level::avx2);
+
+    CHECK(std::string{scn::simd_level_name(scn::simd_level::sse42)} ==
+          "sse4.2");
+    CHECK(scn::is_simd_level_supported(scn::simd_level::scalar));
+    CHECK(scn::is_simd_level_supported(scn::get_simd_level()));
+}
+
+TEST_CASE("simd kernels")
+{
+    SUBCASE("ascii")
+    {
+        check_kernels(
+            "   \t\n  12345678901234567890123456789012345678901234567890 "
+            "foo\r\n\v\f    0123456789abcdefghijklmnopqrstuvwxyz!\n\n ");
+    }
+    SUBCASE("whitespace and digits")
+    {
+        check_kernels(std::string(70, ' ') + "x" + std::string(70, '7') +
+                      "/" + std::string(40, '\t') + ":");
+    }
+    SUBCASE("fields")
+    {
+        check_kernels(
+            "name_1,some_longer_field_value_0123456789,\xc3\xa4\xc3\xb6,"
+            "Upper Case Words,,\x7f\xff\x80\n\"quoted, \"\"field\"\"\"," +
+            std::string(70, 'x') + "," + std::string(40, '\xfe'));
+    }
+    SUBCASE("utf8")
+    {
+        check_kernels(
+            "abcdefghijklmnopqrstuvwxyz \xc3\xa4\xc3\xb6 "
+            "\xe2\x82\xac \xf0\x9f\x98\x80 abcdefghijklmnopqrstuvwxyz "
+            "0123456789012345678901234567890123456789");
+    }
+    SUBCASE("invalid utf8")
+    {
+        check_kernels(
+            "abcdefghijklmnopqrstuvwxyz0123456789 \xc0\xaf overlong "
+            "abcdefghijklmnopqrstuvwxyz0123456789 \xed\xa0\x80 surrogate "
+            "abcdefghijklmnopqrstuvwxyz0123456789 \xf4\x90\x80\x80 big "
+            "abcdefghijklmnopqrstuvwxyz0123456789 \x80 stray \xe2\x82");
+    }
+}
+
+TEST_CASE("byte_set")
+{
+    scn::detail::byte_set set{};
+    for (int c = 0; c < 256; c += 3) {
+        set.insert(static_cast<unsigned char>(c));
+    }
+    for (int c = 0; c < 256; ++c) {
+        CHECK(set.contains(static_cast<unsigned char>(c)) == (c % 3 == 0));
+    }
+    set.invert();
+    for (int c = 0; c < 256; ++c) {
+        CHECK(set.contains(static_cast<unsigned char>(c)) == (c % 3 != 0));
+    }
+}
+
+TEST_CASE("prefix_xor")
+{
+    CHECK(scn::detail::prefix_xor(0) == 0);
+    // a"b"c: the opening quote and b
+    CHECK(scn::detail::prefix_xor(0x0a) == 0x06);
+    // a"b""c": a doubled quote closes and reopens
+    CHECK(scn::detail::prefix_xor(0x5a) == 0x36);
+    CHECK(scn::detail::prefix_xor(1) == ~uint64_t{0});
+    CHECK(scn::detail::prefix_xor(uint64_t{1} << 63) == uint64_t{1} << 63);
+}
+
+TEST_CASE("swar digits")
+{
+    using swar = scn::detail::swar;
+    CHECK(swar::is_8_digits(swar::load8("01234567")));
+    CHECK(!swar::is_8_digits(swar::load8("0123456:")));
+    CHECK(!swar::is_8_digits(swar::load8("/1234567")));
+    CHECK(!swar::is_8_digits(swar::load8("0123\xb0" "567")));
+    CHECK(swar::parse_8_digits(swar::load8("01234567")) == 1234567);
+    CHECK(swar::parse_8_digits(swar::load8("99999999")) == 99999999);
+
+    const auto pairs = swar::digit_pairs(swar::load8("20240917"));
+    CHECK(swar::byte(pairs, 0) == 20);
+    CHECK(swar::byte(pairs, 2) == 24);
+    CHECK(swar::byte(pairs, 5) == 91);
+}
+
+TEST_CASE("swar masks")
+{
+    using swar = scn::detail::swar;
+    const auto w = swar::load8("1.2A:f/\xff");
+    CHECK(swar::movemask(swar::digit_mask(w)) == 0x05);
+    CHECK(swar::movemask(swar::hex_digit_mask(w)) == 0x2d);
+    CHECK(swar::movemask(swar::in_range(w, '.', '.')) == 0x02);
+    CHECK(swar::load("12", 2) == swar::load8("12\0\0\0\0\0\0"));
+
+    const auto n = swar::hex_nibbles(swar::load8("09afAF00"));
+    CHECK(swar::byte(n, 0) == 0);
+    CHECK(swar::byte(n, 1) == 9);
+    CHECK(swar::byte(n, 2) == 10);
+    CHECK(swar::byte(n, 3) == 15);
+    CHECK(swar::byte(n, 4) == 10);
+    CHECK(swar::byte(n, 5) == 15);
+
+    CHECK(swar::parse_8_hex_digits(swar::load8("09afAF00")) == 0x09afaf00);
+    CHECK(swar::parse_8_hex_digits(swar::load8("12345678")) == 0x12345678);
+    CHECK(swar::parse_8_hex_digits(swar::load8("ffffffff")) == 0xffffffff);
+    CHECK(swar::is_8_hex_digits(swar::load8("09afAF00")));
+    CHECK(!swar::is_8_hex_digits(swar::load8("09afAG00")));
+
+    CHECK(swar::parse_8_octal_digits(swar::load8("01234567")) == 01234567);
+    CHECK(swar::parse_8_octal_digits(swar::load8("77777777")) == 077777777);
+    CHECK(swar::is_8_octal_digits(swar::load8("01234567")));
+    CHECK(!swar::is_8_octal_digits(swar::load8("01234568")));
+}
+
+TEST_CASE("simd whitespace skipping")
+{
+    std::string source = std::string(100, ' ') + "123" +
+                         std::string(50, '\n') + "456";
+    int a{}, b{};
+    auto ret = scn::scan(scn::make_view(source), "{} {}", a, b);
+    CHECK(ret);
+    CHECK(a == 123);
+    CHECK(b == 456);
+}
@@ -67,6 +67,169 @@ TEST_CASE_TEMPLATE("getline", CharT, char, wchar_t)
         CHECK(s == widen<CharT>("Second line with spaces"));
         CHECK(ret);
     }
+    SUBCASE("long lines")
+    {
+        string_type line(100, widen<CharT>("a")[0]);
+        string_type source = line + widen<CharT>("\n") + line + line;
+
+        string_type s{};
+        auto ret = scn::getline(scn::make_view(source), s);
+        CHECK(ret);
+        CHECK(s == line);
+
+        scn::basic_string_view<CharT> sv{};
+        auto ret2 = scn::getline(ret.range(), sv);
+        CHECK(ret2);
+        CHECK(string_type{sv.data(), sv.size()} == line + line);
+        CHECK(ret2.range().size() == 0);
+
+        ret2 = scn::getline(ret2.range(), sv);
+        CHECK(!ret2);
+        CHECK(ret2.error() == scn::error::end_of_range);
+    }
+}
+
+TEST_CASE("getline file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("first\nsecond", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        std::string s{};
+        auto ret = scn::getline(file, s);
+        CHECK(ret);
+        CHECK(s == "first");
+        ret = scn::getline(file, s);
+        CHECK(ret);
+        CHECK(s == "second");
+    }
+    std::fclose(f);
+}
+
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator(int& c) : count(&c) {}
+    template <typename U>
+    counting_allocator(const counting_allocator<U>& o) : count(o.count)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        ++*count;
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, std::size_t n)
+    {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    bool operator==(const counting_allocator& o) const
+    {
+        return count == o.count;
+    }
+    bool operator!=(const counting_allocator& o) const
+    {
+        return count != o.count;
+    }
+
+    int* count;
+};
+
+TEST_CASE("string with allocator")
+{
+    using string_type =
+        std::basic_string<char, std::char_traits<char>,
+                          counting_allocator<char>>;
+    int count = 0;
+    string_type s{counting_allocator<char>{count}};
+
+    auto ret = scn::scan("a_word_too_long_for_small_string_optimization",
+                         "{}", s);
+    CHECK(ret);
+    CHECK(s == "a_word_too_long_for_small_string_optimization");
+    CHECK(count != 0);
+
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("another_word_too_long_for_small_string_optimization", f);
+    std::rewind(f);
+    {
+        scn::file file{f};
+        const auto before = count;
+        auto fret = scn::scan(file, "{}", s);
+        CHECK(fret);
+        CHECK(s == "another_word_too_long_for_small_string_optimization");
+        CHECK(count != before);
+    }
+    std::fclose(f);
+}
+
+#if SCN_HAS_INCLUDE(<memory_resource>) && __cplusplus >= SCN_STD_17
+#include <memory_resource>
+#endif
+#if defined(__cpp_lib_memory_resource)
+TEST_CASE("pmr string")
+{
+    char buf[256];
+    std::pmr::monotonic_buffer_resource res{buf, sizeof(buf),
+                                            std::pmr::null_memory_resource()};
+    std::pmr::string s{&res};
+    auto ret = scn::scan("a_word_too_long_for_small_string_optimization",
+                         "{}", s);
+    CHECK(ret);
+    CHECK(s == "a_word_too_long_for_small_string_optimization");
+    CHECK(s.get_allocator().resource() == &res);
+}
+#endif
+
+TEST_CASE("scan file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("12 34 word", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        int a{}, b{};
+        std::string s{};
+        auto ret = scn::scan(file, "{} {} {}", a, b, s);
+        CHECK(ret);
+        CHECK(a == 12);
+        CHECK(b == 34);
+        CHECK(s == "word");
+    }
+    std::fclose(f);
+}
+
+TEST_CASE("scan file with putback")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("123abc 0x1fz", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        int i{};
+        std::string s{};
+        // the characters after the integer are read, and put back
+        auto ret = scn::scan(file, "{}{}", i, s);
+        CHECK(ret);
+        CHECK(i == 123);
+        CHECK(s == "abc");
+        ret = scn::scan(file, "{}{}", i, s);
+        CHECK(ret);
+        CHECK(i == 0x1f);
+        CHECK(s == "z");
+    }
+    std::fclose(f);
 }
 
 TEST_CASE_TEMPLATE("ignore", CharT, char, wchar_t)
@@ -90,6 +253,17 @@ TEST_CASE_TEMPLATE("ignore", CharT, char, wchar_t)
             CHECK(ret);
         }
     }
+    SUBCASE("ignore_until_n")
+    {
+        auto ret = scn::ignore_until_n(scn::make_view(data), 3, 0x0a);
+        CHECK(ret);
+        CHECK(ret.range().size() == 8);
+
+        ret = scn::ignore_until_n(ret.range(), 8, 0x0a);
+        CHECK(ret);
+        CHECK(ret.range().size() == 6);
+        CHECK(*ret.range().begin() == widen<CharT>("\n")[0]);
+    }
 }
 
 TEST_CASE("string scanf")
@@ -100,3 +274,206 @@ TEST_CASE("string scanf")
     CHECK(ret);
     CHECK(str == "str");
 }
+
+TEST_CASE_TEMPLATE("scanset", CharT, char, wchar_t)
+{
+    using string_type = std::basic_string<CharT>;
+
+    SUBCASE("ranges")
+    {
+        string_type s{};
+        auto e = do_scan<CharT>("abc_12-x", "{:[a-zA-Z0-9_]}", s);
+        CHECK(e);
+        CHECK(s == widen<CharT>("abc_12"));
+    }
+    SUBCASE("inverted")
+    {
+        string_type a{}, b{};
+        auto e = do_scan<CharT>("first field,second", "{:[^,]},{}", a, b);
+        CHECK(e);
+        CHECK(a == widen<CharT>("first field"));
+        CHECK(b == widen<CharT>("second"));
+    }
+    SUBCASE("literal ] and -")
+    {
+        string_type s{};
+        auto e = do_scan<CharT>("a]-b", "{:[]a-]}", s);
+        CHECK(e);
+        CHECK(s == widen<CharT>("a]-"));
+    }
+    SUBCASE("string_view")
+    {
+        scn::basic_string_view<CharT> s{};
+        const auto source = widen<CharT>(std::string(100, 'x') + "!yz");
+        auto e = scn::scan(scn::make_view(source), widen<CharT>("{:[^!]}!").c_str(), s);
+        CHECK(e);
+        CHECK(string_type{s.data(), s.size()} ==
+              widen<CharT>(std::string(100, 'x')));
+        CHECK(e.range().size() == 2);
+    }
+    SUBCASE("no match")
+    {
+        string_type s{};
+        auto e = do_scan<CharT>("123", "{:[a-z]}", s);
+        CHECK(!e);
+        CHECK(e.error() == scn::error::invalid_scanned_value);
+        CHECK(s.empty());
+    }
+    SUBCASE("invalid format")
+    {
+        string_type s{};
+        auto e = do_scan<CharT>("abc", "{:[a-z}", s);
+        CHECK(!e);
+        CHECK(e.error() == scn::error::invalid_format_string);
+
+        e = do_scan<CharT>("abc", "{:[z-a]}", s);
+        CHECK(!e);
+        CHECK(e.error() == scn::error::invalid_format_string);
+    }
+}
+
+TEST_CASE("scanset wide characters")
+{
+    std::wstring s{};
+    const std::wstring cjk{L"\u4e2d\u6587abc"};
+    auto e = scn::scan(scn::make_view(cjk), L"{:[\u4e00-\u9fff]}", s);
+    CHECK(e);
+    CHECK(s == L"\u4e2d\u6587");
+
+    const std::wstring mixed{L"\u4e2dx\u00e9,y"};
+    auto e2 = scn::scan(scn::make_view(mixed), L"{:[^,]}", s);
+    CHECK(e2);
+    CHECK(s == L"\u4e2dx\u00e9");
+}
+
+TEST_CASE("scanset file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("key one=value;rest", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        std::string k{}, v{};
+        auto ret = scn::scan(file, "{:[^=]}={:[^;]}", k, v);
+        CHECK(ret);
+        CHECK(k == "key one");
+        CHECK(v == "value");
+    }
+    std::fclose(f);
+}
+
+TEST_CASE("scanset scanf")
+{
+    std::string a{}, b{};
+
+    auto ret = do_scanf<char>("abc123 def", "%[a-z]%[0-9]", a, b);
+    CHECK(ret);
+    CHECK(a == "abc");
+    CHECK(b == "123");
+}
+
+TEST_CASE_TEMPLATE("quoted string", CharT, char, wchar_t)
+{
+    using string_type = std::basic_string<CharT>;
+
+    SUBCASE("doubled quotes")
+    {
+        string_type a{}, b{};
+        auto e = do_scan<CharT>("\"hello world\" \"say \"\"hi\"\"\"",
+                                "{:q} {:q}", a, b);
+        CHECK(e);
+        CHECK(a == widen<CharT>("hello world"));
+        CHECK(b == widen<CharT>("say \"hi\""));
+    }
+    SUBCASE("backslash escapes")
+    {
+        string_type a{};
+        auto e = do_scan<CharT>("\"a\\\"b\\\\c\\n\\t\\x41\"", "{:Q}", a);
+        CHECK(e);
+        CHECK(a == widen<CharT>("a\"b\\c\n\tA"));
+    }
+    SUBCASE("unquoted")
+    {
+        string_type a{}, b{};
+        auto e = do_scan<CharT>("plain \"\"", "{:q} {:q}", a, b);
+        CHECK(e);
+        CHECK(a == widen<CharT>("plain"));
+        CHECK(b.empty());
+    }
+    SUBCASE("string_view")
+    {
+        // The view points into the source
+        const auto source = widen<CharT>("\"zero copy\"");
+        scn::basic_string_view<CharT> v{};
+        auto e =
+            scn::scan(scn::make_view(source), widen<CharT>("{:Q}").c_str(), v);
+        CHECK(e);
+        CHECK(string_type{v.data(), v.size()} == widen<CharT>("zero copy"));
+        CHECK(v.data() == source.data() + 1);
+
+        e = do_scan<CharT>("\"esc\\\"aped\"", "{:Q}", v);
+        CHECK(!e);
+        CHECK(e.error() == scn::error::invalid_scanned_value);
+    }
+    SUBCASE("errors")
+    {
+        string_type a{};
+        auto e = do_scan<CharT>("\"unterminated", "{:q}", a);
+        CHECK(!e);
+        CHECK(e.error() == scn::error::invalid_scanned_value);
+
+        e = do_scan<CharT>("\"bad \\q escape\"", "{:Q}", a);
+        CHECK(!e);
+        CHECK(e.error() == scn::error::invalid_scanned_value);
+
+        e = do_scan<CharT>("\"lone \\udc00\"", "{:Q}", a);
+        CHECK(!e);
+        CHECK(e.error() == scn::error::invalid_scanned_value);
+    }
+}
+
+TEST_CASE("quoted string unicode escapes")
+{
+    std::string s{};
+    auto e = scn::scan("\"\\u00e9\\u4e2d\\ud83d\\ude00\"", "{:Q}", s);
+    CHECK(e);
+    CHECK(s == "\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80");
+
+    std::wstring ws{};
+    auto we = scn::scan(L"\"\\u00e9\\ud83d\\ude00\"", L"{:Q}", ws);
+    CHECK(we);
+    CHECK(ws.size() == (sizeof(wchar_t) == 2 ? 3u : 2u));
+    CHECK(ws[0] == L'\u00e9');
+}
+
+TEST_CASE("quoted string file")
+{
+    auto f = std::tmpfile();
+    REQUIRE(f);
+    std::fputs("\"one \"\"two\"\"\" \"\\u00e9\\n\" bare", f);
+    std::rewind(f);
+
+    {
+        scn::file file{f};
+        std::string a{}, b{}, c{};
+        auto ret = scn::scan(file, "{:q} {:Q} {:q}", a, b, c);
+        CHECK(ret);
+        CHECK(a == "one \"two\"");
+        CHECK(b == "\xc3\xa9\n");
+        CHECK(c == "bare");
+    }
+    std::fclose(f);
+}
+
+TEST_CASE("quoted string with delimiters")
+{
+    std::string a{}, b{}, c{};
+    auto ret = scn::scan("\"x, y\",,\"z\"\"\"", scn::with_delimiters(","),
+                         "{:q},{:q},{:q}", a, b, c);
+    CHECK(ret);
+    CHECK(a == "x, y");
+    CHECK(b.empty());
+    CHECK(c == "z\"");
+}
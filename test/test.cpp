@@ -57,6 +57,58 @@ TEST_CASE("general")
     CHECK(ret.error() == scn::error::end_of_range);
 }
 
+TEST_CASE("scan_static")
+{
+    std::string data{"test {} 42 3.14 foobar true"};
+
+    int i{0};
+    double d{};
+    std::string s(6, '\0');
+    auto span = scn::make_span(&s[0], &s[0] + s.size());
+    bool b{};
+    auto ret = scn::scan_static(scn::make_view(data),
+                                "test {{}} {} {} {} {:a}", i, d, span, b);
+
+    CHECK(i == 42);
+    CHECK(d == doctest::Approx(3.14));
+    CHECK(s == "foobar");
+    CHECK(b);
+    CHECK(ret);
+
+    ret = scn::scan_static(ret.range(), "{}", i);
+    CHECK(!ret);
+    CHECK(ret.error() == scn::error::end_of_range);
+
+    SUBCASE("default")
+    {
+        std::string str;
+        ret = scn::scan_static(scn::make_view(data), scn::default_tag, str,
+                               str, i);
+        CHECK(ret);
+        CHECK(str == "{}");
+        CHECK(i == 42);
+    }
+    SUBCASE("arg id")
+    {
+        std::string str;
+        ret = scn::scan_static(scn::make_view(data), "{1} {1} {0}", i, str);
+        CHECK(ret);
+        CHECK(str == "{}");
+        CHECK(i == 42);
+
+        ret = scn::scan_static(scn::make_view(data), "{2}", i, str);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::invalid_format_string);
+    }
+    SUBCASE("error")
+    {
+        ret = scn::scan_static(scn::make_view(data), "{}", i);
+        CHECK(!ret);
+        CHECK(ret.error() == scn::error::invalid_scanned_value);
+        CHECK(ret.range().size() == data.size());
+    }
+}
+
 TEST_CASE("range wrapping")
 {
     SUBCASE("rvalue view")
@@ -41,6 +41,17 @@ inline std::basic_string<wchar_t> widen<wchar_t>(std::string str)
     return std::wstring(str.begin(), str.end());
 }
 
+#ifndef SCN_TEST_SCRATCH_DIR
+#define SCN_TEST_SCRATCH_DIR "."
+#endif
+
+// Path of a file named `name` in the build directory, for tests that need
+// a file with a name
+inline std::string scratch_file(const char* name)
+{
+    return std::string{SCN_TEST_SCRATCH_DIR "/"} + name;
+}
+
 template <typename CharT, typename Input, typename Fmt, typename... T>
 auto do_scan(Input i, Fmt f, T&... a) -> decltype(
     scn::scan(scn::make_view(widen<CharT>(i)), widen<CharT>(f).c_str(), a...))